@@ -0,0 +1,212 @@
+#include "AllocationProfiler.hpp"
+#include "TsvWriter.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+AllocationProfiler::AllocationProfiler(const std::string &sites_filepath,
+                                       const std::string &size_classes_filepath,
+                                       const std::string &epochs_filepath,
+                                       const std::string &folded_filepath,
+                                       long large_threshold, int top_sites,
+                                       bool verbose)
+    : sites_filepath(sites_filepath),
+      size_classes_filepath(size_classes_filepath),
+      epochs_filepath(epochs_filepath), folded_filepath(folded_filepath),
+      large_threshold(large_threshold), top_sites(max(top_sites, 0)),
+      verbose(verbose) {}
+
+void AllocationProfiler::begin() {
+    tree = CallingContextTree<allocation_node_t>();
+    sites.clear();
+    site_ids.clear();
+    last_node = -1;
+    last_srcref = nullptr;
+    last_site = -1;
+    epoch_sites.clear();
+    epoch_bytes = 0;
+    epochs.clear();
+}
+
+void AllocationProfiler::end() {
+    end_epoch(false);
+
+    if (!sites_filepath.empty())
+        write_sites();
+    if (!size_classes_filepath.empty())
+        write_size_classes();
+    if (!epochs_filepath.empty())
+        write_epochs();
+    if (!folded_filepath.empty())
+        write_folded();
+
+    if (verbose) {
+        uint64_t bytes = 0;
+        for (auto const &site : sites)
+            bytes += site.bytes;
+        cerr << "Allocations: " << bytes << " bytes from " << sites.size()
+             << " sites in " << tree.size() << " calling contexts, "
+             << epochs.size() - 1 << " collections\n";
+    }
+}
+
+void AllocationProfiler::enter(SEXP call, SEXP op, SEXP rho) {
+    tree.enter(call, op, rho);
+}
+
+void AllocationProfiler::exit() { tree.exit(); }
+
+void AllocationProfiler::unwind(SEXP rho) {
+    tree.unwind(rho, [](int node) {});
+}
+
+void AllocationProfiler::allocate(int sexptype, long length, long bytes,
+                                  SEXP srcref) {
+    int node = tree.get_current();
+    if (node != last_node || srcref != last_srcref) {
+        last_site = get_site(node, srcref);
+        last_node = node;
+        last_srcref = srcref;
+    }
+
+    allocation_node_t &data = tree.get_node(node).data;
+    data.count++;
+    data.bytes += bytes;
+
+    allocation_site_t &site = sites[last_site];
+    site.count++;
+    site.bytes += bytes;
+
+    if (bytes >= large_threshold) {
+        site.large_count++;
+        site.large_bytes += bytes;
+        size_t size_class = 63 - __builtin_clzll(bytes);
+        if (site.size_classes.size() <= size_class)
+            site.size_classes.resize(size_class + 1);
+        site.size_classes[size_class]++;
+    }
+
+    if (site.epoch_count++ == 0)
+        epoch_sites.push_back(last_site);
+    site.epoch_bytes += bytes;
+    epoch_bytes += bytes;
+}
+
+void AllocationProfiler::collect() {
+    end_epoch(true);
+    // The collection may free a srcref and reuse its address.
+    last_node = -1;
+    last_srcref = nullptr;
+}
+
+int AllocationProfiler::get_site(int node, SEXP srcref) {
+    dyntrace_srcref_t location;
+    dyntrace_get_srcref(srcref, &location);
+    site_key_t key{node, location.filename ? location.filename : "",
+                   location.line, location.column};
+
+    auto iterator = site_ids.find(key);
+    if (iterator != site_ids.end())
+        return iterator->second;
+
+    int id = sites.size();
+    sites.emplace_back();
+    allocation_site_t &site = sites.back();
+    site.node = node;
+    site.srcfile = key.filename;
+    site.line = key.line;
+    site.column = key.column;
+    site_ids.emplace(key, id);
+    return id;
+}
+
+void AllocationProfiler::end_epoch(bool ended_by_gc) {
+    allocation_epoch_t epoch;
+    epoch.epoch = epochs.size();
+    epoch.ended_by_gc = ended_by_gc;
+    epoch.bytes = epoch_bytes;
+
+    size_t count = min(top_sites, epoch_sites.size());
+    partial_sort(epoch_sites.begin(), epoch_sites.begin() + count,
+                 epoch_sites.end(), [this](int a, int b) {
+                     return sites[a].epoch_bytes > sites[b].epoch_bytes;
+                 });
+    for (size_t i = 0; i < count; ++i) {
+        const allocation_site_t &site = sites[epoch_sites[i]];
+        epoch.top_sites.push_back(epoch_sites[i]);
+        epoch.top_counts.push_back(site.epoch_count);
+        epoch.top_bytes.push_back(site.epoch_bytes);
+    }
+    epochs.push_back(std::move(epoch));
+
+    for (int site : epoch_sites) {
+        sites[site].epoch_count = 0;
+        sites[site].epoch_bytes = 0;
+    }
+    epoch_sites.clear();
+    epoch_bytes = 0;
+}
+
+void AllocationProfiler::write_sites() const {
+    TsvWriter file(sites_filepath,
+                   {"site", "function", "context", "srcfile", "line", "column",
+                    "count", "bytes", "large_count", "large_bytes"});
+    if (!file.is_open())
+        return;
+
+    vector<int> order(sites.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    sort(order.begin(), order.end(),
+         [this](int a, int b) { return sites[a].bytes > sites[b].bytes; });
+
+    for (int id : order) {
+        const allocation_site_t &site = sites[id];
+        file.row(id, tree.get_node(site.node).name, tree.get_path(site.node),
+                 site.srcfile, site.line, site.column, site.count, site.bytes,
+                 site.large_count, site.large_bytes);
+    }
+}
+
+void AllocationProfiler::write_size_classes() const {
+    TsvWriter file(size_classes_filepath, {"site", "min_bytes", "count"});
+    if (!file.is_open())
+        return;
+
+    for (size_t id = 0; id < sites.size(); ++id) {
+        const vector<uint64_t> &size_classes = sites[id].size_classes;
+        for (size_t k = 0; k < size_classes.size(); ++k)
+            if (size_classes[k] > 0)
+                file.row(id, uint64_t(1) << k, size_classes[k]);
+    }
+}
+
+void AllocationProfiler::write_epochs() const {
+    TsvWriter file(epochs_filepath, {"epoch", "ended_by", "epoch_bytes", "rank",
+                                     "site", "count", "bytes"});
+    if (!file.is_open())
+        return;
+
+    for (auto const &epoch : epochs)
+        for (size_t rank = 0; rank < epoch.top_sites.size(); ++rank)
+            file.row(epoch.epoch, epoch.ended_by_gc ? "gc" : "end",
+                     epoch.bytes, rank + 1, epoch.top_sites[rank],
+                     epoch.top_counts[rank], epoch.top_bytes[rank]);
+}
+
+void AllocationProfiler::write_folded() const {
+    ofstream file(folded_filepath);
+    if (!file) {
+        cerr << "Error: could not open " << folded_filepath << "\n";
+        return;
+    }
+
+    for (size_t node = 0; node < tree.size(); ++node) {
+        uint64_t bytes = tree.get_node(node).data.bytes;
+        if (bytes > 0)
+            file << (node == 0 ? tree.get_node(0).name : tree.get_path(node))
+                 << " " << bytes << "\n";
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef __ALLOCATION_PROFILER_HPP__
+#define __ALLOCATION_PROFILER_HPP__
+
+#include "CallingContextTree.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct allocation_node_t {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+// Allocations made in one calling context while evaluating one source
+// reference. Allocations outside of any srcref (byte-compiled code, code
+// without srcrefs) have line 0 and are attributed to the context only.
+struct allocation_site_t {
+    int node;
+    std::string srcfile;
+    int line;
+    int column;
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    uint64_t large_count = 0;
+    uint64_t large_bytes = 0;
+    // Large allocations by size class, size_classes[k] counts the
+    // allocations of [2^k, 2^(k+1)) bytes.
+    std::vector<uint64_t> size_classes;
+    // Allocations since the last collection.
+    uint64_t epoch_count = 0;
+    uint64_t epoch_bytes = 0;
+};
+
+// Sites that allocated the most bytes between two collections.
+struct allocation_epoch_t {
+    int epoch;
+    bool ended_by_gc;
+    uint64_t bytes;
+    std::vector<int> top_sites;
+    std::vector<uint64_t> top_counts;
+    std::vector<uint64_t> top_bytes;
+};
+
+// Attributes the vector allocations reported by probe_vector_alloc to the
+// calling context and the source reference that made them. Everything is
+// kept in memory and written when the trace ends.
+class AllocationProfiler {
+  public:
+    AllocationProfiler(const std::string &sites_filepath,
+                       const std::string &size_classes_filepath,
+                       const std::string &epochs_filepath,
+                       const std::string &folded_filepath,
+                       long large_threshold, int top_sites, bool verbose);
+
+    void begin();
+    void end();
+    void enter(SEXP call, SEXP op, SEXP rho);
+    void exit();
+    void unwind(SEXP rho);
+    void allocate(int sexptype, long length, long bytes, SEXP srcref);
+    void collect();
+
+  private:
+    // Keyed by the file name rather than the srcfile environment, whose
+    // address is reused once the collector frees it.
+    struct site_key_t {
+        int node;
+        std::string filename;
+        int line;
+        int column;
+
+        bool operator==(const site_key_t &other) const {
+            return node == other.node && filename == other.filename &&
+                   line == other.line && column == other.column;
+        }
+    };
+
+    struct site_key_hash_t {
+        size_t operator()(const site_key_t &key) const {
+            size_t hash = std::hash<std::string>()(key.filename);
+            hash = hash * 31 + key.node;
+            hash = hash * 31 + key.line;
+            return hash * 31 + key.column;
+        }
+    };
+
+    int get_site(int node, SEXP srcref);
+    void end_epoch(bool ended_by_gc);
+    void write_sites() const;
+    void write_size_classes() const;
+    void write_epochs() const;
+    void write_folded() const;
+
+    std::string sites_filepath;
+    std::string size_classes_filepath;
+    std::string epochs_filepath;
+    std::string folded_filepath;
+    long large_threshold;
+    size_t top_sites;
+    bool verbose;
+
+    CallingContextTree<allocation_node_t> tree;
+    std::vector<allocation_site_t> sites;
+    std::unordered_map<site_key_t, int, site_key_hash_t> site_ids;
+    // Consecutive allocations mostly come from the same site.
+    int last_node = -1;
+    SEXP last_srcref = nullptr;
+    int last_site = -1;
+
+    std::vector<int> epoch_sites;
+    uint64_t epoch_bytes = 0;
+    std::vector<allocation_epoch_t> epochs;
+};
+
+#endif /* __ALLOCATION_PROFILER_HPP__ */
@@ -0,0 +1,19 @@
+#include "probes.hpp"
+
+RDT_PROFILER_ACCESSOR(AllocationProfiler)
+
+RDT_FORWARD_BEGIN_END_PROBES(profiler)
+
+RDT_FORWARD_CLOSURE_PROBES(profiler)
+
+RDT_FORWARD_BUILTIN_PROBES(profiler)
+
+// Runs inside allocVector, must not allocate on the R heap.
+void vector_alloc(dyntrace_context_t *context, int sexptype, long length,
+                  long bytes, SEXP srcref) {
+    profiler(context).allocate(sexptype, length, bytes, srcref);
+}
+
+void gc_entry(dyntrace_context_t *context, R_size_t size_needed) {
+    profiler(context).collect();
+}
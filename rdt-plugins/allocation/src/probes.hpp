@@ -0,0 +1,18 @@
+#ifndef __PROBES_HPP__
+#define __PROBES_HPP__
+
+#include "AllocationProfiler.hpp"
+#include "probe_forwarding.hpp"
+
+RDT_DECLARE_BEGIN_END_PROBES();
+
+RDT_DECLARE_CLOSURE_PROBES();
+
+RDT_DECLARE_BUILTIN_PROBES();
+
+void vector_alloc(dyntrace_context_t *context, int sexptype, long length,
+                  long bytes, SEXP srcref);
+
+void gc_entry(dyntrace_context_t *context, R_size_t size_needed);
+
+#endif /* __PROBES_HPP__ */
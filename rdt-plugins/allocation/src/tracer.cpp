@@ -0,0 +1,60 @@
+#include "tracer.hpp"
+
+DYNTRACE_PLUGIN_ABI;
+
+static AllocationProfiler *create_allocation_profiler(SEXP options) {
+    return new AllocationProfiler(
+        sexp_to_string(get_named_list_element(options, "sites_filepath"),
+                       "allocation_sites.tsv"),
+        sexp_to_string(
+            get_named_list_element(options, "size_classes_filepath"),
+            "allocation_size_classes.tsv"),
+        sexp_to_string(get_named_list_element(options, "epochs_filepath"),
+                       "allocation_epochs.tsv"),
+        sexp_to_string(get_named_list_element(options, "folded_filepath"),
+                       "allocation.folded"),
+        // bytes including the vector header
+        sexp_to_int(get_named_list_element(options, "large_threshold"), 1024),
+        sexp_to_int(get_named_list_element(options, "top_sites"), 10),
+        sexp_to_bool(get_named_list_element(options, "verbose"), false));
+}
+
+SEXP create_dyntracer(SEXP options) {
+
+    // calloc initializes the memory to zero. This ensures that probes not
+    // attached will point to NULL.
+    dyntracer_t *dyntracer = (dyntracer_t *)calloc(1, sizeof(dyntracer_t));
+
+    dyntracer->probe_begin = begin;
+    dyntracer->probe_end = end;
+    dyntracer->probe_function_entry = function_entry;
+    dyntracer->probe_function_exit = function_exit;
+    // Without the builtin and special probes, allocations made by builtins
+    // are attributed to the calling closure.
+    if (sexp_to_bool(get_named_list_element(options, "include_builtins"),
+                     true)) {
+        dyntracer->probe_builtin_entry = builtin_entry;
+        dyntracer->probe_builtin_exit = builtin_exit;
+        dyntracer->probe_specialsxp_entry = builtin_entry;
+        dyntracer->probe_specialsxp_exit = builtin_exit;
+    }
+    dyntracer->probe_jump_ctxt = jump_ctxt;
+    dyntracer->probe_vector_alloc = vector_alloc;
+    dyntracer->small_vector_alloc = 1;
+    dyntracer->probe_gc_entry = gc_entry;
+    // The probes run inside allocVector and only touch C++ containers.
+    dyntracer->non_allocating = 1;
+    dyntracer->context = create_allocation_profiler(options);
+
+    return dyntracer_to_sexp(dyntracer, "dyntracer.allocation");
+}
+
+static void destroy_allocation_dyntracer(dyntracer_t *dyntracer) {
+    delete static_cast<AllocationProfiler *>(dyntracer->context);
+    free(dyntracer);
+}
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp,
+                                  destroy_allocation_dyntracer);
+}
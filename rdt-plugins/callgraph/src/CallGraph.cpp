@@ -0,0 +1,209 @@
+#include "CallGraph.hpp"
+#include "TsvWriter.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+#include <unordered_map>
+
+using namespace std;
+
+folded_metric string_to_folded_metric(const std::string &metric) {
+    if (metric == "calls")
+        return folded_metric::CALLS;
+    return folded_metric::TIME;
+}
+
+CallGraph::CallGraph(const std::string &folded_filepath,
+                     const std::string &summary_filepath,
+                     const std::string &namespaces_filepath,
+                     folded_metric metric, bool verbose)
+    : folded_filepath(folded_filepath), summary_filepath(summary_filepath),
+      namespaces_filepath(namespaces_filepath), metric(metric),
+      verbose(verbose), begin_time(0), end_time(0) {}
+
+void CallGraph::begin() {
+    tree = CallingContextTree<call_graph_node_t>();
+    timings.clear();
+    if (!namespaces_filepath.empty())
+        namespaces.begin();
+    begin_time = timestamp();
+}
+
+void CallGraph::end(const dyntracing_context_t &dyntracing_context) {
+    end_time = timestamp();
+
+    // Calls still active when the traced expression returns, e.g. because
+    // of an error.
+    int node;
+    while ((node = tree.exit()) != -1)
+        leave(node, end_time);
+
+    call_graph_node_t &root = tree.get_node(0).data;
+    root.calls = 1;
+    root.inclusive_time = end_time - begin_time;
+    root.exclusive_time = root.inclusive_time;
+    for (auto const &child : tree.get_node(0).children)
+        root.exclusive_time -= tree.get_node(child.second).data.inclusive_time;
+
+    if (!folded_filepath.empty())
+        write_folded();
+    if (!summary_filepath.empty())
+        write_summary();
+    if (!namespaces_filepath.empty()) {
+        namespaces.end();
+        namespaces.write(namespaces_filepath);
+    }
+
+    if (verbose && !children.empty()) {
+        cerr << "Call graph: " << children.size()
+             << " forked children traced to " << folded_filepath << ".<pid>:";
+        for (pid_t child : children)
+            cerr << " " << child;
+        cerr << "\n";
+    }
+
+    if (verbose)
+        cerr << "Call graph: " << tree.size() << " calling contexts, "
+             << root.inclusive_time / 1e9 << "s traced\n"
+             << "Call graph: "
+             << double(dyntracing_context.program_time) / CLOCKS_PER_SEC
+             << "s of program time, "
+             << double(dyntracing_context.probe_overhead) / CLOCKS_PER_SEC
+             << "s of probe overhead\n";
+}
+
+void CallGraph::enter(SEXP call, SEXP op, SEXP rho) {
+    int node = tree.enter(call, op, rho);
+    tree.get_node(node).data.calls++;
+    if (!namespaces_filepath.empty())
+        namespaces.enter(op, rho);
+    timings.push_back({timestamp(), 0});
+}
+
+void CallGraph::exit() {
+    int node = tree.exit();
+    if (node != -1)
+        leave(node, timestamp());
+    if (!namespaces_filepath.empty())
+        namespaces.exit();
+}
+
+void CallGraph::unwind(SEXP rho) {
+    uint64_t now = timestamp();
+    tree.unwind(rho, [this, now](int node) { leave(node, now); });
+    if (!namespaces_filepath.empty())
+        namespaces.unwind(rho);
+}
+
+void CallGraph::allocate(long bytes) { namespaces.allocate(bytes); }
+
+void CallGraph::fork_parent(pid_t child_pid) {
+    children.push_back(child_pid);
+}
+
+// The calls active in the parent are not part of the tree of the child; their
+// exits are ignored, like those of calls entered before the trace began.
+void CallGraph::fork_child() {
+    string suffix = "." + to_string(getpid());
+    if (!folded_filepath.empty())
+        folded_filepath += suffix;
+    if (!summary_filepath.empty())
+        summary_filepath += suffix;
+    if (!namespaces_filepath.empty())
+        namespaces_filepath += suffix;
+    children.clear();
+    begin();
+}
+
+void CallGraph::leave(int node, uint64_t now) {
+    timing_t timing = timings.back();
+    timings.pop_back();
+
+    uint64_t inclusive = now - timing.start;
+    call_graph_node_t &data = tree.get_node(node).data;
+    data.inclusive_time += inclusive;
+    data.exclusive_time += inclusive - min(inclusive, timing.children);
+
+    if (!timings.empty())
+        timings.back().children += inclusive;
+}
+
+void CallGraph::write_folded() const {
+    ofstream file(folded_filepath);
+    if (!file) {
+        cerr << "Error: could not open " << folded_filepath << "\n";
+        return;
+    }
+
+    for (size_t node = 1; node < tree.size(); ++node) {
+        const call_graph_node_t &data = tree.get_node(node).data;
+        uint64_t value = metric == folded_metric::CALLS
+                             ? data.calls
+                             : data.exclusive_time / 1000;
+        if (value > 0)
+            file << tree.get_path(node) << " " << value << "\n";
+    }
+}
+
+void CallGraph::write_summary() const {
+    struct summary_t {
+        string name;
+        uint64_t calls = 0;
+        uint64_t contexts = 0;
+        uint64_t inclusive_time = 0;
+        uint64_t exclusive_time = 0;
+    };
+
+    unordered_map<string, summary_t> summaries;
+    // Number of active frames of each function on the current path, so that
+    // the inclusive time of recursive calls is only counted once.
+    unordered_map<string, int> on_path;
+
+    // Iterative depth first walk, R call stacks can be very deep. A negative
+    // entry means leaving the node -entry - 1.
+    vector<int> worklist(1, 0);
+    while (!worklist.empty()) {
+        int entry = worklist.back();
+        worklist.pop_back();
+
+        if (entry < 0) {
+            --on_path[tree.get_node(-entry - 1).name];
+            continue;
+        }
+
+        auto const &node = tree.get_node(entry);
+        if (entry != 0) {
+            summary_t &summary = summaries[node.name];
+            summary.name = node.name;
+            summary.calls += node.data.calls;
+            summary.contexts++;
+            summary.exclusive_time += node.data.exclusive_time;
+            if (on_path[node.name]++ == 0)
+                summary.inclusive_time += node.data.inclusive_time;
+            worklist.push_back(-entry - 1);
+        }
+
+        for (auto const &child : node.children)
+            worklist.push_back(child.second);
+    }
+
+    vector<summary_t> rows;
+    for (auto const &entry : summaries)
+        rows.push_back(entry.second);
+    sort(rows.begin(), rows.end(), [](const summary_t &a, const summary_t &b) {
+        return a.exclusive_time > b.exclusive_time;
+    });
+
+    TsvWriter file(summary_filepath,
+                   {"function", "calls", "contexts", "inclusive_ms",
+                    "exclusive_ms", "inclusive_percent", "exclusive_percent"});
+    if (!file.is_open())
+        return;
+
+    double total = max(tree.get_node(0).data.inclusive_time, uint64_t(1));
+    for (auto const &row : rows)
+        file.row(row.name, row.calls, row.contexts, row.inclusive_time / 1e6,
+                 row.exclusive_time / 1e6, 100 * row.inclusive_time / total,
+                 100 * row.exclusive_time / total);
+}
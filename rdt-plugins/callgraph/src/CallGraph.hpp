@@ -0,0 +1,75 @@
+#ifndef __CALL_GRAPH_HPP__
+#define __CALL_GRAPH_HPP__
+
+#include "CallingContextTree.hpp"
+#include "NamespaceCosts.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// What the folded stack file measures for every calling context.
+enum class folded_metric {
+    TIME = 0, // exclusive time in microseconds
+    CALLS = 1 // number of calls
+};
+
+struct call_graph_node_t {
+    uint64_t calls = 0;
+    uint64_t inclusive_time = 0; // nanoseconds
+    uint64_t exclusive_time = 0; // nanoseconds
+};
+
+// Calling-context tree with call counts and inclusive/exclusive time per
+// node. Everything stays in memory until the trace ends; nothing is written
+// while R runs.
+//
+// Children forked by parallel start from an empty tree and write their own
+// files, named after the files of the parent with their pid appended, when
+// they exit. Folded stack files of the parent and the children can be
+// concatenated, flame graph tools sum identical stacks.
+//
+// With a namespaces_filepath, the time and allocations are also summarized
+// per namespace, see NamespaceCosts.
+class CallGraph {
+  public:
+    CallGraph(const std::string &folded_filepath,
+              const std::string &summary_filepath,
+              const std::string &namespaces_filepath, folded_metric metric,
+              bool verbose);
+
+    void begin();
+    void end(const dyntracing_context_t &dyntracing_context);
+    void enter(SEXP call, SEXP op, SEXP rho);
+    void exit();
+    void unwind(SEXP rho);
+    void fork_parent(pid_t child_pid);
+    void fork_child();
+    void allocate(long bytes);
+
+  private:
+    struct timing_t {
+        uint64_t start;
+        uint64_t children; // inclusive time of the callees
+    };
+
+    void leave(int node, uint64_t now);
+    void write_folded() const;
+    void write_summary() const;
+
+    std::string folded_filepath;
+    std::string summary_filepath;
+    std::string namespaces_filepath;
+    folded_metric metric;
+    bool verbose;
+
+    CallingContextTree<call_graph_node_t> tree;
+    std::vector<timing_t> timings;
+    NamespaceCosts namespaces;
+    uint64_t begin_time;
+    uint64_t end_time;
+    std::vector<pid_t> children;
+};
+
+folded_metric string_to_folded_metric(const std::string &metric);
+
+#endif /* __CALL_GRAPH_HPP__ */
@@ -0,0 +1,36 @@
+#include "probes.hpp"
+
+// The probes do no allocation and no I/O; all the work happens in the
+// CallGraph owned by the dyntracer.
+
+RDT_PROFILER_ACCESSOR(CallGraph)
+
+void begin(dyntrace_context_t *context, const SEXP prom) {
+    profiler(context).begin();
+}
+
+void end(dyntrace_context_t *context) {
+    profiler(context).end(*context->dyntracing_context);
+}
+
+RDT_FORWARD_CLOSURE_PROBES(profiler)
+
+RDT_FORWARD_BUILTIN_PROBES(profiler)
+
+void vector_alloc(dyntrace_context_t *context, int sexptype, long length,
+                  long bytes, SEXP srcref) {
+    profiler(context).allocate(bytes);
+}
+
+void fork_parent(dyntrace_context_t *context, pid_t child_pid, int estranged) {
+    profiler(context).fork_parent(child_pid);
+}
+
+void fork_child(dyntrace_context_t *context, pid_t parent_pid) {
+    profiler(context).fork_child();
+}
+
+// Children leave with _exit, probe_end never fires in them.
+void fork_child_exit(dyntrace_context_t *context, int status) {
+    profiler(context).end(*context->dyntracing_context);
+}
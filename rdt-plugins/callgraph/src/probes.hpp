@@ -0,0 +1,24 @@
+#ifndef __PROBES_HPP__
+#define __PROBES_HPP__
+
+#include "CallGraph.hpp"
+#include "probe_forwarding.hpp"
+
+void begin(dyntrace_context_t *context, const SEXP prom);
+
+void end(dyntrace_context_t *context);
+
+RDT_DECLARE_CLOSURE_PROBES();
+
+RDT_DECLARE_BUILTIN_PROBES();
+
+void vector_alloc(dyntrace_context_t *context, int sexptype, long length,
+                  long bytes, SEXP srcref);
+
+void fork_parent(dyntrace_context_t *context, pid_t child_pid, int estranged);
+
+void fork_child(dyntrace_context_t *context, pid_t parent_pid);
+
+void fork_child_exit(dyntrace_context_t *context, int status);
+
+#endif /* __PROBES_HPP__ */
@@ -0,0 +1,59 @@
+#include "tracer.hpp"
+
+DYNTRACE_PLUGIN_ABI;
+
+static CallGraph *create_call_graph(SEXP options) {
+    return new CallGraph(
+        sexp_to_string(get_named_list_element(options, "folded_filepath"),
+                       "callgraph.folded"),
+        sexp_to_string(get_named_list_element(options, "summary_filepath"),
+                       "callgraph.tsv"),
+        sexp_to_string(get_named_list_element(options, "namespaces_filepath"),
+                       ""),
+        string_to_folded_metric(sexp_to_string(
+            get_named_list_element(options, "folded_metric"), "time")),
+        sexp_to_bool(get_named_list_element(options, "verbose"), false));
+}
+
+SEXP create_dyntracer(SEXP options) {
+
+    // calloc initializes the memory to zero. This ensures that probes not
+    // attached will point to NULL.
+    dyntracer_t *dyntracer = (dyntracer_t *)calloc(1, sizeof(dyntracer_t));
+
+    dyntracer->probe_begin = begin;
+    dyntracer->probe_end = end;
+    dyntracer->probe_function_entry = function_entry;
+    dyntracer->probe_function_exit = function_exit;
+    // Leaving the builtin and special probes out makes builtins count towards
+    // the exclusive time of their caller.
+    if (sexp_to_bool(get_named_list_element(options, "include_builtins"),
+                     true)) {
+        dyntracer->probe_builtin_entry = builtin_entry;
+        dyntracer->probe_builtin_exit = builtin_exit;
+        dyntracer->probe_specialsxp_entry = builtin_entry;
+        dyntracer->probe_specialsxp_exit = builtin_exit;
+    }
+    dyntracer->probe_jump_ctxt = jump_ctxt;
+    if (!sexp_to_string(get_named_list_element(options, "namespaces_filepath"))
+             .empty())
+        dyntracer->probe_vector_alloc = vector_alloc;
+    dyntracer->probe_fork_parent = fork_parent;
+    dyntracer->probe_fork_child = fork_child;
+    dyntracer->probe_fork_child_exit = fork_child_exit;
+    // See probes.cpp, the garbage collector can stay on.
+    dyntracer->non_allocating = 1;
+    dyntracer->context = create_call_graph(options);
+
+    return dyntracer_to_sexp(dyntracer, "dyntracer.callgraph");
+}
+
+static void destroy_call_graph_dyntracer(dyntracer_t *dyntracer) {
+    delete static_cast<CallGraph *>(dyntracer->context);
+    free(dyntracer);
+}
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp,
+                                  destroy_call_graph_dyntracer);
+}
@@ -0,0 +1,33 @@
+# Settings shared by the plugins, included from their CMakeLists.txt after
+# project(). The plugins add their own optimization and debug flags.
+
+set(CMAKE_LIBRARY_OUTPUT_DIRECTORY "${CMAKE_SOURCE_DIR}/lib")
+set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -std=c++14")
+
+# This is not ideal. Our build now depends on config.h generated by R's configure.
+# If we wanted to use cmake exclusively though, we would
+# have to recreate all the autoconf checks that GNU R performs.
+add_definitions(-DHAVE_CONFIG_H)
+# Rinternals.h defines length() as a macro which breaks the C++ standard
+# library, so we use the Rf_ prefixed names.
+add_definitions(-DR_NO_REMAP)
+
+# R include paths (in our R-dyntrace repo)
+set(R_SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}/../..")
+include_directories(${CMAKE_CURRENT_LIST_DIR}/src)
+include_directories(${R_SOURCE_DIR}/src/main)
+include_directories(${R_SOURCE_DIR}/include)
+include_directories(${R_SOURCE_DIR}/include/R_ext)
+include_directories(${R_SOURCE_DIR}/src/include)
+include_directories(${R_SOURCE_DIR}/src/include/R_ext)
+include_directories(${R_SOURCE_DIR}/src/include/Rmodules)
+include_directories(${R_SOURCE_DIR}/src/include/vg)
+
+# This tells the linker not to complain about undefined symbols
+# which are from the loader module (R in this case).
+# It's needed because this is a plugin library that will call
+# back to R API but we cannot link against it at compile time.
+if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    message(STATUS "Setting '-undefined dynamic_lookup' for clang")
+    set(CMAKE_SHARED_LIBRARY_CREATE_CXX_FLAGS "${CMAKE_SHARED_LIBRARY_CREATE_CXX_FLAGS} -undefined dynamic_lookup")
+endif()
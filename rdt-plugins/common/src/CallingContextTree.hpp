@@ -0,0 +1,134 @@
+#ifndef __RDT_COMMON_CALLING_CONTEXT_TREE_HPP__
+#define __RDT_COMMON_CALLING_CONTEXT_TREE_HPP__
+
+#include "utilities.hpp"
+#include <string>
+#include <utility>
+#include <vector>
+
+// Identifies the function of a call inside its parent node. Primitives are
+// keyed by their offset in R_FunTab (odd keys), closures by the symbol they
+// were called through (symbols are aligned pointers, so keys are even) and
+// anonymous closures share key 0.
+typedef uintptr_t cct_key_t;
+
+inline cct_key_t get_call_key(SEXP call, SEXP op) {
+    if (TYPEOF(op) == BUILTINSXP || TYPEOF(op) == SPECIALSXP)
+        return (static_cast<cct_key_t>(PRIMOFFSET(op)) << 1) | 1;
+    return reinterpret_cast<cct_key_t>(get_call_symbol(call)) &
+           ~static_cast<cct_key_t>(1);
+}
+
+// Calling-context tree. Every node stands for a distinct path of calls from
+// the root and carries a T supplied by the tracer. The tree also keeps the
+// stack of active calls, so that tracers only have to forward the function
+// entry/exit and jump_ctxt probes.
+//
+// Nodes are referred to by their index and never move or disappear until the
+// tree is destroyed. Node 0 is the root.
+template <typename T> class CallingContextTree {
+  public:
+    struct node_t {
+        cct_key_t key;
+        int parent;
+        int depth;
+        std::string name;
+        // Most nodes have a handful of children, a linear scan beats hashing.
+        std::vector<std::pair<cct_key_t, int>> children;
+        T data;
+    };
+
+    CallingContextTree() : nodes(1) {
+        nodes[0].key = 0;
+        nodes[0].parent = -1;
+        nodes[0].depth = 0;
+        nodes[0].name = "<root>";
+    }
+
+    // Enters the child of the current node for this call and returns it.
+    // rho is only kept for closures, it is what jump_ctxt unwinds to.
+    int enter(SEXP call, SEXP op, SEXP rho) {
+        int parent = get_current();
+        cct_key_t key = get_call_key(call, op);
+
+        int child = -1;
+        for (auto const &entry : nodes[parent].children) {
+            if (entry.first == key) {
+                child = entry.second;
+                break;
+            }
+        }
+
+        if (child == -1) {
+            child = nodes.size();
+            nodes.emplace_back();
+            node_t &node = nodes.back();
+            node.key = key;
+            node.parent = parent;
+            node.depth = nodes[parent].depth + 1;
+            node.name = get_call_name(call, op);
+            nodes[parent].children.emplace_back(key, child);
+        }
+
+        bool closure = TYPEOF(op) == CLOSXP;
+        stack.push_back({child, closure ? rho : nullptr});
+        return child;
+    }
+
+    // Leaves the current node and returns it. Returns -1 if no call is
+    // active, which happens for exits of calls entered before tracing began.
+    int exit() {
+        if (stack.empty())
+            return -1;
+        int node = stack.back().node;
+        stack.pop_back();
+        return node;
+    }
+
+    // Leaves every call up to the closure whose environment is rho, which is
+    // the target of a longjmp. popped(node) is called for each of them.
+    template <typename F> void unwind(SEXP rho, F popped) {
+        while (!stack.empty() && stack.back().rho != rho) {
+            int node = stack.back().node;
+            stack.pop_back();
+            popped(node);
+        }
+    }
+
+    int get_current() const { return stack.empty() ? 0 : stack.back().node; }
+
+    size_t get_stack_depth() const { return stack.size(); }
+
+    node_t &get_node(int node) { return nodes[node]; }
+
+    const node_t &get_node(int node) const { return nodes[node]; }
+
+    size_t size() const { return nodes.size(); }
+
+    // Names of the functions from the root (excluded) to node, joined by
+    // separator. This is the stack format of folded flame graph files.
+    std::string get_path(int node, char separator = ';') const {
+        std::vector<int> path;
+        for (; node > 0; node = nodes[node].parent)
+            path.push_back(node);
+
+        std::string result;
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            if (!result.empty())
+                result += separator;
+            result += nodes[*it].name;
+        }
+        return result;
+    }
+
+  private:
+    struct frame_t {
+        int node;
+        SEXP rho;
+    };
+
+    std::vector<node_t> nodes;
+    std::vector<frame_t> stack;
+};
+
+#endif /* __RDT_COMMON_CALLING_CONTEXT_TREE_HPP__ */
@@ -0,0 +1,123 @@
+#include "NamespaceCosts.hpp"
+#include "TsvWriter.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+static const int GLOBAL_NAMESPACE = 0;
+static const int BASE_NAMESPACE = 1;
+
+NamespaceCosts::NamespaceCosts() { begin(); }
+
+void NamespaceCosts::begin() {
+    namespaces.clear();
+    by_address.clear();
+    by_name.clear();
+    stack.clear();
+    get_namespace("<global>");
+    get_namespace("base");
+
+    begin_time = end_time = last_time = timestamp();
+    // The traced expression, never popped by exits and unwinds.
+    push(GLOBAL_NAMESPACE, nullptr, begin_time);
+}
+
+void NamespaceCosts::end() {
+    end_time = timestamp();
+    while (!stack.empty())
+        pop(end_time);
+}
+
+void NamespaceCosts::enter(SEXP op, SEXP rho) {
+    uint64_t now = timestamp();
+    charge(now);
+    if (TYPEOF(op) == CLOSXP)
+        push(get_namespace(dyntrace_get_namespace_name(CLOENV(op))), rho, now);
+    else
+        push(BASE_NAMESPACE, nullptr, now);
+}
+
+// Exits of calls entered before tracing began find only the traced
+// expression on the stack.
+void NamespaceCosts::exit() {
+    if (stack.size() > 1)
+        pop(timestamp());
+}
+
+void NamespaceCosts::unwind(SEXP rho) {
+    uint64_t now = timestamp();
+    while (stack.size() > 1 && stack.back().rho != rho)
+        pop(now);
+}
+
+void NamespaceCosts::allocate(long bytes) {
+    if (stack.empty())
+        return;
+    namespaces[stack.back().ns].self_bytes += bytes;
+    for (namespace_cost_t &ns : namespaces)
+        if (ns.active > 0)
+            ns.inclusive_bytes += bytes;
+}
+
+int NamespaceCosts::get_namespace(const char *name) {
+    if (name == nullptr)
+        return GLOBAL_NAMESPACE;
+
+    auto address = by_address.find(name);
+    if (address != by_address.end())
+        return address->second;
+
+    auto entry = by_name.emplace(name, namespaces.size());
+    if (entry.second) {
+        namespaces.emplace_back();
+        namespaces.back().name = name;
+    }
+    by_address[name] = entry.first->second;
+    return entry.first->second;
+}
+
+void NamespaceCosts::charge(uint64_t now) {
+    if (!stack.empty())
+        namespaces[stack.back().ns].self_time += now - last_time;
+    last_time = now;
+}
+
+void NamespaceCosts::push(int ns, SEXP rho, uint64_t now) {
+    namespace_cost_t &cost = namespaces[ns];
+    cost.calls++;
+    if (cost.active++ == 0)
+        cost.inclusive_start = now;
+    stack.push_back({ns, rho});
+}
+
+void NamespaceCosts::pop(uint64_t now) {
+    charge(now);
+    namespace_cost_t &cost = namespaces[stack.back().ns];
+    if (--cost.active == 0)
+        cost.inclusive_time += now - cost.inclusive_start;
+    stack.pop_back();
+}
+
+void NamespaceCosts::write(const std::string &filepath) const {
+    TsvWriter file(filepath, {"namespace", "calls", "self_ms", "inclusive_ms",
+                              "self_percent", "inclusive_percent",
+                              "self_bytes", "inclusive_bytes"});
+    if (!file.is_open())
+        return;
+
+    vector<const namespace_cost_t *> rows;
+    for (auto const &ns : namespaces)
+        rows.push_back(&ns);
+    sort(rows.begin(), rows.end(),
+         [](const namespace_cost_t *a, const namespace_cost_t *b) {
+             return a->self_time > b->self_time;
+         });
+
+    double total = max(get_total_time(), uint64_t(1));
+    for (const namespace_cost_t *row : rows)
+        file.row(row->name, row->calls, row->self_time / 1e6,
+                 row->inclusive_time / 1e6, 100 * row->self_time / total,
+                 100 * row->inclusive_time / total, row->self_bytes,
+                 row->inclusive_bytes);
+}
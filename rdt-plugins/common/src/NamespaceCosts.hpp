@@ -0,0 +1,73 @@
+#ifndef __RDT_COMMON_NAMESPACE_COSTS_HPP__
+#define __RDT_COMMON_NAMESPACE_COSTS_HPP__
+
+#include "utilities.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct namespace_cost_t {
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t self_time = 0;      // nanoseconds
+    uint64_t inclusive_time = 0; // nanoseconds
+    uint64_t self_bytes = 0;
+    uint64_t inclusive_bytes = 0;
+    // Frames of the namespace on the stack, and when the outermost one began.
+    int active = 0;
+    uint64_t inclusive_start = 0;
+};
+
+// Time and allocated bytes per namespace of the executing code, for any
+// tracer that forwards its function, builtin, special, jump_ctxt and
+// vector_alloc probes. Closures belong to the namespace their environment is
+// or is enclosed by (<global> for closures defined outside of namespaces),
+// builtins and specials to base. Code run by the traced expression itself
+// belongs to <global>.
+//
+// Self columns count what happens while code of the namespace is on top of
+// the stack, inclusive columns while it is anywhere on the stack; recursion
+// through a namespace is counted once. Nothing here allocates on the R heap.
+class NamespaceCosts {
+  public:
+    NamespaceCosts();
+
+    void begin();
+    // Leaves the calls still active, e.g. because of an error.
+    void end();
+    void enter(SEXP op, SEXP rho);
+    void exit();
+    void unwind(SEXP rho);
+    void allocate(long bytes);
+
+    // Tab separated, one row per namespace by decreasing self time.
+    void write(const std::string &filepath) const;
+    const std::vector<namespace_cost_t> &get_namespaces() const {
+        return namespaces;
+    }
+    uint64_t get_total_time() const { return end_time - begin_time; }
+
+  private:
+    struct frame_t {
+        int ns;
+        SEXP rho; // nullptr for builtins and specials
+    };
+
+    int get_namespace(const char *name);
+    void charge(uint64_t now);
+    void push(int ns, SEXP rho, uint64_t now);
+    void pop(uint64_t now);
+
+    std::vector<namespace_cost_t> namespaces;
+    // Namespace names are CHARSXPs of the namespace spec, stable while the
+    // namespace is loaded; looking them up by address avoids hashing them.
+    std::unordered_map<const char *, int> by_address;
+    std::unordered_map<std::string, int> by_name;
+    std::vector<frame_t> stack;
+    uint64_t last_time = 0;
+    uint64_t begin_time = 0;
+    uint64_t end_time = 0;
+};
+
+#endif /* __RDT_COMMON_NAMESPACE_COSTS_HPP__ */
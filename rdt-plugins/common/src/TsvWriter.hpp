@@ -0,0 +1,49 @@
+#ifndef __RDT_COMMON_TSV_WRITER_HPP__
+#define __RDT_COMMON_TSV_WRITER_HPP__
+
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+
+// Tab separated report of a plugin. The header is written when the file is
+// opened and row() writes one line. When the file cannot be opened, the error
+// is reported once and the rows are dropped.
+class TsvWriter {
+  public:
+    TsvWriter(const std::string &filepath,
+              std::initializer_list<const char *> columns)
+        : file(filepath) {
+        if (!file) {
+            std::cerr << "Error: could not open " << filepath << "\n";
+            return;
+        }
+        const char *separator = "";
+        for (const char *column : columns) {
+            file << separator << column;
+            separator = "\t";
+        }
+        file << "\n";
+    }
+
+    bool is_open() const { return static_cast<bool>(file); }
+
+    template <typename Value, typename... Values>
+    void row(const Value &value, const Values &... values) {
+        file << value;
+        write_columns(values...);
+    }
+
+  private:
+    void write_columns() { file << "\n"; }
+
+    template <typename Value, typename... Values>
+    void write_columns(const Value &value, const Values &... values) {
+        file << "\t" << value;
+        write_columns(values...);
+    }
+
+    std::ofstream file;
+};
+
+#endif /* __RDT_COMMON_TSV_WRITER_HPP__ */
@@ -0,0 +1,70 @@
+#ifndef __RDT_COMMON_PROBE_FORWARDING_HPP__
+#define __RDT_COMMON_PROBE_FORWARDING_HPP__
+
+// Probes which only forward to the profiler owned by the dyntracer. A
+// plugin's probes.hpp declares them with the RDT_DECLARE_ macros and its
+// probes.cpp defines them with the matching RDT_FORWARD_ macros, after
+// RDT_PROFILER_ACCESSOR. The forwarding macros take the name of the
+// accessor, so that a plugin can forward to a member of its profiler.
+
+#include "utilities.hpp"
+
+// profiler(context), the Profiler set as dyntracer_context by
+// create_dyntracer.
+#define RDT_PROFILER_ACCESSOR(Profiler)                                        \
+    static inline Profiler &profiler(dyntrace_context_t *context) {            \
+        return *static_cast<Profiler *>(context->dyntracer_context);           \
+    }
+
+#define RDT_DECLARE_BEGIN_END_PROBES()                                         \
+    void begin(dyntrace_context_t *context, const SEXP prom);                  \
+    void end(dyntrace_context_t *context)
+
+// begin() and end() without arguments.
+#define RDT_FORWARD_BEGIN_END_PROBES(accessor)                                 \
+    void begin(dyntrace_context_t *context, const SEXP prom) {                 \
+        accessor(context).begin();                                             \
+    }                                                                          \
+    void end(dyntrace_context_t *context) { accessor(context).end(); }
+
+#define RDT_DECLARE_CLOSURE_PROBES()                                           \
+    void function_entry(dyntrace_context_t *context, const SEXP call,          \
+                        const SEXP op, const SEXP rho);                        \
+    void function_exit(dyntrace_context_t *context, const SEXP call,           \
+                       const SEXP op, const SEXP rho, const SEXP retval);      \
+    void jump_ctxt(dyntrace_context_t *context, const SEXP rho, const SEXP val)
+
+// Closure calls and the jumps out of them, for the calling context trees:
+// enter(call, op, rho), exit() and unwind(rho).
+#define RDT_FORWARD_CLOSURE_PROBES(accessor)                                   \
+    void function_entry(dyntrace_context_t *context, const SEXP call,          \
+                        const SEXP op, const SEXP rho) {                       \
+        accessor(context).enter(call, op, rho);                                \
+    }                                                                          \
+    void function_exit(dyntrace_context_t *context, const SEXP call,           \
+                       const SEXP op, const SEXP rho, const SEXP retval) {     \
+        accessor(context).exit();                                              \
+    }                                                                          \
+    void jump_ctxt(dyntrace_context_t *context, const SEXP rho,                \
+                   const SEXP val) {                                           \
+        accessor(context).unwind(rho);                                         \
+    }
+
+#define RDT_DECLARE_BUILTIN_PROBES()                                           \
+    void builtin_entry(dyntrace_context_t *context, const SEXP call,           \
+                       const SEXP op, const SEXP rho);                         \
+    void builtin_exit(dyntrace_context_t *context, const SEXP call,            \
+                      const SEXP op, const SEXP rho, const SEXP retval)
+
+// Builtin calls, also attached to the special probes by the tracers.
+#define RDT_FORWARD_BUILTIN_PROBES(accessor)                                   \
+    void builtin_entry(dyntrace_context_t *context, const SEXP call,           \
+                       const SEXP op, const SEXP rho) {                        \
+        accessor(context).enter(call, op, rho);                                \
+    }                                                                          \
+    void builtin_exit(dyntrace_context_t *context, const SEXP call,            \
+                      const SEXP op, const SEXP rho, const SEXP retval) {      \
+        accessor(context).exit();                                              \
+    }
+
+#endif /* __RDT_COMMON_PROBE_FORWARDING_HPP__ */
@@ -0,0 +1,50 @@
+#include "utilities.hpp"
+
+bool sexp_to_bool(SEXP value, bool default_value) {
+    if (value != NULL && value != R_NilValue && TYPEOF(value) == LGLSXP)
+        return LOGICAL(value)[0] == TRUE;
+    else
+        return default_value;
+}
+
+int sexp_to_int(SEXP value, int default_value) {
+    if (value != NULL && value != R_NilValue && TYPEOF(value) == REALSXP)
+        return (int)*REAL(value);
+    else if (value != NULL && value != R_NilValue && TYPEOF(value) == INTSXP)
+        return *INTEGER(value);
+    else
+        return default_value;
+}
+
+std::string sexp_to_string(SEXP value, const std::string &default_value) {
+    if (value != NULL && value != R_NilValue && TYPEOF(value) == STRSXP)
+        return std::string(CHAR(STRING_ELT(value, 0)));
+    else
+        return default_value;
+}
+
+SEXP get_call_symbol(SEXP call) {
+    if (TYPEOF(call) != LANGSXP)
+        return R_NilValue;
+
+    SEXP function = CAR(call);
+    if (TYPEOF(function) == SYMSXP)
+        return function;
+
+    // pkg::f and pkg:::f
+    if (TYPEOF(function) == LANGSXP &&
+        (CAR(function) == R_DoubleColonSymbol ||
+         CAR(function) == R_TripleColonSymbol) &&
+        TYPEOF(CADDR(function)) == SYMSXP)
+        return CADDR(function);
+
+    return R_NilValue;
+}
+
+std::string get_call_name(SEXP call, SEXP op) {
+    if (TYPEOF(op) == BUILTINSXP || TYPEOF(op) == SPECIALSXP)
+        return PRIMNAME(op);
+
+    const char *name = dyntrace_get_call_name(call);
+    return name == NULL ? "<anonymous>" : name;
+}
@@ -0,0 +1,46 @@
+#ifndef __RDT_COMMON_UTILITIES_HPP__
+#define __RDT_COMMON_UTILITIES_HPP__
+
+// Helpers shared by the tracers built on the dyntracer_t interface of
+// Rdyntrace.h. Plugins add ../common/src to their sources, the include path
+// and the compile flags come from ../common/plugin.cmake.
+//
+// The plugins are compiled with R_NO_REMAP, otherwise the length() macro of
+// Rinternals.h breaks the standard library headers; use the Rf_ names.
+// USE_RINTERNALS exposes the primitive accessors of Defn.h (PRIMOFFSET...),
+// R_USE_SIGNALS the RCNTXT passed to the context probes.
+
+#define USE_RINTERNALS
+#define R_USE_SIGNALS 1
+#include <Rdyntrace.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+bool sexp_to_bool(SEXP value, bool default_value = false);
+
+int sexp_to_int(SEXP value, int default_value = 0);
+
+std::string sexp_to_string(SEXP value,
+                           const std::string &default_value = std::string(""));
+
+// Symbol naming the function of a call: f for f(...), and f for pkg::f(...)
+// and pkg:::f(...). R_NilValue for anonymous calls such as (function(x)
+// x)(1) or l$f(). Symbols are never collected, so their addresses are stable
+// keys for the whole trace.
+SEXP get_call_symbol(SEXP call);
+
+// Name under which a call appears in reports: the primitive name for builtins
+// and specials, dyntrace_get_call_name for closures, "<anonymous>" otherwise.
+// Source locations and namespaces come from the dyntrace_get_* helpers of
+// Rdyntrace.h.
+std::string get_call_name(SEXP call, SEXP op);
+
+// Monotonic time in nanoseconds.
+inline uint64_t timestamp() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+#endif /* __RDT_COMMON_UTILITIES_HPP__ */
@@ -0,0 +1,188 @@
+#include "ConditionProfiler.hpp"
+#include "TsvWriter.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+ConditionProfiler::ConditionProfiler(
+    const std::string &establishers_filepath,
+    const std::vector<std::string> &establishers, bool verbose)
+    : establishers_filepath(establishers_filepath), verbose(verbose) {
+    // Installed here, probes may not allocate.
+    for (auto const &name : establishers)
+        establisher_symbols.push_back(Rf_install(name.c_str()));
+    expr_symbol = Rf_install("expr");
+}
+
+void ConditionProfiler::begin() {
+    actives.clear();
+    pending_contexts = 0;
+    pending_onexits = 0;
+    pending_unwind_time = 0;
+    summaries.clear();
+}
+
+void ConditionProfiler::end() {
+    uint64_t now = timestamp();
+    while (!actives.empty()) {
+        finish(actives.back(), now);
+        actives.pop_back();
+    }
+
+    if (!establishers_filepath.empty())
+        write_establishers();
+
+    if (verbose) {
+        uint64_t calls = 0, overhead = 0, jumps = 0;
+        for (auto const &entry : summaries) {
+            calls += entry.second.calls;
+            overhead +=
+                entry.second.inclusive_time - entry.second.expression_time;
+            jumps += entry.second.jumps;
+        }
+        cerr << "Condition handling: " << calls << " establisher calls, "
+             << overhead / 1e6 << "ms overhead, " << jumps << " jumps\n";
+    }
+}
+
+// The closure context that called the establisher of cptr.
+static string get_caller_name(const RCNTXT *cptr) {
+    for (cptr = cptr->nextcontext;
+         cptr != nullptr && cptr->callflag != CTXT_TOPLEVEL;
+         cptr = cptr->nextcontext)
+        if ((cptr->callflag & CTXT_FUNCTION) &&
+            TYPEOF(cptr->callfun) == CLOSXP)
+            return get_call_name(cptr->call, cptr->callfun);
+    return "<top level>";
+}
+
+void ConditionProfiler::context_entry(const RCNTXT *cptr) {
+    if (!(cptr->callflag & CTXT_FUNCTION) || TYPEOF(cptr->callfun) != CLOSXP)
+        return;
+    SEXP symbol = get_call_symbol(cptr->call);
+    if (find(establisher_symbols.begin(), establisher_symbols.end(),
+             symbol) == establisher_symbols.end())
+        return;
+
+    active_t active;
+    active.cptr = cptr;
+    active.depth = cptr->depth;
+    active.key = {get_caller_name(cptr), CHAR(PRINTNAME(symbol))};
+    active.start = timestamp();
+    // The arguments are bound before the context begins. Closure frames are
+    // not hashed, the lookup does not allocate.
+    active.promise = Rf_findVarInFrame3(cptr->cloenv, expr_symbol, TRUE);
+    if (TYPEOF(active.promise) != PROMSXP)
+        active.promise = R_NilValue;
+    actives.push_back(active);
+}
+
+void ConditionProfiler::context_exit(const RCNTXT *cptr) {
+    if (!actives.empty() && actives.back().cptr == cptr) {
+        finish(actives.back(), timestamp());
+        actives.pop_back();
+    }
+}
+
+void ConditionProfiler::context_unwind(const RCNTXT *cptr,
+                                       const RCNTXT *target, int contexts,
+                                       int onexits, uint64_t unwind_time) {
+    uint64_t now = timestamp();
+    uint64_t unwind_start = now - unwind_time;
+
+    // Establishers above cptr are left.
+    while (!actives.empty() && actives.back().depth > cptr->depth) {
+        active_t &active = actives.back();
+        if (active.force_start != 0) {
+            active.expression_time += unwind_start - active.force_start;
+            active.force_start = 0;
+        }
+        finish(active, now);
+        actives.pop_back();
+    }
+
+    pending_contexts += contexts;
+    pending_onexits += onexits;
+    pending_unwind_time += unwind_time;
+    if (cptr != target)
+        return;
+
+    // The jump lands in the innermost establisher. It came out of its
+    // expression if the context that forced expr was left.
+    if (!actives.empty()) {
+        active_t &active = actives.back();
+        if (active.force_start != 0 && active.force_depth >= cptr->depth) {
+            active.expression_time += unwind_start - active.force_start;
+            active.force_start = 0;
+
+            establisher_summary_t &summary = summaries[active.key];
+            summary.jumps++;
+            summary.contexts_unwound += pending_contexts;
+            summary.onexits += pending_onexits;
+            summary.unwind_time += pending_unwind_time;
+        }
+    }
+    pending_contexts = 0;
+    pending_onexits = 0;
+    pending_unwind_time = 0;
+}
+
+void ConditionProfiler::force_entry(SEXP promise) {
+    for (auto it = actives.rbegin(); it != actives.rend(); ++it) {
+        if (it->promise == promise && it->force_start == 0) {
+            it->force_start = timestamp();
+            it->force_depth = R_GlobalContext->depth;
+            return;
+        }
+    }
+}
+
+void ConditionProfiler::force_exit(SEXP promise) {
+    for (auto it = actives.rbegin(); it != actives.rend(); ++it) {
+        if (it->promise == promise && it->force_start != 0) {
+            it->expression_time += timestamp() - it->force_start;
+            it->force_start = 0;
+            return;
+        }
+    }
+}
+
+void ConditionProfiler::finish(active_t &active, uint64_t now) {
+    if (active.force_start != 0)
+        active.expression_time += now - active.force_start;
+
+    establisher_summary_t &summary = summaries[active.key];
+    summary.calls++;
+    uint64_t inclusive = now - active.start;
+    summary.inclusive_time += inclusive;
+    summary.expression_time += min(active.expression_time, inclusive);
+}
+
+void ConditionProfiler::write_establishers() const {
+    TsvWriter file(establishers_filepath,
+                   {"caller", "establisher", "calls", "inclusive_ms",
+                    "expression_ms", "overhead_ms", "mean_overhead_us", "jumps",
+                    "contexts_unwound", "onexits", "unwind_ms"});
+    if (!file.is_open())
+        return;
+
+    typedef pair<pair<string, string>, establisher_summary_t> row_t;
+    vector<row_t> rows(summaries.begin(), summaries.end());
+    auto overhead = [](const row_t &row) {
+        return row.second.inclusive_time - row.second.expression_time;
+    };
+    sort(rows.begin(), rows.end(), [&overhead](const row_t &a, const row_t &b) {
+        return overhead(a) > overhead(b);
+    });
+
+    for (auto const &row : rows) {
+        const establisher_summary_t &summary = row.second;
+        file.row(row.first.first, row.first.second, summary.calls,
+                 summary.inclusive_time / 1e6, summary.expression_time / 1e6,
+                 overhead(row) / 1e6,
+                 overhead(row) / 1e3 / max(summary.calls, uint64_t(1)),
+                 summary.jumps, summary.contexts_unwound, summary.onexits,
+                 summary.unwind_time / 1e6);
+    }
+}
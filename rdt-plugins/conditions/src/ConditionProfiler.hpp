@@ -0,0 +1,80 @@
+#ifndef __CONDITION_PROFILER_HPP__
+#define __CONDITION_PROFILER_HPP__
+
+#include "utilities.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct establisher_summary_t {
+    uint64_t calls = 0;
+    uint64_t inclusive_time = 0;
+    // forcing the expr argument, the protected code
+    uint64_t expression_time = 0;
+    // jumps out of expr landing in the establisher, i.e. conditions caught
+    // by exiting handlers and restarts invoked
+    uint64_t jumps = 0;
+    uint64_t contexts_unwound = 0;
+    uint64_t onexits = 0;
+    uint64_t unwind_time = 0;
+};
+
+// Measures the cost of condition handling per handler-establishing function
+// (tryCatch, withCallingHandlers...) and the function calling it. The time
+// of a call minus the time forcing its expr argument is the overhead of
+// establishing the handlers, running them and unwinding to them. Unwinds
+// landing in an establisher from its expression are counted with the
+// contexts they left, the on.exit code they ran and their duration.
+//
+// Calling handlers run while expr is being forced, their time counts as
+// expression time.
+class ConditionProfiler {
+  public:
+    ConditionProfiler(const std::string &establishers_filepath,
+                      const std::vector<std::string> &establishers,
+                      bool verbose);
+
+    void begin();
+    void end();
+    void context_entry(const RCNTXT *cptr);
+    void context_exit(const RCNTXT *cptr);
+    void context_unwind(const RCNTXT *cptr, const RCNTXT *target,
+                        int contexts, int onexits, uint64_t unwind_time);
+    void force_entry(SEXP promise);
+    void force_exit(SEXP promise);
+
+  private:
+    // An active call to an establisher.
+    struct active_t {
+        const RCNTXT *cptr;
+        int depth;
+        std::pair<std::string, std::string> key; // caller, establisher
+        uint64_t start;
+        SEXP promise; // expr, R_NilValue if it is not a promise
+        uint64_t force_start = 0;
+        int force_depth = 0;
+        uint64_t expression_time = 0;
+    };
+
+    void finish(active_t &active, uint64_t now);
+    void write_establishers() const;
+
+    std::string establishers_filepath;
+    bool verbose;
+    std::vector<SEXP> establisher_symbols;
+    SEXP expr_symbol;
+
+    std::vector<active_t> actives;
+    // A jump through contexts with on.exit code is reported in steps, they
+    // are added up until the final target is reached.
+    int pending_contexts = 0;
+    int pending_onexits = 0;
+    uint64_t pending_unwind_time = 0;
+
+    std::map<std::pair<std::string, std::string>, establisher_summary_t>
+        summaries;
+};
+
+#endif /* __CONDITION_PROFILER_HPP__ */
@@ -0,0 +1,28 @@
+#include "probes.hpp"
+
+RDT_PROFILER_ACCESSOR(ConditionProfiler)
+
+RDT_FORWARD_BEGIN_END_PROBES(profiler)
+
+void context_entry(dyntrace_context_t *context, const RCNTXT *cptr) {
+    profiler(context).context_entry(cptr);
+}
+
+void context_exit(dyntrace_context_t *context, const RCNTXT *cptr) {
+    profiler(context).context_exit(cptr);
+}
+
+void context_unwind(dyntrace_context_t *context, const RCNTXT *cptr,
+                    const RCNTXT *target, const SEXP val, int contexts,
+                    int onexits, uint64_t unwind_time) {
+    profiler(context).context_unwind(cptr, target, contexts, onexits,
+                                     unwind_time);
+}
+
+void promise_force_entry(dyntrace_context_t *context, const SEXP promise) {
+    profiler(context).force_entry(promise);
+}
+
+void promise_force_exit(dyntrace_context_t *context, const SEXP promise) {
+    profiler(context).force_exit(promise);
+}
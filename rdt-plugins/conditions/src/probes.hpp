@@ -0,0 +1,21 @@
+#ifndef __PROBES_HPP__
+#define __PROBES_HPP__
+
+#include "ConditionProfiler.hpp"
+#include "probe_forwarding.hpp"
+
+RDT_DECLARE_BEGIN_END_PROBES();
+
+void context_entry(dyntrace_context_t *context, const RCNTXT *cptr);
+
+void context_exit(dyntrace_context_t *context, const RCNTXT *cptr);
+
+void context_unwind(dyntrace_context_t *context, const RCNTXT *cptr,
+                    const RCNTXT *target, const SEXP val, int contexts,
+                    int onexits, uint64_t unwind_time);
+
+void promise_force_entry(dyntrace_context_t *context, const SEXP promise);
+
+void promise_force_exit(dyntrace_context_t *context, const SEXP promise);
+
+#endif /* __PROBES_HPP__ */
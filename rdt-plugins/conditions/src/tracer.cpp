@@ -0,0 +1,54 @@
+#include "tracer.hpp"
+
+DYNTRACE_PLUGIN_ABI;
+
+static std::vector<std::string> get_establishers(SEXP value) {
+    if (TYPEOF(value) != STRSXP)
+        return {"tryCatch",         "try",
+                "withCallingHandlers", "withRestarts",
+                "suppressWarnings", "suppressMessages"};
+
+    std::vector<std::string> establishers;
+    for (int i = 0; i < Rf_length(value); ++i)
+        establishers.push_back(CHAR(STRING_ELT(value, i)));
+    return establishers;
+}
+
+static ConditionProfiler *create_condition_profiler(SEXP options) {
+    return new ConditionProfiler(
+        sexp_to_string(
+            get_named_list_element(options, "establishers_filepath"),
+            "condition_establishers.tsv"),
+        get_establishers(get_named_list_element(options, "establishers")),
+        sexp_to_bool(get_named_list_element(options, "verbose"), false));
+}
+
+SEXP create_dyntracer(SEXP options) {
+
+    // calloc initializes the memory to zero. This ensures that probes not
+    // attached will point to NULL.
+    dyntracer_t *dyntracer = (dyntracer_t *)calloc(1, sizeof(dyntracer_t));
+
+    dyntracer->probe_begin = begin;
+    dyntracer->probe_end = end;
+    dyntracer->probe_context_entry = context_entry;
+    dyntracer->probe_context_exit = context_exit;
+    dyntracer->probe_context_unwind = context_unwind;
+    dyntracer->probe_promise_force_entry = promise_force_entry;
+    dyntracer->probe_promise_force_exit = promise_force_exit;
+    // The frame lookups of the probes do not allocate, the collector can
+    // stay on.
+    dyntracer->non_allocating = 1;
+    dyntracer->context = create_condition_profiler(options);
+
+    return dyntracer_to_sexp(dyntracer, "dyntracer.conditions");
+}
+
+static void destroy_condition_dyntracer(dyntracer_t *dyntracer) {
+    delete static_cast<ConditionProfiler *>(dyntracer->context);
+    free(dyntracer);
+}
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp, destroy_condition_dyntracer);
+}
@@ -0,0 +1,20 @@
+#ifndef __TRACER_HPP__
+#define __TRACER_HPP__
+
+#include "ConditionProfiler.hpp"
+#include "probes.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Entry points for .Call, see the README for usage.
+SEXP create_dyntracer(SEXP options);
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TRACER_HPP__ */
@@ -0,0 +1,129 @@
+#include "DuplicateProfiler.hpp"
+#include "TsvWriter.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+DuplicateProfiler::DuplicateProfiler(const std::string &sites_filepath,
+                                     const std::string &folded_filepath,
+                                     bool verbose)
+    : sites_filepath(sites_filepath), folded_filepath(folded_filepath),
+      verbose(verbose) {}
+
+void DuplicateProfiler::begin() {
+    tree = CallingContextTree<duplicate_node_t>();
+    sites.clear();
+    site_ids.clear();
+}
+
+void DuplicateProfiler::end() {
+    if (!sites_filepath.empty())
+        write_sites();
+    if (!folded_filepath.empty())
+        write_folded();
+
+    if (verbose) {
+        uint64_t copies = 0, bytes = 0;
+        for (auto const &site : sites) {
+            copies += site.copies;
+            bytes += site.bytes;
+        }
+        cerr << "Duplicates: " << copies << " copies, " << bytes
+             << " bytes from " << sites.size() << " sites\n";
+    }
+}
+
+void DuplicateProfiler::enter(SEXP call, SEXP op, SEXP rho) {
+    tree.enter(call, op, rho);
+}
+
+void DuplicateProfiler::exit() { tree.exit(); }
+
+void DuplicateProfiler::unwind(SEXP rho) {
+    tree.unwind(rho, [](int node) {});
+}
+
+void DuplicateProfiler::duplicate(SEXP object, bool deep, R_size_t bytes,
+                                  SEXP srcref) {
+    int node = tree.get_current();
+    duplicate_node_t &data = tree.get_node(node).data;
+    data.copies++;
+    data.bytes += bytes;
+
+    duplicate_site_t &site = sites[get_site(node, srcref)];
+    site.copies++;
+    if (deep)
+        site.deep_copies++;
+    site.bytes += bytes;
+    site.max_bytes = max<uint64_t>(site.max_bytes, bytes);
+    size_t type = TYPEOF(object);
+    if (type < site.types.size())
+        site.types[type]++;
+}
+
+int DuplicateProfiler::get_site(int node, SEXP srcref) {
+    dyntrace_srcref_t location;
+    dyntrace_get_srcref(srcref, &location);
+    site_key_t key{node, location.filename ? location.filename : "",
+                   location.line, location.column};
+
+    auto iterator = site_ids.find(key);
+    if (iterator != site_ids.end())
+        return iterator->second;
+
+    int id = sites.size();
+    sites.emplace_back();
+    duplicate_site_t &site = sites.back();
+    site.node = node;
+    site.srcfile = key.filename;
+    site.line = key.line;
+    site.column = key.column;
+    site_ids.emplace(key, id);
+    return id;
+}
+
+void DuplicateProfiler::write_sites() const {
+    TsvWriter file(sites_filepath,
+                   {"site", "function", "context", "srcfile", "line", "column",
+                    "copies", "deep_copies", "bytes", "max_bytes", "types"});
+    if (!file.is_open())
+        return;
+
+    vector<int> order(sites.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    sort(order.begin(), order.end(),
+         [this](int a, int b) { return sites[a].bytes > sites[b].bytes; });
+
+    for (int id : order) {
+        const duplicate_site_t &site = sites[id];
+        // e.g. double:120,list:3
+        string types;
+        for (size_t type = 0; type < site.types.size(); ++type) {
+            if (site.types[type] == 0)
+                continue;
+            types += (types.empty() ? "" : ",") + string(Rf_type2char(type)) +
+                     ":" + to_string(site.types[type]);
+        }
+        file.row(id, tree.get_node(site.node).name, tree.get_path(site.node),
+                 site.srcfile, site.line, site.column, site.copies,
+                 site.deep_copies, site.bytes, site.max_bytes, types);
+    }
+}
+
+void DuplicateProfiler::write_folded() const {
+    ofstream file(folded_filepath);
+    if (!file) {
+        cerr << "Error: could not open " << folded_filepath << "\n";
+        return;
+    }
+
+    for (size_t node = 0; node < tree.size(); ++node) {
+        uint64_t bytes = tree.get_node(node).data.bytes;
+        if (bytes > 0)
+            file << (node == 0 ? tree.get_node(0).name : tree.get_path(node))
+                 << " " << bytes << "\n";
+    }
+}
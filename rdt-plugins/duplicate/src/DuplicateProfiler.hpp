@@ -0,0 +1,82 @@
+#ifndef __DUPLICATE_PROFILER_HPP__
+#define __DUPLICATE_PROFILER_HPP__
+
+#include "CallingContextTree.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct duplicate_node_t {
+    uint64_t copies = 0;
+    uint64_t bytes = 0;
+};
+
+// Copies made in one calling context while evaluating one source reference.
+struct duplicate_site_t {
+    int node;
+    std::string srcfile;
+    int line;
+    int column;
+    uint64_t copies = 0;
+    uint64_t deep_copies = 0;
+    uint64_t bytes = 0;
+    uint64_t max_bytes = 0;
+    // copies by SEXPTYPE of the duplicated object, all of them are below 32
+    std::array<uint64_t, 32> types{};
+};
+
+// Ranks the places that call duplicate() and shallow_duplicate() by the
+// number of bytes copied. Copies made by builtins such as `[<-` show up
+// under the builtin in the calling context of the loop that triggers them.
+class DuplicateProfiler {
+  public:
+    DuplicateProfiler(const std::string &sites_filepath,
+                      const std::string &folded_filepath, bool verbose);
+
+    void begin();
+    void end();
+    void enter(SEXP call, SEXP op, SEXP rho);
+    void exit();
+    void unwind(SEXP rho);
+    void duplicate(SEXP object, bool deep, R_size_t bytes, SEXP srcref);
+
+  private:
+    // Keyed by the file name rather than the srcfile environment, whose
+    // address is reused once the collector frees it.
+    struct site_key_t {
+        int node;
+        std::string filename;
+        int line;
+        int column;
+
+        bool operator==(const site_key_t &other) const {
+            return node == other.node && filename == other.filename &&
+                   line == other.line && column == other.column;
+        }
+    };
+
+    struct site_key_hash_t {
+        size_t operator()(const site_key_t &key) const {
+            size_t hash = std::hash<std::string>()(key.filename);
+            hash = hash * 31 + key.node;
+            hash = hash * 31 + key.line;
+            return hash * 31 + key.column;
+        }
+    };
+
+    int get_site(int node, SEXP srcref);
+    void write_sites() const;
+    void write_folded() const;
+
+    std::string sites_filepath;
+    std::string folded_filepath;
+    bool verbose;
+
+    CallingContextTree<duplicate_node_t> tree;
+    std::vector<duplicate_site_t> sites;
+    std::unordered_map<site_key_t, int, site_key_hash_t> site_ids;
+};
+
+#endif /* __DUPLICATE_PROFILER_HPP__ */
@@ -0,0 +1,14 @@
+#include "probes.hpp"
+
+RDT_PROFILER_ACCESSOR(DuplicateProfiler)
+
+RDT_FORWARD_BEGIN_END_PROBES(profiler)
+
+RDT_FORWARD_CLOSURE_PROBES(profiler)
+
+RDT_FORWARD_BUILTIN_PROBES(profiler)
+
+void duplicate(dyntrace_context_t *context, SEXP object, SEXP copy, int deep,
+               R_size_t bytes, SEXP srcref) {
+    profiler(context).duplicate(object, deep, bytes, srcref);
+}
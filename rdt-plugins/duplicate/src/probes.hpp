@@ -0,0 +1,16 @@
+#ifndef __PROBES_HPP__
+#define __PROBES_HPP__
+
+#include "DuplicateProfiler.hpp"
+#include "probe_forwarding.hpp"
+
+RDT_DECLARE_BEGIN_END_PROBES();
+
+RDT_DECLARE_CLOSURE_PROBES();
+
+RDT_DECLARE_BUILTIN_PROBES();
+
+void duplicate(dyntrace_context_t *context, SEXP object, SEXP copy, int deep,
+               R_size_t bytes, SEXP srcref);
+
+#endif /* __PROBES_HPP__ */
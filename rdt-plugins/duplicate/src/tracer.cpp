@@ -0,0 +1,49 @@
+#include "tracer.hpp"
+
+DYNTRACE_PLUGIN_ABI;
+
+static DuplicateProfiler *create_duplicate_profiler(SEXP options) {
+    return new DuplicateProfiler(
+        sexp_to_string(get_named_list_element(options, "sites_filepath"),
+                       "duplicate_sites.tsv"),
+        sexp_to_string(get_named_list_element(options, "folded_filepath"),
+                       "duplicate.folded"),
+        sexp_to_bool(get_named_list_element(options, "verbose"), false));
+}
+
+SEXP create_dyntracer(SEXP options) {
+
+    // calloc initializes the memory to zero. This ensures that probes not
+    // attached will point to NULL.
+    dyntracer_t *dyntracer = (dyntracer_t *)calloc(1, sizeof(dyntracer_t));
+
+    dyntracer->probe_begin = begin;
+    dyntracer->probe_end = end;
+    dyntracer->probe_function_entry = function_entry;
+    dyntracer->probe_function_exit = function_exit;
+    // Without the builtin and special probes, copies made by builtins such as
+    // `[<-` are attributed to the calling closure.
+    if (sexp_to_bool(get_named_list_element(options, "include_builtins"),
+                     true)) {
+        dyntracer->probe_builtin_entry = builtin_entry;
+        dyntracer->probe_builtin_exit = builtin_exit;
+        dyntracer->probe_specialsxp_entry = builtin_entry;
+        dyntracer->probe_specialsxp_exit = builtin_exit;
+    }
+    dyntracer->probe_jump_ctxt = jump_ctxt;
+    dyntracer->probe_duplicate = duplicate;
+    // The probes only use the helpers of Rdyntrace.h and C++ containers.
+    dyntracer->non_allocating = 1;
+    dyntracer->context = create_duplicate_profiler(options);
+
+    return dyntracer_to_sexp(dyntracer, "dyntracer.duplicate");
+}
+
+static void destroy_duplicate_dyntracer(dyntracer_t *dyntracer) {
+    delete static_cast<DuplicateProfiler *>(dyntracer->context);
+    free(dyntracer);
+}
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp, destroy_duplicate_dyntracer);
+}
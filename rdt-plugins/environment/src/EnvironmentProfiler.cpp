@@ -0,0 +1,191 @@
+#include "EnvironmentProfiler.hpp"
+#include "TsvWriter.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+// Environment kinds known upfront. The global cache does not say where the
+// binding it returns lives.
+static const int GLOBAL_CACHE = 0;
+static const int LOCAL = 1;
+
+EnvironmentProfiler::EnvironmentProfiler(const std::string &lookups_filepath,
+                                         const std::string &writes_filepath,
+                                         bool verbose)
+    : lookups_filepath(lookups_filepath), writes_filepath(writes_filepath),
+      verbose(verbose) {}
+
+void EnvironmentProfiler::begin() {
+    tree = CallingContextTree<environment_node_t>();
+    functions.assign(1, "<top level>");
+    function_ids.clear();
+    environment_kinds.clear();
+    environment_kind_ids.clear();
+    intern_environment_kind("<global cache>");
+    intern_environment_kind("local");
+    environment_kind_cache.clear();
+    lookups.clear();
+    writes.clear();
+}
+
+void EnvironmentProfiler::end() {
+    if (!lookups_filepath.empty())
+        write_lookups();
+    if (!writes_filepath.empty())
+        write_writes();
+
+    if (verbose) {
+        uint64_t total = 0, hits = 0, misses = 0, searched = 0;
+        for (auto const &entry : lookups) {
+            total += entry.second;
+            searched += entry.second * (entry.first.depth + 1);
+            if (entry.first.global_cache == DYNTRACE_GLOBAL_CACHE_HIT)
+                hits += entry.second;
+            else if (entry.first.global_cache == DYNTRACE_GLOBAL_CACHE_MISS)
+                misses += entry.second;
+        }
+        cerr << "Lookups: " << total << ", " << searched
+             << " environments searched, global cache " << hits << " hits "
+             << misses << " misses\n";
+    }
+}
+
+void EnvironmentProfiler::enter(SEXP call, SEXP op, SEXP rho) {
+    tree.enter(call, op, rho);
+}
+
+void EnvironmentProfiler::exit() { tree.exit(); }
+
+void EnvironmentProfiler::unwind(SEXP rho) {
+    tree.unwind(rho, [](int node) {});
+}
+
+void EnvironmentProfiler::lookup(SEXP symbol, SEXP rho, int depth,
+                                 int global_cache) {
+    int environment = global_cache == DYNTRACE_GLOBAL_CACHE_HIT
+                          ? GLOBAL_CACHE
+                          : get_environment_kind(rho);
+    lookups[{symbol, get_function(), environment, depth, global_cache}]++;
+}
+
+void EnvironmentProfiler::define(SEXP symbol, SEXP rho) {
+    writes[{symbol, get_environment_kind(rho)}].defines++;
+}
+
+void EnvironmentProfiler::assign(SEXP symbol, SEXP rho) {
+    writes[{symbol, get_environment_kind(rho)}].assigns++;
+}
+
+void EnvironmentProfiler::remove(SEXP symbol, SEXP rho) {
+    writes[{symbol, get_environment_kind(rho)}].removes++;
+}
+
+void EnvironmentProfiler::collect() { environment_kind_cache.clear(); }
+
+int EnvironmentProfiler::get_function() {
+    int node = tree.get_current();
+    if (node == 0)
+        return 0;
+
+    auto &entry = tree.get_node(node);
+    if (entry.data.function == -1) {
+        auto iterator = function_ids.find(entry.key);
+        if (iterator == function_ids.end()) {
+            iterator = function_ids.emplace(entry.key, functions.size()).first;
+            functions.push_back(entry.name);
+        }
+        entry.data.function = iterator->second;
+    }
+    return entry.data.function;
+}
+
+int EnvironmentProfiler::get_environment_kind(SEXP rho) {
+    auto iterator = environment_kind_cache.find(rho);
+    if (iterator != environment_kind_cache.end())
+        return iterator->second;
+
+    int kind = LOCAL;
+    if (rho == R_GlobalEnv)
+        kind = intern_environment_kind("global");
+    else if (rho == R_BaseEnv)
+        kind = intern_environment_kind("base");
+    else if (rho == R_BaseNamespace)
+        kind = intern_environment_kind("namespace:base");
+    else if (R_IsNamespaceEnv(rho))
+        kind = intern_environment_kind(string("namespace:") +
+                                       dyntrace_get_namespace_name(rho));
+    else {
+        // Not R_IsPackageEnv, getAttrib returns R_NilValue in probes.
+        SEXP name = dyntrace_get_attribute(rho, R_NameSymbol);
+        if (TYPEOF(name) == STRSXP && XLENGTH(name) > 0 &&
+            strncmp(CHAR(STRING_ELT(name, 0)), "package:", 8) == 0)
+            kind = intern_environment_kind(CHAR(STRING_ELT(name, 0)));
+    }
+
+    environment_kind_cache.emplace(rho, kind);
+    return kind;
+}
+
+int EnvironmentProfiler::intern_environment_kind(const std::string &kind) {
+    auto iterator = environment_kind_ids.find(kind);
+    if (iterator != environment_kind_ids.end())
+        return iterator->second;
+    environment_kinds.push_back(kind);
+    environment_kind_ids.emplace(kind, environment_kinds.size() - 1);
+    return environment_kinds.size() - 1;
+}
+
+static const char *symbol_name(SEXP symbol) {
+    return TYPEOF(symbol) == SYMSXP ? CHAR(PRINTNAME(symbol)) : "<unknown>";
+}
+
+static const char *global_cache_to_string(int global_cache) {
+    switch (global_cache) {
+        case DYNTRACE_GLOBAL_CACHE_HIT:
+            return "hit";
+        case DYNTRACE_GLOBAL_CACHE_MISS:
+            return "miss";
+        default:
+            return "unused";
+    }
+}
+
+void EnvironmentProfiler::write_lookups() const {
+    TsvWriter file(lookups_filepath,
+                   {"symbol", "function", "environment", "depth",
+                    "global_cache", "lookups", "environments_searched"});
+    if (!file.is_open())
+        return;
+
+    // Environments searched is what a local copy of the variable would save,
+    // so it comes first.
+    typedef pair<lookup_key_t, uint64_t> row_t;
+    vector<row_t> rows(lookups.begin(), lookups.end());
+    auto searched = [](const row_t &row) {
+        return row.second * (row.first.depth + 1);
+    };
+    sort(rows.begin(), rows.end(), [&searched](const row_t &a, const row_t &b) {
+        return searched(a) > searched(b);
+    });
+
+    for (auto const &row : rows)
+        file.row(symbol_name(row.first.symbol), functions[row.first.function],
+                 environment_kinds[row.first.environment], row.first.depth,
+                 global_cache_to_string(row.first.global_cache), row.second,
+                 searched(row));
+}
+
+void EnvironmentProfiler::write_writes() const {
+    TsvWriter file(writes_filepath, {"symbol", "environment", "defines",
+                                     "assigns", "removes"});
+    if (!file.is_open())
+        return;
+
+    for (auto const &entry : writes)
+        file.row(symbol_name(entry.first.symbol),
+                 environment_kinds[entry.first.environment],
+                 entry.second.defines, entry.second.assigns,
+                 entry.second.removes);
+}
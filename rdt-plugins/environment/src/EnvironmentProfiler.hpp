@@ -0,0 +1,105 @@
+#ifndef __ENVIRONMENT_PROFILER_HPP__
+#define __ENVIRONMENT_PROFILER_HPP__
+
+#include "CallingContextTree.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct environment_node_t {
+    int function = -1; // index in EnvironmentProfiler::functions
+};
+
+struct lookup_key_t {
+    SEXP symbol;
+    int function;    // closure doing the lookup
+    int environment; // kind of the environment holding the binding
+    int depth;
+    int global_cache; // DYNTRACE_GLOBAL_CACHE_*
+
+    bool operator==(const lookup_key_t &other) const {
+        return symbol == other.symbol && function == other.function &&
+               environment == other.environment && depth == other.depth &&
+               global_cache == other.global_cache;
+    }
+};
+
+struct lookup_key_hash_t {
+    size_t operator()(const lookup_key_t &key) const {
+        size_t hash = std::hash<const void *>()(key.symbol);
+        hash = hash * 31 + key.function;
+        hash = hash * 31 + key.environment;
+        hash = hash * 31 + key.depth;
+        return hash * 31 + key.global_cache;
+    }
+};
+
+struct write_key_t {
+    SEXP symbol;
+    int environment;
+
+    bool operator==(const write_key_t &other) const {
+        return symbol == other.symbol && environment == other.environment;
+    }
+};
+
+struct write_key_hash_t {
+    size_t operator()(const write_key_t &key) const {
+        return std::hash<const void *>()(key.symbol) * 31 + key.environment;
+    }
+};
+
+struct write_counts_t {
+    uint64_t defines = 0;
+    uint64_t assigns = 0;
+    uint64_t removes = 0;
+};
+
+// Aggregates variable lookups reported by findVar per symbol, calling
+// closure, kind of environment holding the binding (global, package:x,
+// namespace:x, local...), number of environments searched and global cache
+// outcome. Definitions, assignments and removals are counted per symbol and
+// environment kind.
+class EnvironmentProfiler {
+  public:
+    EnvironmentProfiler(const std::string &lookups_filepath,
+                        const std::string &writes_filepath, bool verbose);
+
+    void begin();
+    void end();
+    void enter(SEXP call, SEXP op, SEXP rho);
+    void exit();
+    void unwind(SEXP rho);
+    void lookup(SEXP symbol, SEXP rho, int depth, int global_cache);
+    void define(SEXP symbol, SEXP rho);
+    void assign(SEXP symbol, SEXP rho);
+    void remove(SEXP symbol, SEXP rho);
+    void collect();
+
+  private:
+    int get_function();
+    int get_environment_kind(SEXP rho);
+    int intern_environment_kind(const std::string &kind);
+    void write_lookups() const;
+    void write_writes() const;
+
+    std::string lookups_filepath;
+    std::string writes_filepath;
+    bool verbose;
+
+    CallingContextTree<environment_node_t> tree;
+    std::vector<std::string> functions;
+    std::unordered_map<cct_key_t, int> function_ids;
+
+    std::vector<std::string> environment_kinds;
+    std::unordered_map<std::string, int> environment_kind_ids;
+    // Cleared at every collection, environments can be freed and their
+    // address reused.
+    std::unordered_map<SEXP, int> environment_kind_cache;
+
+    std::unordered_map<lookup_key_t, uint64_t, lookup_key_hash_t> lookups;
+    std::unordered_map<write_key_t, write_counts_t, write_key_hash_t> writes;
+};
+
+#endif /* __ENVIRONMENT_PROFILER_HPP__ */
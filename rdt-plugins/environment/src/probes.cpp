@@ -0,0 +1,32 @@
+#include "probes.hpp"
+
+RDT_PROFILER_ACCESSOR(EnvironmentProfiler)
+
+RDT_FORWARD_BEGIN_END_PROBES(profiler)
+
+RDT_FORWARD_CLOSURE_PROBES(profiler)
+
+void environment_lookup_var(dyntrace_context_t *context, SEXP symbol,
+                            SEXP value, SEXP rho, int depth,
+                            int global_cache) {
+    profiler(context).lookup(symbol, rho, depth, global_cache);
+}
+
+void environment_define_var(dyntrace_context_t *context, SEXP symbol,
+                            SEXP value, SEXP rho) {
+    profiler(context).define(symbol, rho);
+}
+
+void environment_assign_var(dyntrace_context_t *context, SEXP symbol,
+                            SEXP value, SEXP rho) {
+    profiler(context).assign(symbol, rho);
+}
+
+void environment_remove_var(dyntrace_context_t *context, SEXP symbol,
+                            SEXP rho) {
+    profiler(context).remove(symbol, rho);
+}
+
+void gc_entry(dyntrace_context_t *context, R_size_t size_needed) {
+    profiler(context).collect();
+}
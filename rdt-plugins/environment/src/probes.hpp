@@ -0,0 +1,25 @@
+#ifndef __PROBES_HPP__
+#define __PROBES_HPP__
+
+#include "EnvironmentProfiler.hpp"
+#include "probe_forwarding.hpp"
+
+RDT_DECLARE_BEGIN_END_PROBES();
+
+RDT_DECLARE_CLOSURE_PROBES();
+
+void environment_lookup_var(dyntrace_context_t *context, SEXP symbol,
+                            SEXP value, SEXP rho, int depth, int global_cache);
+
+void environment_define_var(dyntrace_context_t *context, SEXP symbol,
+                            SEXP value, SEXP rho);
+
+void environment_assign_var(dyntrace_context_t *context, SEXP symbol,
+                            SEXP value, SEXP rho);
+
+void environment_remove_var(dyntrace_context_t *context, SEXP symbol,
+                            SEXP rho);
+
+void gc_entry(dyntrace_context_t *context, R_size_t size_needed);
+
+#endif /* __PROBES_HPP__ */
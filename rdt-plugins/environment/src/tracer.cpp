@@ -0,0 +1,47 @@
+#include "tracer.hpp"
+
+DYNTRACE_PLUGIN_ABI;
+
+static EnvironmentProfiler *create_environment_profiler(SEXP options) {
+    return new EnvironmentProfiler(
+        sexp_to_string(get_named_list_element(options, "lookups_filepath"),
+                       "environment_lookups.tsv"),
+        sexp_to_string(get_named_list_element(options, "writes_filepath"),
+                       "environment_writes.tsv"),
+        sexp_to_bool(get_named_list_element(options, "verbose"), false));
+}
+
+SEXP create_dyntracer(SEXP options) {
+
+    // calloc initializes the memory to zero. This ensures that probes not
+    // attached will point to NULL.
+    dyntracer_t *dyntracer = (dyntracer_t *)calloc(1, sizeof(dyntracer_t));
+
+    dyntracer->probe_begin = begin;
+    dyntracer->probe_end = end;
+    // Only closures are tracked, lookups are attributed to the closure whose
+    // code runs them.
+    dyntracer->probe_function_entry = function_entry;
+    dyntracer->probe_function_exit = function_exit;
+    dyntracer->probe_jump_ctxt = jump_ctxt;
+    dyntracer->probe_environment_lookup_var = environment_lookup_var;
+    dyntracer->probe_environment_define_var = environment_define_var;
+    dyntracer->probe_environment_assign_var = environment_assign_var;
+    dyntracer->probe_environment_remove_var = environment_remove_var;
+    dyntracer->probe_gc_entry = gc_entry;
+    // The probes only use the helpers of Rdyntrace.h and C++ containers.
+    dyntracer->non_allocating = 1;
+    dyntracer->context = create_environment_profiler(options);
+
+    return dyntracer_to_sexp(dyntracer, "dyntracer.environment");
+}
+
+static void destroy_environment_dyntracer(dyntracer_t *dyntracer) {
+    delete static_cast<EnvironmentProfiler *>(dyntracer->context);
+    free(dyntracer);
+}
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp,
+                                  destroy_environment_dyntracer);
+}
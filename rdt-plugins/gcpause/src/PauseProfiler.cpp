@@ -0,0 +1,168 @@
+#include "PauseProfiler.hpp"
+#include "TsvWriter.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+void PauseHistogram::add(double seconds) {
+    uint64_t microseconds = seconds * 1e6;
+    size_t bucket =
+        microseconds == 0 ? 0 : 64 - __builtin_clzll(microseconds);
+    if (counts.size() <= bucket) {
+        counts.resize(bucket + 1);
+        times.resize(bucket + 1);
+    }
+    counts[bucket]++;
+    times[bucket] += seconds;
+}
+
+PauseProfiler::PauseProfiler(const std::string &pauses_filepath,
+                             const std::string &histogram_filepath,
+                             const std::string &frames_filepath,
+                             const std::string &folded_filepath, bool verbose)
+    : pauses_filepath(pauses_filepath), histogram_filepath(histogram_filepath),
+      frames_filepath(frames_filepath), folded_filepath(folded_filepath),
+      verbose(verbose) {}
+
+void PauseProfiler::begin() {
+    tree = CallingContextTree<pause_node_t>();
+    trigger_node = 0;
+    pauses.clear();
+    histograms.clear();
+}
+
+void PauseProfiler::end() {
+    if (!pauses_filepath.empty())
+        write_pauses();
+    if (!histogram_filepath.empty())
+        write_histogram();
+    if (!frames_filepath.empty())
+        write_frames();
+    if (!folded_filepath.empty())
+        write_folded();
+
+    if (verbose) {
+        double total = 0;
+        for (auto const &pause : pauses)
+            total += pause.wall_time;
+        cerr << "GC pauses: " << pauses.size() << " collections, " << total
+             << "s\n";
+    }
+}
+
+void PauseProfiler::enter(SEXP call, SEXP op, SEXP rho) {
+    tree.enter(call, op, rho);
+}
+
+void PauseProfiler::exit() { tree.exit(); }
+
+void PauseProfiler::unwind(SEXP rho) { tree.unwind(rho, [](int node) {}); }
+
+void PauseProfiler::collect_begin() { trigger_node = tree.get_current(); }
+
+void PauseProfiler::collect_end(const dyntrace_gc_info_t &info) {
+    pause_t pause;
+    pause.gc_count = info.gc_count;
+    pause.generation = info.generation;
+    pause.node = trigger_node;
+    pause.size_needed = info.size_needed;
+    pause.wall_time = info.wall_time;
+    pause.reclaimed_nodes = 0;
+    pause.reclaimed_bytes = 0;
+    for (int i = 0; i < DYNTRACE_GC_NODE_CLASSES; ++i) {
+        pause.reclaimed_nodes += info.reclaimed_nodes[i];
+        pause.reclaimed_bytes += info.reclaimed_bytes[i];
+    }
+    pause.large_vectors = info.reclaimed_nodes[DYNTRACE_GC_NODE_CLASSES - 1];
+    pause.large_bytes = info.reclaimed_bytes[DYNTRACE_GC_NODE_CLASSES - 1];
+    pause.pages_released = info.pages_released;
+    pauses.push_back(pause);
+
+    if (histograms.size() <= static_cast<size_t>(info.generation))
+        histograms.resize(info.generation + 1);
+    histograms[info.generation].add(info.wall_time);
+
+    pause_node_t &data = tree.get_node(trigger_node).data;
+    data.pauses++;
+    if (info.generation == 2)
+        data.full_collections++;
+    data.pause_time += info.wall_time;
+    data.max_pause_time = max(data.max_pause_time, info.wall_time);
+}
+
+void PauseProfiler::write_pauses() const {
+    TsvWriter file(pauses_filepath,
+                   {"gc", "generation", "wall_ms", "size_needed",
+                    "reclaimed_nodes", "reclaimed_bytes", "large_vectors",
+                    "large_bytes", "pages_released", "function", "context"});
+    if (!file.is_open())
+        return;
+
+    for (auto const &pause : pauses)
+        file.row(pause.gc_count, pause.generation, pause.wall_time * 1e3,
+                 pause.size_needed, pause.reclaimed_nodes,
+                 pause.reclaimed_bytes, pause.large_vectors, pause.large_bytes,
+                 pause.pages_released, tree.get_node(pause.node).name,
+                 tree.get_path(pause.node));
+}
+
+void PauseProfiler::write_histogram() const {
+    TsvWriter file(histogram_filepath,
+                   {"generation", "min_us", "max_us", "count", "total_ms"});
+    if (!file.is_open())
+        return;
+
+    // Bucket 0 holds pauses under a microsecond, bucket k > 0 the pauses of
+    // [2^(k-1), 2^k) microseconds.
+    for (size_t generation = 0; generation < histograms.size(); ++generation) {
+        const PauseHistogram &histogram = histograms[generation];
+        for (size_t bucket = 0; bucket < histogram.size(); ++bucket) {
+            if (histogram.get_count(bucket) == 0)
+                continue;
+            uint64_t min_us = bucket == 0 ? 0 : uint64_t(1) << (bucket - 1);
+            uint64_t max_us = uint64_t(1) << bucket;
+            file.row(generation, min_us, max_us, histogram.get_count(bucket),
+                     histogram.get_time(bucket) * 1e3);
+        }
+    }
+}
+
+void PauseProfiler::write_frames() const {
+    TsvWriter file(frames_filepath, {"function", "context", "pauses",
+                                     "full_collections", "total_ms", "max_ms"});
+    if (!file.is_open())
+        return;
+
+    vector<int> nodes;
+    for (size_t node = 0; node < tree.size(); ++node)
+        if (tree.get_node(node).data.pauses > 0)
+            nodes.push_back(node);
+    sort(nodes.begin(), nodes.end(), [this](int a, int b) {
+        return tree.get_node(a).data.pause_time >
+               tree.get_node(b).data.pause_time;
+    });
+
+    for (int node : nodes) {
+        const pause_node_t &data = tree.get_node(node).data;
+        file.row(tree.get_node(node).name, tree.get_path(node), data.pauses,
+                 data.full_collections, data.pause_time * 1e3,
+                 data.max_pause_time * 1e3);
+    }
+}
+
+void PauseProfiler::write_folded() const {
+    ofstream file(folded_filepath);
+    if (!file) {
+        cerr << "Error: could not open " << folded_filepath << "\n";
+        return;
+    }
+
+    for (size_t node = 0; node < tree.size(); ++node) {
+        uint64_t microseconds = tree.get_node(node).data.pause_time * 1e6;
+        if (microseconds > 0)
+            file << (node == 0 ? tree.get_node(0).name : tree.get_path(node))
+                 << " " << microseconds << "\n";
+    }
+}
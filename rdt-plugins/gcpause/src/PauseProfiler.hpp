@@ -0,0 +1,79 @@
+#ifndef __PAUSE_PROFILER_HPP__
+#define __PAUSE_PROFILER_HPP__
+
+#include "CallingContextTree.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct pause_node_t {
+    uint64_t pauses = 0;
+    uint64_t full_collections = 0;
+    double pause_time = 0; // seconds
+    double max_pause_time = 0;
+};
+
+struct pause_t {
+    int gc_count;
+    int generation;
+    int node; // calling context that triggered the collection
+    R_size_t size_needed;
+    double wall_time;
+    R_size_t reclaimed_nodes;
+    R_size_t reclaimed_bytes;
+    R_size_t large_vectors;
+    R_size_t large_bytes;
+    R_size_t pages_released;
+};
+
+// Pause times bucketed by powers of two of microseconds, one histogram per
+// generation collected.
+class PauseHistogram {
+  public:
+    void add(double seconds);
+    size_t size() const { return counts.size(); }
+    uint64_t get_count(size_t bucket) const { return counts[bucket]; }
+    double get_time(size_t bucket) const { return times[bucket]; }
+
+  private:
+    std::vector<uint64_t> counts;
+    std::vector<double> times;
+};
+
+// Records every collection with the calling context that triggered it. The
+// pause durations come from the collector (dyntrace_gc_info_t) and do not
+// include the tracer overhead.
+class PauseProfiler {
+  public:
+    PauseProfiler(const std::string &pauses_filepath,
+                  const std::string &histogram_filepath,
+                  const std::string &frames_filepath,
+                  const std::string &folded_filepath, bool verbose);
+
+    void begin();
+    void end();
+    void enter(SEXP call, SEXP op, SEXP rho);
+    void exit();
+    void unwind(SEXP rho);
+    void collect_begin();
+    void collect_end(const dyntrace_gc_info_t &info);
+
+  private:
+    void write_pauses() const;
+    void write_histogram() const;
+    void write_frames() const;
+    void write_folded() const;
+
+    std::string pauses_filepath;
+    std::string histogram_filepath;
+    std::string frames_filepath;
+    std::string folded_filepath;
+    bool verbose;
+
+    CallingContextTree<pause_node_t> tree;
+    int trigger_node = 0;
+    std::vector<pause_t> pauses;
+    std::vector<PauseHistogram> histograms;
+};
+
+#endif /* __PAUSE_PROFILER_HPP__ */
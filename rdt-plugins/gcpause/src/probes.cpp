@@ -0,0 +1,18 @@
+#include "probes.hpp"
+
+RDT_PROFILER_ACCESSOR(PauseProfiler)
+
+RDT_FORWARD_BEGIN_END_PROBES(profiler)
+
+RDT_FORWARD_CLOSURE_PROBES(profiler)
+
+RDT_FORWARD_BUILTIN_PROBES(profiler)
+
+void gc_entry(dyntrace_context_t *context, R_size_t size_needed) {
+    profiler(context).collect_begin();
+}
+
+void gc_exit(dyntrace_context_t *context, int gc_count, double vcells,
+             double ncells, const dyntrace_gc_info_t *info) {
+    profiler(context).collect_end(*info);
+}
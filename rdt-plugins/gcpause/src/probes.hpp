@@ -0,0 +1,18 @@
+#ifndef __PROBES_HPP__
+#define __PROBES_HPP__
+
+#include "PauseProfiler.hpp"
+#include "probe_forwarding.hpp"
+
+RDT_DECLARE_BEGIN_END_PROBES();
+
+RDT_DECLARE_CLOSURE_PROBES();
+
+RDT_DECLARE_BUILTIN_PROBES();
+
+void gc_entry(dyntrace_context_t *context, R_size_t size_needed);
+
+void gc_exit(dyntrace_context_t *context, int gc_count, double vcells,
+             double ncells, const dyntrace_gc_info_t *info);
+
+#endif /* __PROBES_HPP__ */
@@ -0,0 +1,54 @@
+#include "tracer.hpp"
+
+DYNTRACE_PLUGIN_ABI;
+
+static PauseProfiler *create_pause_profiler(SEXP options) {
+    return new PauseProfiler(
+        sexp_to_string(get_named_list_element(options, "pauses_filepath"),
+                       "gc_pauses.tsv"),
+        sexp_to_string(get_named_list_element(options, "histogram_filepath"),
+                       "gc_pause_histogram.tsv"),
+        sexp_to_string(get_named_list_element(options, "frames_filepath"),
+                       "gc_pause_frames.tsv"),
+        sexp_to_string(get_named_list_element(options, "folded_filepath"),
+                       "gc_pauses.folded"),
+        sexp_to_bool(get_named_list_element(options, "verbose"), false));
+}
+
+SEXP create_dyntracer(SEXP options) {
+
+    // calloc initializes the memory to zero. This ensures that probes not
+    // attached will point to NULL.
+    dyntracer_t *dyntracer = (dyntracer_t *)calloc(1, sizeof(dyntracer_t));
+
+    dyntracer->probe_begin = begin;
+    dyntracer->probe_end = end;
+    dyntracer->probe_function_entry = function_entry;
+    dyntracer->probe_function_exit = function_exit;
+    // Without the builtin and special probes, collections triggered by
+    // builtins are attributed to the calling closure.
+    if (sexp_to_bool(get_named_list_element(options, "include_builtins"),
+                     true)) {
+        dyntracer->probe_builtin_entry = builtin_entry;
+        dyntracer->probe_builtin_exit = builtin_exit;
+        dyntracer->probe_specialsxp_entry = builtin_entry;
+        dyntracer->probe_specialsxp_exit = builtin_exit;
+    }
+    dyntracer->probe_jump_ctxt = jump_ctxt;
+    dyntracer->probe_gc_entry = gc_entry;
+    dyntracer->probe_gc_exit = gc_exit;
+    // The probes only read the collector state.
+    dyntracer->non_allocating = 1;
+    dyntracer->context = create_pause_profiler(options);
+
+    return dyntracer_to_sexp(dyntracer, "dyntracer.gcpause");
+}
+
+static void destroy_gcpause_dyntracer(dyntracer_t *dyntracer) {
+    delete static_cast<PauseProfiler *>(dyntracer->context);
+    free(dyntracer);
+}
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp, destroy_gcpause_dyntracer);
+}
@@ -0,0 +1,166 @@
+#include "JitProfiler.hpp"
+#include "TsvWriter.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+// Packages known upfront.
+static const int GLOBAL = 0;
+static const int OTHER = 1;
+
+JitProfiler::JitProfiler(const std::string &functions_filepath,
+                         const std::string &packages_filepath,
+                         int max_executions, bool verbose)
+    : functions_filepath(functions_filepath),
+      packages_filepath(packages_filepath), max_executions(max_executions),
+      verbose(verbose) {}
+
+void JitProfiler::begin() {
+    compilations.clear();
+    compiled.clear();
+    packages.clear();
+    package_ids.clear();
+    intern_package("<global>");
+    intern_package("<other>");
+}
+
+void JitProfiler::end(clock_t jit_compile_time) {
+    if (!functions_filepath.empty())
+        write_functions();
+    if (!packages_filepath.empty())
+        write_packages();
+
+    if (verbose) {
+        uint64_t compile_time = 0, rare = 0;
+        for (auto const &compilation : compilations) {
+            compile_time += compilation.compile_time;
+            if (compilation.executions <= (uint64_t)max_executions)
+                rare++;
+        }
+        double cpu_time = 1000.0 * jit_compile_time / CLOCKS_PER_SEC;
+        cerr << "JIT: " << compilations.size() << " compilations, "
+             << compile_time / 1e6 << "ms (" << cpu_time
+             << "ms cpu without probes), " << rare << " rarely executed\n";
+    }
+}
+
+void JitProfiler::compile_entry(SEXP call, SEXP op, int body_size) {
+    pending.name = get_call_name(call, op);
+    pending.package = get_package(CLOENV(op));
+    pending.body_size = body_size;
+}
+
+void JitProfiler::compile_exit(SEXP op, int outcome, uint64_t compile_time) {
+    pending.outcome = outcome;
+    pending.compile_time = compile_time;
+    compilations.push_back(pending);
+    if (outcome != DYNTRACE_JIT_NOT_COMPILED)
+        compiled[op] = {(int)compilations.size() - 1, BODY(op)};
+}
+
+void JitProfiler::enter(SEXP op) {
+    auto iterator = compiled.find(op);
+    if (iterator != compiled.end() && iterator->second.second == BODY(op))
+        compilations[iterator->second.first].executions++;
+}
+
+// The namespace the closure was defined in, <global> for closures defined
+// at top level or in functions called from there.
+int JitProfiler::get_package(SEXP rho) {
+    const char *package = dyntrace_get_namespace_name(rho);
+    if (package != nullptr)
+        return intern_package(package);
+    for (; rho != R_EmptyEnv; rho = ENCLOS(rho))
+        if (rho == R_GlobalEnv)
+            return GLOBAL;
+    return OTHER;
+}
+
+int JitProfiler::intern_package(const std::string &package) {
+    auto iterator = package_ids.find(package);
+    if (iterator != package_ids.end())
+        return iterator->second;
+    packages.push_back(package);
+    package_ids.emplace(package, packages.size() - 1);
+    return packages.size() - 1;
+}
+
+static const char *outcome_to_string(int outcome) {
+    switch (outcome) {
+        case DYNTRACE_JIT_COMPILED:
+            return "compiled";
+        case DYNTRACE_JIT_CACHED:
+            return "cached";
+        default:
+            return "not_compiled";
+    }
+}
+
+void JitProfiler::write_functions() const {
+    TsvWriter file(functions_filepath,
+                   {"function", "package", "outcome", "body_size", "compile_ms",
+                    "executions", "rarely_executed"});
+    if (!file.is_open())
+        return;
+
+    vector<const compilation_t *> rows;
+    for (auto const &compilation : compilations)
+        rows.push_back(&compilation);
+    sort(rows.begin(), rows.end(),
+         [](const compilation_t *a, const compilation_t *b) {
+             return a->compile_time > b->compile_time;
+         });
+
+    for (auto const row : rows)
+        file.row(row->name, packages[row->package],
+                 outcome_to_string(row->outcome), row->body_size,
+                 row->compile_time / 1e6, row->executions,
+                 row->executions <= (uint64_t)max_executions ? "yes" : "no");
+}
+
+void JitProfiler::write_packages() const {
+    struct summary_t {
+        uint64_t outcomes[3] = {0, 0, 0};
+        uint64_t compile_time = 0;
+        uint64_t executions = 0;
+        uint64_t rare = 0;
+        uint64_t rare_compile_time = 0;
+    };
+
+    vector<summary_t> summaries(packages.size());
+    for (auto const &compilation : compilations) {
+        summary_t &summary = summaries[compilation.package];
+        summary.outcomes[compilation.outcome]++;
+        summary.compile_time += compilation.compile_time;
+        summary.executions += compilation.executions;
+        if (compilation.executions <= (uint64_t)max_executions) {
+            summary.rare++;
+            summary.rare_compile_time += compilation.compile_time;
+        }
+    }
+
+    vector<int> rows;
+    for (size_t package = 0; package < packages.size(); ++package)
+        if (summaries[package].compile_time > 0)
+            rows.push_back(package);
+    sort(rows.begin(), rows.end(), [&summaries](int a, int b) {
+        return summaries[a].compile_time > summaries[b].compile_time;
+    });
+
+    TsvWriter file(packages_filepath,
+                   {"package", "compiled", "cached", "not_compiled",
+                    "compile_ms", "executions", "rarely_executed",
+                    "rarely_executed_ms"});
+    if (!file.is_open())
+        return;
+
+    for (int package : rows) {
+        const summary_t &summary = summaries[package];
+        file.row(packages[package], summary.outcomes[DYNTRACE_JIT_COMPILED],
+                 summary.outcomes[DYNTRACE_JIT_CACHED],
+                 summary.outcomes[DYNTRACE_JIT_NOT_COMPILED],
+                 summary.compile_time / 1e6, summary.executions, summary.rare,
+                 summary.rare_compile_time / 1e6);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef __JIT_PROFILER_HPP__
+#define __JIT_PROFILER_HPP__
+
+#include "utilities.hpp"
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct compilation_t {
+    std::string name;
+    int package; // index in JitProfiler::packages
+    int body_size;
+    int outcome; // DYNTRACE_JIT_*
+    uint64_t compile_time;
+    // Executions of the compiled body, including the call that triggered the
+    // compilation.
+    uint64_t executions = 0;
+};
+
+// Records the closures compiled by the JIT, how long the compiler took and
+// how many times the compiled code ran afterwards. Reports the compilations
+// and their totals per package; closures executed at most max_executions
+// times after being compiled are counted as rarely executed, their
+// compilation hardly paid off.
+class JitProfiler {
+  public:
+    JitProfiler(const std::string &functions_filepath,
+                const std::string &packages_filepath, int max_executions,
+                bool verbose);
+
+    void begin();
+    void end(clock_t jit_compile_time);
+    void compile_entry(SEXP call, SEXP op, int body_size);
+    void compile_exit(SEXP op, int outcome, uint64_t compile_time);
+    void enter(SEXP op);
+
+  private:
+    int get_package(SEXP rho);
+    int intern_package(const std::string &package);
+    void write_functions() const;
+    void write_packages() const;
+
+    std::string functions_filepath;
+    std::string packages_filepath;
+    int max_executions;
+    bool verbose;
+
+    std::vector<compilation_t> compilations;
+    // The compilation of the closure at this address and its compiled body.
+    // Closures can be collected and their address reused, executions are only
+    // counted while the body is still the one compiled.
+    std::unordered_map<SEXP, std::pair<int, SEXP>> compiled;
+    // Filled at compile entry, the JIT does not compile recursively.
+    compilation_t pending;
+
+    std::vector<std::string> packages;
+    std::unordered_map<std::string, int> package_ids;
+};
+
+#endif /* __JIT_PROFILER_HPP__ */
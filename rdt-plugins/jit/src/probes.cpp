@@ -0,0 +1,27 @@
+#include "probes.hpp"
+
+RDT_PROFILER_ACCESSOR(JitProfiler)
+
+void begin(dyntrace_context_t *context, const SEXP prom) {
+    profiler(context).begin();
+}
+
+void end(dyntrace_context_t *context) {
+    profiler(context).end(
+        context->dyntracing_context->execution_time.jit_compile);
+}
+
+void function_entry(dyntrace_context_t *context, const SEXP call,
+                    const SEXP op, const SEXP rho) {
+    profiler(context).enter(op);
+}
+
+void jit_compile_entry(dyntrace_context_t *context, const SEXP call,
+                       const SEXP op, int body_size) {
+    profiler(context).compile_entry(call, op, body_size);
+}
+
+void jit_compile_exit(dyntrace_context_t *context, const SEXP call,
+                      const SEXP op, int outcome, uint64_t compile_time) {
+    profiler(context).compile_exit(op, outcome, compile_time);
+}
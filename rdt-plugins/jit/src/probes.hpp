@@ -0,0 +1,20 @@
+#ifndef __PROBES_HPP__
+#define __PROBES_HPP__
+
+#include "JitProfiler.hpp"
+#include "probe_forwarding.hpp"
+
+void begin(dyntrace_context_t *context, const SEXP prom);
+
+void end(dyntrace_context_t *context);
+
+void function_entry(dyntrace_context_t *context, const SEXP call,
+                    const SEXP op, const SEXP rho);
+
+void jit_compile_entry(dyntrace_context_t *context, const SEXP call,
+                       const SEXP op, int body_size);
+
+void jit_compile_exit(dyntrace_context_t *context, const SEXP call,
+                      const SEXP op, int outcome, uint64_t compile_time);
+
+#endif /* __PROBES_HPP__ */
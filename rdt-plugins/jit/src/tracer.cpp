@@ -0,0 +1,40 @@
+#include "tracer.hpp"
+
+DYNTRACE_PLUGIN_ABI;
+
+static JitProfiler *create_jit_profiler(SEXP options) {
+    return new JitProfiler(
+        sexp_to_string(get_named_list_element(options, "functions_filepath"),
+                       "jit_functions.tsv"),
+        sexp_to_string(get_named_list_element(options, "packages_filepath"),
+                       "jit_packages.tsv"),
+        sexp_to_int(get_named_list_element(options, "max_executions"), 1),
+        sexp_to_bool(get_named_list_element(options, "verbose"), false));
+}
+
+SEXP create_dyntracer(SEXP options) {
+
+    // calloc initializes the memory to zero. This ensures that probes not
+    // attached will point to NULL.
+    dyntracer_t *dyntracer = (dyntracer_t *)calloc(1, sizeof(dyntracer_t));
+
+    dyntracer->probe_begin = begin;
+    dyntracer->probe_end = end;
+    dyntracer->probe_function_entry = function_entry;
+    dyntracer->probe_jit_compile_entry = jit_compile_entry;
+    dyntracer->probe_jit_compile_exit = jit_compile_exit;
+    // The probes only use the helpers of Rdyntrace.h and C++ containers.
+    dyntracer->non_allocating = 1;
+    dyntracer->context = create_jit_profiler(options);
+
+    return dyntracer_to_sexp(dyntracer, "dyntracer.jit");
+}
+
+static void destroy_jit_dyntracer(dyntracer_t *dyntracer) {
+    delete static_cast<JitProfiler *>(dyntracer->context);
+    free(dyntracer);
+}
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp, destroy_jit_dyntracer);
+}
@@ -0,0 +1,75 @@
+#include "MatchProfiler.hpp"
+#include "TsvWriter.hpp"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+MatchProfiler::MatchProfiler(const std::string &functions_filepath,
+                             bool verbose)
+    : functions_filepath(functions_filepath), verbose(verbose) {}
+
+void MatchProfiler::begin() { functions.clear(); }
+
+void MatchProfiler::end() {
+    if (!functions_filepath.empty())
+        write_functions();
+
+    if (verbose) {
+        uint64_t calls = 0, match_time = 0, partial_calls = 0;
+        for (auto const &entry : functions) {
+            calls += entry.second.calls;
+            match_time += entry.second.match_time;
+            partial_calls += entry.second.partial_calls;
+        }
+        cerr << "Argument matching: " << calls << " calls, "
+             << match_time / 1e6 << "ms, " << partial_calls
+             << " calls with partial matches\n";
+    }
+}
+
+void MatchProfiler::match(SEXP call, int formals_count, int supplied_count,
+                          int partial_count, int dots, uint64_t match_time) {
+    match_summary_t &summary = functions[get_call_symbol(call)];
+    summary.calls++;
+    summary.match_time += match_time;
+    summary.max_formals = max(summary.max_formals, formals_count);
+    summary.formals += formals_count;
+    summary.supplied += supplied_count;
+    if (partial_count > 0) {
+        summary.partial_calls++;
+        summary.partial_matches += partial_count;
+    }
+    if (dots)
+        summary.dots_calls++;
+}
+
+void MatchProfiler::write_functions() const {
+    TsvWriter file(functions_filepath,
+                   {"function", "calls", "match_ms", "mean_match_us",
+                    "max_formals", "mean_formals", "mean_supplied",
+                    "partial_calls", "partial_matches", "dots_calls"});
+    if (!file.is_open())
+        return;
+
+    typedef pair<SEXP, const match_summary_t *> row_t;
+    vector<row_t> rows;
+    for (auto const &entry : functions)
+        rows.emplace_back(entry.first, &entry.second);
+    sort(rows.begin(), rows.end(), [](const row_t &a, const row_t &b) {
+        return a.second->match_time > b.second->match_time;
+    });
+
+    for (auto const &row : rows) {
+        const match_summary_t &summary = *row.second;
+        double calls = summary.calls;
+        file.row(row.first == R_NilValue ? "<anonymous>"
+                                         : CHAR(PRINTNAME(row.first)),
+                 summary.calls, summary.match_time / 1e6,
+                 summary.match_time / 1e3 / calls, summary.max_formals,
+                 summary.formals / calls, summary.supplied / calls,
+                 summary.partial_calls, summary.partial_matches,
+                 summary.dots_calls);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef __MATCH_PROFILER_HPP__
+#define __MATCH_PROFILER_HPP__
+
+#include "utilities.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+struct match_summary_t {
+    uint64_t calls = 0;
+    uint64_t match_time = 0; // nanoseconds
+    int max_formals = 0;
+    uint64_t formals = 0;
+    uint64_t supplied = 0;
+    uint64_t partial_calls = 0; // calls with at least one partial match
+    uint64_t partial_matches = 0;
+    uint64_t dots_calls = 0;
+};
+
+// Aggregates the argument matching done by matchArgs per function, keyed by
+// the symbol the function was called through: time spent, size of the
+// formals and supplied lists, partial matches and ... use.
+class MatchProfiler {
+  public:
+    MatchProfiler(const std::string &functions_filepath, bool verbose);
+
+    void begin();
+    void end();
+    void match(SEXP call, int formals_count, int supplied_count,
+               int partial_count, int dots, uint64_t match_time);
+
+  private:
+    void write_functions() const;
+
+    std::string functions_filepath;
+    bool verbose;
+
+    // Symbols are never collected, R_NilValue stands for anonymous calls.
+    std::unordered_map<SEXP, match_summary_t> functions;
+};
+
+#endif /* __MATCH_PROFILER_HPP__ */
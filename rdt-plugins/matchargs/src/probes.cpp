@@ -0,0 +1,12 @@
+#include "probes.hpp"
+
+RDT_PROFILER_ACCESSOR(MatchProfiler)
+
+RDT_FORWARD_BEGIN_END_PROBES(profiler)
+
+void match_args(dyntrace_context_t *context, const SEXP call,
+                const SEXP formals, int formals_count, int supplied_count,
+                int partial_count, int dots, uint64_t match_time) {
+    profiler(context).match(call, formals_count, supplied_count,
+                            partial_count, dots, match_time);
+}
@@ -0,0 +1,13 @@
+#ifndef __PROBES_HPP__
+#define __PROBES_HPP__
+
+#include "MatchProfiler.hpp"
+#include "probe_forwarding.hpp"
+
+RDT_DECLARE_BEGIN_END_PROBES();
+
+void match_args(dyntrace_context_t *context, const SEXP call,
+                const SEXP formals, int formals_count, int supplied_count,
+                int partial_count, int dots, uint64_t match_time);
+
+#endif /* __PROBES_HPP__ */
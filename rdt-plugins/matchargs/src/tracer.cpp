@@ -0,0 +1,35 @@
+#include "tracer.hpp"
+
+DYNTRACE_PLUGIN_ABI;
+
+static MatchProfiler *create_match_profiler(SEXP options) {
+    return new MatchProfiler(
+        sexp_to_string(get_named_list_element(options, "functions_filepath"),
+                       "match_args.tsv"),
+        sexp_to_bool(get_named_list_element(options, "verbose"), false));
+}
+
+SEXP create_dyntracer(SEXP options) {
+
+    // calloc initializes the memory to zero. This ensures that probes not
+    // attached will point to NULL.
+    dyntracer_t *dyntracer = (dyntracer_t *)calloc(1, sizeof(dyntracer_t));
+
+    dyntracer->probe_begin = begin;
+    dyntracer->probe_end = end;
+    dyntracer->probe_match_args = match_args;
+    // The probes only keep counts keyed by symbols.
+    dyntracer->non_allocating = 1;
+    dyntracer->context = create_match_profiler(options);
+
+    return dyntracer_to_sexp(dyntracer, "dyntracer.matchargs");
+}
+
+static void destroy_match_dyntracer(dyntracer_t *dyntracer) {
+    delete static_cast<MatchProfiler *>(dyntracer->context);
+    free(dyntracer);
+}
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp, destroy_match_dyntracer);
+}
@@ -0,0 +1,21 @@
+#include "NamespaceProfiler.hpp"
+#include <iostream>
+
+using namespace std;
+
+NamespaceProfiler::NamespaceProfiler(const std::string &namespaces_filepath,
+                                     bool verbose)
+    : namespaces_filepath(namespaces_filepath), verbose(verbose) {}
+
+void NamespaceProfiler::begin() { costs.begin(); }
+
+void NamespaceProfiler::end() {
+    costs.end();
+    if (!namespaces_filepath.empty())
+        costs.write(namespaces_filepath);
+
+    if (verbose)
+        cerr << "Namespaces: " << costs.get_namespaces().size()
+             << " namespaces, " << costs.get_total_time() / 1e9
+             << "s traced\n";
+}
@@ -0,0 +1,23 @@
+#ifndef __NAMESPACE_PROFILER_HPP__
+#define __NAMESPACE_PROFILER_HPP__
+
+#include "NamespaceCosts.hpp"
+#include <string>
+
+// How much time and memory go to the code of each package versus base R, see
+// NamespaceCosts. The summary is written when the trace ends.
+class NamespaceProfiler {
+  public:
+    NamespaceProfiler(const std::string &namespaces_filepath, bool verbose);
+
+    void begin();
+    void end();
+
+    NamespaceCosts costs;
+
+  private:
+    std::string namespaces_filepath;
+    bool verbose;
+};
+
+#endif /* __NAMESPACE_PROFILER_HPP__ */
@@ -0,0 +1,35 @@
+#include "probes.hpp"
+
+RDT_PROFILER_ACCESSOR(NamespaceProfiler)
+
+RDT_FORWARD_BEGIN_END_PROBES(profiler)
+
+void function_entry(dyntrace_context_t *context, const SEXP call,
+                    const SEXP op, const SEXP rho) {
+    profiler(context).costs.enter(op, rho);
+}
+
+void function_exit(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                   const SEXP rho, const SEXP retval) {
+    profiler(context).costs.exit();
+}
+
+// Also used for specials.
+void builtin_entry(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                   const SEXP rho) {
+    profiler(context).costs.enter(op, rho);
+}
+
+void builtin_exit(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                  const SEXP rho, const SEXP retval) {
+    profiler(context).costs.exit();
+}
+
+void jump_ctxt(dyntrace_context_t *context, const SEXP rho, const SEXP val) {
+    profiler(context).costs.unwind(rho);
+}
+
+void vector_alloc(dyntrace_context_t *context, int sexptype, long length,
+                  long bytes, SEXP srcref) {
+    profiler(context).costs.allocate(bytes);
+}
@@ -0,0 +1,26 @@
+#ifndef __PROBES_HPP__
+#define __PROBES_HPP__
+
+#include "NamespaceProfiler.hpp"
+#include "probe_forwarding.hpp"
+
+RDT_DECLARE_BEGIN_END_PROBES();
+
+void function_entry(dyntrace_context_t *context, const SEXP call,
+                    const SEXP op, const SEXP rho);
+
+void function_exit(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                   const SEXP rho, const SEXP retval);
+
+void builtin_entry(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                   const SEXP rho);
+
+void builtin_exit(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                  const SEXP rho, const SEXP retval);
+
+void jump_ctxt(dyntrace_context_t *context, const SEXP rho, const SEXP val);
+
+void vector_alloc(dyntrace_context_t *context, int sexptype, long length,
+                  long bytes, SEXP srcref);
+
+#endif /* __PROBES_HPP__ */
@@ -39,7 +39,7 @@ create table if not exists calls (
     -- pointer integer not null, -- we're not using this at all
     --[ data ]-----------------------------------------------------------------
     function_name text,
-    callsite text,
+    callsite_id integer, -- deparsed text and location are in callsites
     compiled boolean not null, -- TODO remove
     --[ relations ]------------------------------------------------------------
     function_id integer not null,
@@ -49,7 +49,51 @@ create table if not exists calls (
     parent_on_stack_id integer null,
     --[ keys ]-----------------------------------------------------------------
     foreign key (function_id) references functions,
-    foreign key (parent_id) references calls
+    foreign key (parent_id) references calls,
+    foreign key (callsite_id) references callsites
+);
+
+-- With aggregate_builtins, calls to builtins and specials are not recorded
+-- in calls (unless listed in traced_builtins). Instead, this table holds the
+-- number of calls to each builtin made directly from a given call.
+create table if not exists builtin_counts (
+    --[ relations ]------------------------------------------------------------
+    call_id integer not null, -- ID of the calling closure
+    function_id integer not null,
+    --[ data ]-----------------------------------------------------------------
+    function_name text,
+    count integer not null,
+    --[ keys ]-----------------------------------------------------------------
+    foreign key (call_id) references calls,
+    foreign key (function_id) references functions
+);
+
+-- Files referenced by srcrefs in callsites.
+create table if not exists srcfiles (
+    --[ identity ]-------------------------------------------------------------
+    id integer primary key,
+    --[ data ]-----------------------------------------------------------------
+    filename text
+);
+
+-- One row per distinct call expression seen during the trace, deparsed in
+-- batches of 4096 and when the trace finishes. A call seen again after its
+-- batch was written gets a second row. The location is null when there was no
+-- srcref.
+create table if not exists callsites (
+    --[ identity ]-------------------------------------------------------------
+    id integer primary key,
+    --[ data ]-----------------------------------------------------------------
+    callsite text,
+    --[ relations ]------------------------------------------------------------
+    srcfile_id integer null,
+    --[ data ]-----------------------------------------------------------------
+    first_line integer null,
+    first_column integer null,
+    last_line integer null,
+    last_column integer null,
+    --[ keys ]-----------------------------------------------------------------
+    foreign key (srcfile_id) references srcfiles
 );
 
 create table if not exists promises (
@@ -140,3 +184,48 @@ create table if not exists type_distribution (
     --[ keys ]-----------------------------------------------------------------
     foreign key (gc_trigger_counter) references gc_trigger
 );
+
+-- Promises whose metadata the tracer dropped before they were unmarked, see
+-- promise_retirement_epochs and promise_memory_limit. Later events for the
+-- same promise keep its ID and from_call_id.
+create table if not exists promise_retirements (
+    --[ relation ]-------------------------------------------------------------
+    promise_id integer not null,
+    from_call_id integer not null,
+    --[ data ]-----------------------------------------------------------------
+    last_touched integer not null, -- gc_trigger_counter of the last event
+    reason integer not null, -- 0: epoch, 1: memory ceiling, 2: forgotten
+    gc_trigger_counter integer not null,
+    --[ keys ]-----------------------------------------------------------------
+    foreign key (promise_id) references promises,
+    foreign key (from_call_id) references calls,
+    foreign key (gc_trigger_counter) references gc_trigger
+);
+
+-- Size of the tracer's own tables after each garbage collection.
+create table if not exists tracer_footprint (
+    --[ relation ]-------------------------------------------------------------
+    gc_trigger_counter integer not null,
+    --[ data ]-----------------------------------------------------------------
+    table_name text not null,
+    entries integer not null,
+    bytes integer not null, -- estimate
+    --[ keys ]-----------------------------------------------------------------
+    foreign key (gc_trigger_counter) references gc_trigger
+);
+
+-- Children forked by parallel while tracing. Each child writes its events to
+-- its own database, segment, and numbers its calls, promises and arguments
+-- from id_base so that they do not collide with those of the parent or other
+-- children. Function and callsite IDs are local to each database.
+create table if not exists forked_children (
+    --[ identity ]-------------------------------------------------------------
+    pid integer not null,
+    --[ relations ]------------------------------------------------------------
+    call_id integer not null, -- innermost call of the parent at the fork
+    --[ data ]-----------------------------------------------------------------
+    id_base integer not null,
+    segment text not null,
+    --[ keys ]-----------------------------------------------------------------
+    foreign key (call_id) references calls
+);
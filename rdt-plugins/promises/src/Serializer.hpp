@@ -0,0 +1,49 @@
+#ifndef __SERIALIZER_HPP__
+#define __SERIALIZER_HPP__
+
+#include "State.hpp"
+#include <string>
+
+// Interface implemented by every trace output backend. The hooks only talk to
+// the serializer returned by tracer_serializer(), so backends can be swapped
+// through the output_format option without touching the hooks.
+class Serializer {
+  public:
+    virtual ~Serializer() {}
+    virtual void serialize_start_trace(const metadata_t &info) = 0;
+    virtual void serialize_finish_trace(const metadata_t &info) = 0;
+    virtual void serialize_function_entry(const closure_info_t &info) = 0;
+    virtual void serialize_function_exit(const closure_info_t &info) = 0;
+    virtual void serialize_builtin_entry(const builtin_info_t &info) = 0;
+    virtual void serialize_builtin_exit(const builtin_info_t &info) = 0;
+    virtual void serialize_builtin_count(const builtin_count_info_t &info) = 0;
+    virtual void serialize_force_promise_entry(const prom_info_t &info,
+                                               int clock_id) = 0;
+    virtual void serialize_force_promise_exit(const prom_info_t &info,
+                                              int clock_id) = 0;
+    virtual void serialize_promise_created(const prom_basic_info_t &info) = 0;
+    virtual void serialize_promise_lookup(const prom_info_t &info,
+                                          int clock_id) = 0;
+    virtual void serialize_promise_expression_lookup(const prom_info_t &info,
+                                                     int clock_id) = 0;
+    virtual void serialize_promise_lifecycle(const prom_gc_info_t &info) = 0;
+    virtual void serialize_vector_alloc(const type_gc_info_t &info) = 0;
+    virtual void serialize_gc_exit(const gc_info_t &info) = 0;
+    virtual void serialize_unwind(const unwind_info_t &info) = 0;
+    virtual void serialize_srcfile(const srcfile_info_t &info) = 0;
+    virtual void serialize_callsite(const callsite_info_t &info) = 0;
+    virtual void
+    serialize_promise_retirement(const prom_retirement_info_t &info) = 0;
+    virtual void serialize_tracer_footprint(const footprint_info_t &info) = 0;
+    virtual void serialize_fork(const fork_info_t &info) = 0;
+    // Output of a child forked by parallel: the output of this serializer
+    // with .<pid> appended.
+    virtual std::string get_segment_filepath(pid_t pid) const = 0;
+    // Called in the child, returns a serializer of the same kind writing to
+    // get_segment_filepath(getpid()). The serializer of the parent is never
+    // used in the child again, its connection and buffered events belong to
+    // the parent.
+    virtual Serializer *create_segment_serializer(pid_t pid) const = 0;
+};
+
+#endif /* __SERIALIZER_HPP__ */
@@ -1,9 +1,13 @@
 #include "SqlSerializer.hpp"
 
 SqlSerializer::SqlSerializer(const std::string &database_filepath,
-                             const std::string &schema_filepath, bool verbose)
-    : verbose(verbose), indentation(0) {
-    open_database(database_filepath);
+                             const std::string &schema_filepath, bool verbose,
+                             bool in_memory, int backup_pages,
+                             long memory_limit)
+    : verbose(verbose), indentation(0), in_memory(in_memory),
+      backup_pages(backup_pages), memory_limit(memory_limit),
+      database_path(database_filepath), schema_path(schema_filepath) {
+    open_database(in_memory ? ":memory:" : database_filepath);
     create_tables(schema_filepath);
     prepare_statements();
 }
@@ -26,17 +30,154 @@ void SqlSerializer::create_tables(const std::string schema_path) {
 }
 
 SqlSerializer::~SqlSerializer() {
-    close_database();
+    if (backup_thread.joinable())
+        backup_thread.join();
     finalize_statements();
+    close_database();
 }
 
 void SqlSerializer::close_database() { sqlite3_close(database); }
 
+// Copies the whole source database to database_path using the online backup
+// API. pages_per_step <= 0 copies everything in one step, otherwise the copy
+// proceeds in chunks of pages_per_step pages.
+void SqlSerializer::backup_database(sqlite3 *source, int pages_per_step) {
+    sqlite3 *destination = nullptr;
+    int outcome = sqlite3_open(database_path.c_str(), &destination);
+
+    if (outcome == SQLITE_OK) {
+        sqlite3_backup *backup =
+            sqlite3_backup_init(destination, "main", source, "main");
+        if (backup != nullptr) {
+            // milliseconds to wait before retrying a busy or locked step,
+            // doubled on each retry
+            int backoff = 1;
+            do {
+                outcome = sqlite3_backup_step(
+                    backup, pages_per_step > 0 ? pages_per_step : -1);
+                if (outcome == SQLITE_BUSY || outcome == SQLITE_LOCKED) {
+                    sqlite3_sleep(backoff);
+                    backoff = std::min(2 * backoff, 256);
+                    continue;
+                }
+                backoff = 1;
+                if (verbose && outcome == SQLITE_OK)
+                    cerr << "Backup of " << database_path << ": "
+                         << sqlite3_backup_remaining(backup) << " of "
+                         << sqlite3_backup_pagecount(backup)
+                         << " pages remaining\n";
+            } while (outcome == SQLITE_OK || outcome == SQLITE_BUSY ||
+                     outcome == SQLITE_LOCKED);
+            sqlite3_backup_finish(backup);
+        }
+        outcome = sqlite3_errcode(destination);
+    }
+
+    if (outcome != SQLITE_OK) {
+        cerr << "Error: could not back up trace to " << database_path
+             << ", message (" << outcome
+             << "): " << string(sqlite3_errmsg(destination)) << "\n";
+    }
+
+    sqlite3_close(destination);
+}
+
+// Runs on backup_thread, the spilled database is freed once it is on disk.
+void SqlSerializer::spill_database(sqlite3 *source) {
+    backup_database(source, backup_pages);
+    sqlite3_close(source);
+    spill_done = true;
+}
+
+// Called when the in-memory database outgrows memory_limit. The trace so far
+// is handed to backup_thread and the trace goes on in a fresh in-memory
+// database, with the autoincrement counters of the spilled one so that the
+// two can be merged by finish_spill.
+void SqlSerializer::spill_to_disk() {
+    if (verbose)
+        cerr << "In-memory trace exceeds " << memory_limit
+             << " bytes, spilling to " << database_path << "\n";
+
+    execute(commit_statement);
+    finalize_statements();
+    sqlite3 *spilled = database;
+
+    open_database(":memory:");
+    create_tables(schema_path);
+
+    sqlite3_stmt *select_sequence =
+        compile_on(spilled, "select name, seq from sqlite_sequence;");
+    sqlite3_stmt *insert_sequence =
+        compile("insert into sqlite_sequence values (?,?);");
+    while (sqlite3_step(select_sequence) == SQLITE_ROW) {
+        sqlite3_bind_value(insert_sequence, 1,
+                           sqlite3_column_value(select_sequence, 0));
+        sqlite3_bind_value(insert_sequence, 2,
+                           sqlite3_column_value(select_sequence, 1));
+        execute(insert_sequence);
+    }
+    sqlite3_finalize(select_sequence);
+    sqlite3_finalize(insert_sequence);
+
+    prepare_statements();
+    execute(begin_statement);
+
+    spilling = true;
+    spill_done = false;
+    backup_thread = std::thread(&SqlSerializer::spill_database, this, spilled);
+}
+
+// Waits for the spill, appends what was traced in the meantime to
+// database_path and continues tracing directly into that file.
+void SqlSerializer::finish_spill() {
+    backup_thread.join();
+    spilling = false;
+
+    execute(commit_statement);
+    finalize_statements();
+
+    sqlite3_stmt *attach = compile("attach database ? as disk;");
+    sqlite3_bind_text(attach, 1, database_path.c_str(), -1, SQLITE_TRANSIENT);
+    execute(attach);
+    sqlite3_finalize(attach);
+
+    sqlite3_exec(database, "begin transaction;", nullptr, nullptr, nullptr);
+    sqlite3_stmt *select_table =
+        compile("select name from main.sqlite_master where type = 'table' "
+                "and name not like 'sqlite_%';");
+    while (sqlite3_step(select_table) == SQLITE_ROW) {
+        string table = reinterpret_cast<const char *>(
+            sqlite3_column_text(select_table, 0));
+        string append = "insert into disk." + table + " select * from main." +
+                        table + ";";
+        if (sqlite3_exec(database, append.c_str(), nullptr, nullptr,
+                         nullptr) != SQLITE_OK)
+            cerr << "Error: could not move " << table << " to "
+                 << database_path << ", message: " << sqlite3_errmsg(database)
+                 << "\n";
+    }
+    sqlite3_finalize(select_table);
+    sqlite3_exec(database, "commit;", nullptr, nullptr, nullptr);
+
+    close_database();
+    in_memory = false;
+
+    open_database(database_path);
+    create_tables(schema_path);
+    prepare_statements();
+    execute(begin_statement);
+}
+
 void SqlSerializer::finalize_statements() {
+    sqlite3_finalize(begin_statement);
+    sqlite3_finalize(commit_statement);
     sqlite3_finalize(insert_metadata_statement);
     sqlite3_finalize(insert_function_statement);
     sqlite3_finalize(insert_argument_statement);
     sqlite3_finalize(insert_call_statement);
+    sqlite3_finalize(insert_builtin_count_statement);
+    sqlite3_finalize(insert_srcfile_statement);
+    sqlite3_finalize(insert_callsite_statement);
     sqlite3_finalize(insert_promise_statement);
     sqlite3_finalize(insert_promise_association_statement);
     sqlite3_finalize(insert_promise_evaluation_statement);
@@ -44,9 +185,16 @@ void SqlSerializer::finalize_statements() {
     sqlite3_finalize(insert_promise_lifecycle_statement);
     sqlite3_finalize(insert_gc_trigger_statement);
     sqlite3_finalize(insert_type_distribution_statement);
+    sqlite3_finalize(insert_promise_retirement_statement);
+    sqlite3_finalize(insert_tracer_footprint_statement);
+    sqlite3_finalize(insert_fork_statement);
 }
 
 void SqlSerializer::prepare_statements() {
+    begin_statement = compile("begin transaction;");
+
+    commit_statement = compile("commit;");
+
     insert_metadata_statement = compile("insert into metadata values (?,?);");
 
     insert_function_statement =
@@ -55,6 +203,14 @@ void SqlSerializer::prepare_statements() {
     insert_call_statement =
         compile("insert into calls values (?,?,?,?,?,?,?,?,?);");
 
+    insert_builtin_count_statement =
+        compile("insert into builtin_counts values (?,?,?,?);");
+
+    insert_srcfile_statement = compile("insert into srcfiles values (?,?);");
+
+    insert_callsite_statement =
+        compile("insert into callsites values (?,?,?,?,?,?,?);");
+
     insert_argument_statement =
         compile("insert into arguments values (?,?,?,?);");
 
@@ -78,33 +234,64 @@ void SqlSerializer::prepare_statements() {
 
     insert_type_distribution_statement =
         compile("insert into type_distribution values (?,?,?,?);");
+
+    insert_promise_retirement_statement =
+        compile("insert into promise_retirements values (?,?,?,?,?);");
+
+    insert_tracer_footprint_statement =
+        compile("insert into tracer_footprint values (?,?,?,?);");
+
+    insert_fork_statement =
+        compile("insert into forked_children values (?,?,?,?);");
 }
 
 void SqlSerializer::serialize_start_trace(const metadata_t &info) {
 
+    if (spilling)
+        finish_spill();
+
     for (auto const &i : info) {
         execute(populate_metadata_statement(i.first, i.second));
     }
 
-    execute(compile("begin transaction;"));
+    execute(begin_statement);
 }
 
 void SqlSerializer::serialize_finish_trace(const metadata_t &info) {
 
+    if (spilling)
+        finish_spill();
+
     for (auto const &i : info) {
         execute(populate_metadata_statement(i.first, i.second));
     }
-    execute(compile("commit;"));
+    execute(commit_statement);
+
+    if (!in_memory)
+        return;
+
+    // Nothing writes to the in-memory database from now on, so the copy can
+    // run on its own thread while R carries on. The destructor waits for it.
+    if (backup_pages > 0)
+        backup_thread = std::thread(&SqlSerializer::backup_database, this,
+                                    database, backup_pages);
+    else
+        backup_database(database, -1);
 }
 
 sqlite3_stmt *SqlSerializer::compile(const char *statement) {
+    return compile_on(database, statement);
+}
+
+sqlite3_stmt *SqlSerializer::compile_on(sqlite3 *connection,
+                                        const char *statement) {
     sqlite3_stmt *prepared_statement;
-    int outcome =
-        sqlite3_prepare_v2(database, statement, -1, &prepared_statement, NULL);
+    int outcome = sqlite3_prepare_v2(connection, statement, -1,
+                                     &prepared_statement, NULL);
     if (outcome != SQLITE_OK) {
         fprintf(stderr, "Error: could not compile prepared statement \"%s\", "
                         "message (%i): %s\n",
-                statement, outcome, sqlite3_errmsg(database));
+                statement, outcome, sqlite3_errmsg(connection));
 
         exit(1);
     }
@@ -144,7 +331,7 @@ void SqlSerializer::execute(sqlite3_stmt *statement) {
 }
 
 void SqlSerializer::serialize_promise_lifecycle(const prom_gc_info_t &info) {
-    sqlite3_bind_int(insert_promise_lifecycle_statement, 1, info.promise_id);
+    sqlite3_bind_int64(insert_promise_lifecycle_statement, 1, info.promise_id);
     sqlite3_bind_int(insert_promise_lifecycle_statement, 2, info.event);
     sqlite3_bind_int(insert_promise_lifecycle_statement, 3,
                      info.gc_trigger_counter);
@@ -156,6 +343,13 @@ void SqlSerializer::serialize_gc_exit(const gc_info_t &info) {
     sqlite3_bind_double(insert_gc_trigger_statement, 2, info.ncells);
     sqlite3_bind_double(insert_gc_trigger_statement, 3, info.vcells);
     execute(insert_gc_trigger_statement);
+
+    if (spilling) {
+        if (spill_done)
+            finish_spill();
+    } else if (in_memory && memory_limit > 0 &&
+               sqlite3_memory_used() > memory_limit)
+        spill_to_disk();
 }
 
 void SqlSerializer::serialize_vector_alloc(const type_gc_info_t &info) {
@@ -186,10 +380,11 @@ sqlite3_stmt *SqlSerializer::populate_promise_evaluation_statement(
 
     sqlite3_bind_int(insert_promise_evaluation_statement, 1, clock_id);
     sqlite3_bind_int(insert_promise_evaluation_statement, 2, type);
-    sqlite3_bind_int(insert_promise_evaluation_statement, 3, info.prom_id);
-    sqlite3_bind_int(insert_promise_evaluation_statement, 4, info.from_call_id);
-    sqlite3_bind_int(insert_promise_evaluation_statement, 5, info.in_call_id);
-    sqlite3_bind_int(insert_promise_evaluation_statement, 6, info.in_prom_id);
+    sqlite3_bind_int64(insert_promise_evaluation_statement, 3, info.prom_id);
+    sqlite3_bind_int64(insert_promise_evaluation_statement, 4,
+                       info.from_call_id);
+    sqlite3_bind_int64(insert_promise_evaluation_statement, 5, info.in_call_id);
+    sqlite3_bind_int64(insert_promise_evaluation_statement, 6, info.in_prom_id);
     sqlite3_bind_int(insert_promise_evaluation_statement, 7,
                      to_underlying_type(info.lifestyle));
     sqlite3_bind_int(insert_promise_evaluation_statement, 8,
@@ -204,12 +399,12 @@ sqlite3_stmt *SqlSerializer::populate_promise_evaluation_statement(
             sqlite3_bind_null(insert_promise_evaluation_statement, 11);
             break;
         case stack_type::CALL:
-            sqlite3_bind_int(insert_promise_evaluation_statement, 11,
-                             (int)info.parent_on_stack.call_id);
+            sqlite3_bind_int64(insert_promise_evaluation_statement, 11,
+                               info.parent_on_stack.call_id);
             break;
         case stack_type::PROMISE:
-            sqlite3_bind_int(insert_promise_evaluation_statement, 11,
-                             (int)info.parent_on_stack.promise_id);
+            sqlite3_bind_int64(insert_promise_evaluation_statement, 11,
+                               info.parent_on_stack.promise_id);
             break;
     }
 
@@ -260,6 +455,18 @@ void SqlSerializer::serialize_builtin_exit(const builtin_info_t &info) {
     unindent();
 }
 
+void SqlSerializer::serialize_builtin_count(const builtin_count_info_t &info) {
+    if (register_inserted_function(info.fn_id))
+        execute(populate_function_statement(info));
+
+    sqlite3_bind_int64(insert_builtin_count_statement, 1, info.parent_call_id);
+    sqlite3_bind_int(insert_builtin_count_statement, 2, info.fn_id);
+    sqlite3_bind_text(insert_builtin_count_statement, 3, info.name.c_str(), -1,
+                      SQLITE_TRANSIENT);
+    sqlite3_bind_int64(insert_builtin_count_statement, 4, info.count);
+    execute(insert_builtin_count_statement);
+}
+
 void SqlSerializer::serialize_force_promise_entry(const prom_info_t &info,
                                                   int clock_id) {
     if (info.prom_id < 0) // if this is a promise from the outside
@@ -278,7 +485,7 @@ void SqlSerializer::serialize_force_promise_exit(const prom_info_t &info,
     unindent();
     sqlite3_bind_int(insert_promise_return_statement, 1,
                      to_underlying_type(info.return_type));
-    sqlite3_bind_int(insert_promise_return_statement, 2, info.prom_id);
+    sqlite3_bind_int64(insert_promise_return_statement, 2, info.prom_id);
     sqlite3_bind_int(insert_promise_return_statement, 3, clock_id);
     execute(insert_promise_return_statement);
 }
@@ -289,9 +496,77 @@ void SqlSerializer::serialize_promise_created(const prom_basic_info_t &info) {
 
 void SqlSerializer::serialize_unwind(const unwind_info_t &info) {}
 
+void SqlSerializer::serialize_srcfile(const srcfile_info_t &info) {
+    sqlite3_bind_int(insert_srcfile_statement, 1, info.srcfile_id);
+    sqlite3_bind_text(insert_srcfile_statement, 2, info.filename.c_str(), -1,
+                      SQLITE_TRANSIENT);
+    execute(insert_srcfile_statement);
+}
+
+void SqlSerializer::serialize_callsite(const callsite_info_t &info) {
+    sqlite3_bind_int(insert_callsite_statement, 1, info.callsite_id);
+    sqlite3_bind_text(insert_callsite_statement, 2, info.callsite.c_str(), -1,
+                      SQLITE_TRANSIENT);
+    if (info.srcfile_id < 0) {
+        for (int index = 3; index <= 7; ++index)
+            sqlite3_bind_null(insert_callsite_statement, index);
+    } else {
+        sqlite3_bind_int(insert_callsite_statement, 3, info.srcfile_id);
+        sqlite3_bind_int(insert_callsite_statement, 4, info.first_line);
+        sqlite3_bind_int(insert_callsite_statement, 5, info.first_column);
+        sqlite3_bind_int(insert_callsite_statement, 6, info.last_line);
+        sqlite3_bind_int(insert_callsite_statement, 7, info.last_column);
+    }
+    execute(insert_callsite_statement);
+}
+
+void SqlSerializer::serialize_promise_retirement(
+    const prom_retirement_info_t &info) {
+    sqlite3_bind_int64(insert_promise_retirement_statement, 1, info.prom_id);
+    sqlite3_bind_int64(insert_promise_retirement_statement, 2,
+                       info.from_call_id);
+    sqlite3_bind_int(insert_promise_retirement_statement, 3,
+                     info.last_touched);
+    sqlite3_bind_int(insert_promise_retirement_statement, 4,
+                     to_underlying_type(info.reason));
+    sqlite3_bind_int(insert_promise_retirement_statement, 5,
+                     info.gc_trigger_counter);
+    execute(insert_promise_retirement_statement);
+}
+
+void SqlSerializer::serialize_tracer_footprint(const footprint_info_t &info) {
+    sqlite3_bind_int(insert_tracer_footprint_statement, 1,
+                     info.gc_trigger_counter);
+    sqlite3_bind_text(insert_tracer_footprint_statement, 2, info.table.c_str(),
+                      -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(insert_tracer_footprint_statement, 3, info.entries);
+    sqlite3_bind_int64(insert_tracer_footprint_statement, 4, info.bytes);
+    execute(insert_tracer_footprint_statement);
+}
+
+void SqlSerializer::serialize_fork(const fork_info_t &info) {
+    sqlite3_bind_int(insert_fork_statement, 1, info.child_pid);
+    sqlite3_bind_int64(insert_fork_statement, 2, info.call_id);
+    sqlite3_bind_int64(insert_fork_statement, 3, info.id_base);
+    sqlite3_bind_text(insert_fork_statement, 4, info.segment.c_str(), -1,
+                      SQLITE_TRANSIENT);
+    execute(insert_fork_statement);
+}
+
+std::string SqlSerializer::get_segment_filepath(pid_t pid) const {
+    return database_path + "." + std::to_string(pid);
+}
+
+// The segment is written directly to disk: an in-memory segment would need a
+// backup thread, and the child leaves with _exit before a destructor could
+// join it.
+Serializer *SqlSerializer::create_segment_serializer(pid_t pid) const {
+    return new SqlSerializer(get_segment_filepath(pid), schema_path, verbose);
+}
+
 sqlite3_stmt *SqlSerializer::populate_insert_promise_statement(
     const prom_basic_info_t &info) {
-    sqlite3_bind_int(insert_promise_statement, 1, (int)info.prom_id);
+    sqlite3_bind_int64(insert_promise_statement, 1, info.prom_id);
     sqlite3_bind_int(insert_promise_statement, 2,
                      to_underlying_type(info.prom_type));
 
@@ -303,7 +578,7 @@ sqlite3_stmt *SqlSerializer::populate_insert_promise_statement(
                           SQLITE_TRANSIENT);
     }
 
-    sqlite3_bind_int(insert_promise_statement, 4, info.in_prom_id);
+    sqlite3_bind_int64(insert_promise_statement, 4, info.in_prom_id);
     sqlite3_bind_int(insert_promise_statement, 5,
                      to_underlying_type(info.parent_on_stack.type));
 
@@ -312,12 +587,12 @@ sqlite3_stmt *SqlSerializer::populate_insert_promise_statement(
             sqlite3_bind_null(insert_promise_statement, 6);
             break;
         case stack_type::CALL:
-            sqlite3_bind_int(insert_promise_statement, 6,
-                             (int)info.parent_on_stack.call_id);
+            sqlite3_bind_int64(insert_promise_statement, 6,
+                               info.parent_on_stack.call_id);
             break;
         case stack_type::PROMISE:
-            sqlite3_bind_int(insert_promise_statement, 6,
-                             (int)info.parent_on_stack.promise_id);
+            sqlite3_bind_int64(insert_promise_statement, 6,
+                               info.parent_on_stack.promise_id);
             break;
     }
     sqlite3_bind_int(insert_promise_statement, 7, info.depth);
@@ -325,23 +600,22 @@ sqlite3_stmt *SqlSerializer::populate_insert_promise_statement(
 }
 
 sqlite3_stmt *SqlSerializer::populate_call_statement(const call_info_t &info) {
-    sqlite3_bind_int(insert_call_statement, 1, (int)info.call_id);
+    sqlite3_bind_int64(insert_call_statement, 1, info.call_id);
     if (info.name.empty())
         sqlite3_bind_null(insert_call_statement, 2);
     else
         sqlite3_bind_text(insert_call_statement, 2, info.name.c_str(), -1,
                           SQLITE_TRANSIENT);
 
-    if (info.callsite.empty())
+    if (info.callsite_id < 0)
         sqlite3_bind_null(insert_call_statement, 3);
     else
-        sqlite3_bind_text(insert_call_statement, 3, info.callsite.c_str(), -1,
-                          SQLITE_TRANSIENT);
+        sqlite3_bind_int(insert_call_statement, 3, info.callsite_id);
 
     sqlite3_bind_int(insert_call_statement, 4, info.fn_compiled ? 1 : 0);
     sqlite3_bind_int(insert_call_statement, 5, (int)info.fn_id);
-    sqlite3_bind_int(insert_call_statement, 6, (int)info.parent_call_id);
-    sqlite3_bind_int(insert_call_statement, 7, (int)info.in_prom_id);
+    sqlite3_bind_int64(insert_call_statement, 6, info.parent_call_id);
+    sqlite3_bind_int64(insert_call_statement, 7, info.in_prom_id);
     sqlite3_bind_int(insert_call_statement, 8,
                      to_underlying_type(info.parent_on_stack.type));
 
@@ -350,12 +624,12 @@ sqlite3_stmt *SqlSerializer::populate_call_statement(const call_info_t &info) {
             sqlite3_bind_null(insert_call_statement, 9);
             break;
         case stack_type::CALL:
-            sqlite3_bind_int(insert_call_statement, 9,
-                             (int)info.parent_on_stack.call_id);
+            sqlite3_bind_int64(insert_call_statement, 9,
+                               info.parent_on_stack.call_id);
             break;
         case stack_type::PROMISE:
-            sqlite3_bind_int(insert_call_statement, 9,
-                             (int)info.parent_on_stack.promise_id);
+            sqlite3_bind_int64(insert_call_statement, 9,
+                               info.parent_on_stack.promise_id);
             break;
     }
 
@@ -369,9 +643,9 @@ sqlite3_stmt *SqlSerializer::populate_promise_association_statement(
     arg_id_t arg_id = get<1>(argument);
     prom_id_t promise = get<2>(argument);
 
-    sqlite3_bind_int(insert_promise_association_statement, 1, promise);
-    sqlite3_bind_int(insert_promise_association_statement, 2, info.call_id);
-    sqlite3_bind_int(insert_promise_association_statement, 3, arg_id);
+    sqlite3_bind_int64(insert_promise_association_statement, 1, promise);
+    sqlite3_bind_int64(insert_promise_association_statement, 2, info.call_id);
+    sqlite3_bind_int64(insert_promise_association_statement, 3, arg_id);
 
     return insert_promise_association_statement;
 }
@@ -421,11 +695,11 @@ sqlite3_stmt *
 SqlSerializer::populate_insert_argument_statement(const closure_info_t &info,
                                                   int index) {
     const arg_t &argument = info.arguments.all()[index].get();
-    sqlite3_bind_int(insert_argument_statement, 1, get<1>(argument));
+    sqlite3_bind_int64(insert_argument_statement, 1, get<1>(argument));
     sqlite3_bind_text(insert_argument_statement, 2, get<0>(argument).c_str(),
                       -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(insert_argument_statement, 3,
                      index); // FIXME broken or unnecessary (pick one)
-    sqlite3_bind_int(insert_argument_statement, 4, info.call_id);
+    sqlite3_bind_int64(insert_argument_statement, 4, info.call_id);
     return insert_argument_statement;
 }
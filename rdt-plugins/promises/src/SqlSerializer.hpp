@@ -1,39 +1,62 @@
 #ifndef __SQL_SERIALIZER__
 #define __SQL_SERIALIZER__
 
+#include "Serializer.hpp"
 #include "State.hpp"
-#include "sqlite3.h"
+#include <sqlite3.h>
 #include "utilities.hpp"
+#include <algorithm>
+#include <atomic>
 #include <stdio.h>
 #include <string>
+#include <thread>
 
-class SqlSerializer {
+class SqlSerializer : public Serializer {
   public:
     SqlSerializer(const std::string &database_path,
-                  const std::string &schema_path, bool verbose = false);
-    ~SqlSerializer();
-    void serialize_start_trace(const metadata_t &info);
-    void serialize_finish_trace(const metadata_t &info);
-    void serialize_function_entry(const closure_info_t &info);
-    void serialize_function_exit(const closure_info_t &info);
-    void serialize_builtin_entry(const builtin_info_t &info);
-    void serialize_builtin_exit(const builtin_info_t &info);
-    void serialize_force_promise_entry(const prom_info_t &info, int clock_id);
-    void serialize_force_promise_exit(const prom_info_t &info, int clock_id);
-    void serialize_promise_created(const prom_basic_info_t &info);
-    void serialize_promise_lookup(const prom_info_t &info, int clock_id);
+                  const std::string &schema_path, bool verbose = false,
+                  bool in_memory = false, int backup_pages = 0,
+                  long memory_limit = 0);
+    ~SqlSerializer() override;
+    void serialize_start_trace(const metadata_t &info) override;
+    void serialize_finish_trace(const metadata_t &info) override;
+    void serialize_function_entry(const closure_info_t &info) override;
+    void serialize_function_exit(const closure_info_t &info) override;
+    void serialize_builtin_entry(const builtin_info_t &info) override;
+    void serialize_builtin_exit(const builtin_info_t &info) override;
+    void serialize_builtin_count(const builtin_count_info_t &info) override;
+    void serialize_force_promise_entry(const prom_info_t &info,
+                                       int clock_id) override;
+    void serialize_force_promise_exit(const prom_info_t &info,
+                                      int clock_id) override;
+    void serialize_promise_created(const prom_basic_info_t &info) override;
+    void serialize_promise_lookup(const prom_info_t &info,
+                                  int clock_id) override;
     void serialize_promise_expression_lookup(const prom_info_t &info,
-                                             int clock_id);
-    void serialize_promise_lifecycle(const prom_gc_info_t &info);
-    void serialize_vector_alloc(const type_gc_info_t &info);
-    void serialize_gc_exit(const gc_info_t &info);
-    void serialize_unwind(const unwind_info_t &info);
+                                             int clock_id) override;
+    void serialize_promise_lifecycle(const prom_gc_info_t &info) override;
+    void serialize_vector_alloc(const type_gc_info_t &info) override;
+    void serialize_gc_exit(const gc_info_t &info) override;
+    void serialize_unwind(const unwind_info_t &info) override;
+    void serialize_srcfile(const srcfile_info_t &info) override;
+    void serialize_callsite(const callsite_info_t &info) override;
+    void
+    serialize_promise_retirement(const prom_retirement_info_t &info) override;
+    void serialize_tracer_footprint(const footprint_info_t &info) override;
+    void serialize_fork(const fork_info_t &info) override;
+    std::string get_segment_filepath(pid_t pid) const override;
+    Serializer *create_segment_serializer(pid_t pid) const override;
 
   private:
     sqlite3_stmt *compile(const char *statement);
+    sqlite3_stmt *compile_on(sqlite3 *connection, const char *statement);
     void execute(sqlite3_stmt *statement);
     void open_database(const std::string database_path);
     void close_database();
+    void backup_database(sqlite3 *source, int pages_per_step);
+    void spill_database(sqlite3 *source);
+    void spill_to_disk();
+    void finish_spill();
     void create_tables(const std::string schema_path);
     void prepare_statements();
     void finalize_statements();
@@ -61,11 +84,29 @@ class SqlSerializer {
                                                      int index);
     bool verbose;
     int indentation;
+    // When in_memory is set, the trace is written to a ':memory:' database
+    // and copied to database_path with the online backup API at the end of
+    // the trace, or earlier if the database outgrows memory_limit bytes. That
+    // spill runs on backup_thread while the trace goes on in a fresh
+    // in-memory database, moved to database_path once spill_done is set.
+    bool in_memory;
+    bool spilling = false;
+    std::atomic<bool> spill_done{false};
+    int backup_pages;
+    long memory_limit;
+    std::string database_path;
+    std::string schema_path;
+    std::thread backup_thread;
     sqlite3 *database = nullptr;
+    sqlite3_stmt *begin_statement = nullptr;
+    sqlite3_stmt *commit_statement = nullptr;
     sqlite3_stmt *insert_metadata_statement = nullptr;
     sqlite3_stmt *insert_function_statement = nullptr;
     sqlite3_stmt *insert_argument_statement = nullptr;
     sqlite3_stmt *insert_call_statement = nullptr;
+    sqlite3_stmt *insert_builtin_count_statement = nullptr;
+    sqlite3_stmt *insert_srcfile_statement = nullptr;
+    sqlite3_stmt *insert_callsite_statement = nullptr;
     sqlite3_stmt *insert_promise_statement = nullptr;
     sqlite3_stmt *insert_promise_association_statement = nullptr;
     sqlite3_stmt *insert_promise_evaluation_statement = nullptr;
@@ -73,6 +114,9 @@ class SqlSerializer {
     sqlite3_stmt *insert_promise_lifecycle_statement = nullptr;
     sqlite3_stmt *insert_gc_trigger_statement = nullptr;
     sqlite3_stmt *insert_type_distribution_statement = nullptr;
+    sqlite3_stmt *insert_promise_retirement_statement = nullptr;
+    sqlite3_stmt *insert_tracer_footprint_statement = nullptr;
+    sqlite3_stmt *insert_fork_statement = nullptr;
 };
 
 #endif /* __SQL_SERIALIZER__ */
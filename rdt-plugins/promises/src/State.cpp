@@ -1,4 +1,5 @@
 #include "State.hpp"
+#include <algorithm>
 
 void tracer_state_t::start_pass(const SEXP prom) {
     reset();
@@ -75,10 +76,351 @@ void tracer_state_t::adjust_stacks(SEXP rho, unwind_info_t &info) {
 //    }
 //}
 
+// Estimates of the memory held by a table: one node per entry (the value and
+// the links of the node) plus the bucket array of unordered containers.
+template <typename T> static size_t unordered_table_size(const T &table) {
+    return table.size() *
+               (sizeof(typename T::value_type) + 2 * sizeof(void *)) +
+           table.bucket_count() * sizeof(void *);
+}
+
+template <typename T> static size_t ordered_table_size(const T &table) {
+    return table.size() *
+           (sizeof(typename T::value_type) + 4 * sizeof(void *));
+}
+
+void tracer_state_t::touch_promise(prom_id_t prom_id) {
+    if (promise_retirement_epochs > 0 || promise_memory_limit > 0)
+        promise_lookup_gc_trigger_counter[prom_id] = gc_trigger_counter;
+}
+
+void tracer_state_t::forget_promise(prom_id_t prom_id) {
+    promise_origin.erase(prom_id);
+    fresh_promises.erase(prom_id);
+    promise_lookup_gc_trigger_counter.erase(prom_id);
+    already_inserted_negative_promises.erase(prom_id);
+}
+
+size_t tracer_state_t::promise_tables_size() const {
+    return unordered_table_size(promise_origin) +
+           unordered_table_size(fresh_promises) +
+           unordered_table_size(promise_ids) +
+           unordered_table_size(promise_lookup_gc_trigger_counter) +
+           unordered_table_size(already_inserted_negative_promises) +
+           unordered_table_size(retired_promises);
+}
+
+void tracer_state_t::retire_promise(prom_id_t prom_id, int last_touched,
+                                    retirement_reason reason,
+                                    vector<prom_retirement_info_t> &retired) {
+    prom_retirement_info_t info;
+    auto origin = promise_origin.find(prom_id);
+    info.prom_id = prom_id;
+    info.from_call_id = origin == promise_origin.end() ? 0 : origin->second;
+    info.last_touched = last_touched;
+    info.reason = reason;
+    info.gc_trigger_counter = gc_trigger_counter;
+    retired.push_back(info);
+
+    promise_origin.erase(prom_id);
+    fresh_promises.erase(prom_id);
+    already_inserted_negative_promises.erase(prom_id);
+}
+
+void tracer_state_t::retire_promises(vector<prom_retirement_info_t> &retired) {
+    auto &last_touched = promise_lookup_gc_trigger_counter;
+
+    // Sweeping is linear in the number of live promises, so it is only done
+    // once per epoch length rather than at every collection.
+    if (promise_retirement_epochs > 0 &&
+        gc_trigger_counter % promise_retirement_epochs == 0) {
+        for (auto it = last_touched.begin(); it != last_touched.end();) {
+            if (gc_trigger_counter - it->second >= promise_retirement_epochs) {
+                retire_promise(it->first, it->second, retirement_reason::EPOCH,
+                               retired);
+                it = last_touched.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (promise_memory_limit > 0 &&
+        promise_tables_size() > promise_memory_limit) {
+        // Evict the ccoldest promises until the tables are back at three
+        // quarters of the limit, so that we do not evict at every collection.
+        vector<pair<int, prom_id_t>> ccoldest;
+        ccoldest.reserve(last_touched.size());
+        for (auto const &entry : last_touched)
+            ccoldest.emplace_back(entry.second, entry.first);
+        sort(ccoldest.begin(), ccoldest.end());
+
+        size_t size = promise_tables_size();
+        size_t target = promise_memory_limit / 4 * 3;
+        size_t entry_size = max(size / max(ccoldest.size(), size_t(1)),
+                                size_t(1));
+        size_t count = min(ccoldest.size(), (size - target) / entry_size + 1);
+
+        for (size_t i = 0; i < count; ++i) {
+            retire_promise(ccoldest[i].second, ccoldest[i].first,
+                           retirement_reason::CEILING, retired);
+            last_touched.erase(ccoldest[i].second);
+        }
+    }
+
+    if (retired.empty())
+        return;
+
+    // promise_ids is keyed by address, so it needs a pass of its own. The
+    // promises may still be alive, their identity moves to retired_promises.
+    unordered_map<prom_id_t, const prom_retirement_info_t *> retired_ids;
+    for (auto const &info : retired)
+        retired_ids[info.prom_id] = &info;
+    for (auto it = promise_ids.begin(); it != promise_ids.end();) {
+        auto retired_id = retired_ids.find(it->second);
+        if (retired_id != retired_ids.end()) {
+            retired_promises[it->first] = {it->second,
+                                           retired_id->second->from_call_id,
+                                           retired_id->second->last_touched};
+            it = promise_ids.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Erasing does not give back buckets, so the tables are shrunk to what
+    // they hold before they are measured against the limit again.
+    promise_origin.rehash(0);
+    fresh_promises.rehash(0);
+    promise_ids.rehash(0);
+    last_touched.rehash(0);
+    already_inserted_negative_promises.rehash(0);
+
+    if (promise_memory_limit > 0 &&
+        promise_tables_size() > promise_memory_limit) {
+        forget_retired_promises(retired);
+        retired_promises.rehash(0);
+    }
+}
+
+// Retired promises which stay alive without being touched pile up in
+// retired_promises. When they alone keep the tables above
+// promise_memory_limit, the coldest are dropped, down to three quarters of
+// the limit as for live promises.
+void tracer_state_t::forget_retired_promises(
+    vector<prom_retirement_info_t> &retired) {
+    vector<pair<int, prom_key_t>> coldest;
+    coldest.reserve(retired_promises.size());
+    for (auto const &entry : retired_promises)
+        coldest.emplace_back(entry.second.last_touched, entry.first);
+    sort(coldest.begin(), coldest.end(),
+         [](const pair<int, prom_key_t> &a, const pair<int, prom_key_t> &b) {
+             return a.first < b.first;
+         });
+
+    size_t size = promise_tables_size();
+    size_t target = promise_memory_limit / 4 * 3;
+    size_t entry_size =
+        max(unordered_table_size(retired_promises) /
+                max(retired_promises.size(), size_t(1)),
+            size_t(1));
+    size_t count = min(coldest.size(), (size - target) / entry_size + 1);
+
+    for (size_t i = 0; i < count; ++i) {
+        auto it = retired_promises.find(coldest[i].second);
+        prom_retirement_info_t info;
+        info.prom_id = it->second.prom_id;
+        info.from_call_id = it->second.from_call_id;
+        info.last_touched = it->second.last_touched;
+        info.reason = retirement_reason::FORGOTTEN;
+        info.gc_trigger_counter = gc_trigger_counter;
+        retired.push_back(info);
+        retired_promises.erase(it);
+    }
+}
+
+bool tracer_state_t::revive_promise(const prom_key_t &key,
+                                    prom_id_t &prom_id) {
+    auto it = retired_promises.find(key);
+    if (it == retired_promises.end())
+        return false;
+
+    retired_promise_t promise = it->second;
+    retired_promises.erase(it);
+    promise_ids[key] = promise.prom_id;
+    promise_origin[promise.prom_id] = promise.from_call_id;
+    if (promise.prom_id < 0)
+        already_inserted_negative_promises.insert(promise.prom_id);
+    touch_promise(promise.prom_id);
+    prom_id = promise.prom_id;
+    return true;
+}
+
+bool tracer_state_t::is_aggregated_builtin(const SEXP op) {
+    // In the weird case of NewBuiltin2, op is a language expression and has
+    // no PRIMOFFSET.
+    if (!aggregate_builtins ||
+        (TYPEOF(op) != BUILTINSXP && TYPEOF(op) != SPECIALSXP))
+        return false;
+
+    size_t offset = PRIMOFFSET(op);
+    if (offset >= builtin_aggregation.size())
+        builtin_aggregation.resize(offset + 1, 0);
+    if (builtin_aggregation[offset] == 0)
+        builtin_aggregation[offset] =
+            traced_builtins.count(PRIMNAME(op)) > 0 ? 2 : 1;
+
+    return builtin_aggregation[offset] == 1;
+}
+
+callsite_id_t tracer_state_t::get_callsite_id(SEXP call, SEXP srcref) {
+    auto it = callsite_ids.find(call);
+    if (it != callsite_ids.end())
+        return it->second;
+
+    // One preserved cell holds all references, R_ReleaseObject is linear in
+    // the number of preserved objects.
+    if (callsite_anchor == R_NilValue) {
+        callsite_anchor = Rf_cons(R_NilValue, R_NilValue);
+        R_PreserveObject(callsite_anchor);
+    }
+
+    if (srcref == NULL || TYPEOF(srcref) != INTSXP || LENGTH(srcref) < 6)
+        srcref = R_NilValue;
+
+    SETCDR(callsite_anchor, Rf_cons(call, CDR(callsite_anchor)));
+    SETCDR(callsite_anchor, Rf_cons(srcref, CDR(callsite_anchor)));
+
+    callsite_id_t callsite_id = callsite_id_offset + callsites.size();
+    callsites.push_back(make_pair(call, srcref));
+    callsite_ids[call] = callsite_id;
+    return callsite_id;
+}
+
+bool tracer_state_t::has_full_callsite_batch() const {
+    return callsites.size() >= CALLSITE_BATCH_SIZE;
+}
+
+// Deparses the pending callsites. srcfiles receives only the files not
+// returned by an earlier batch.
+void tracer_state_t::get_callsites(vector<srcfile_info_t> &srcfiles,
+                                   vector<callsite_info_t> &infos) {
+    SEXP filename_symbol = Rf_install("filename");
+
+    for (size_t i = 0; i < callsites.size(); ++i) {
+        SEXP call = callsites[i].first;
+        SEXP srcref = callsites[i].second;
+
+        callsite_info_t info;
+        info.callsite_id = callsite_id_offset + i;
+        info.callsite = get_expression(call);
+        info.srcfile_id = -1;
+        info.first_line = info.first_column = 0;
+        info.last_line = info.last_column = 0;
+
+        if (srcref != R_NilValue) {
+            info.first_line = INTEGER(srcref)[0];
+            info.first_column = INTEGER(srcref)[4];
+            info.last_line = INTEGER(srcref)[2];
+            info.last_column = INTEGER(srcref)[5];
+
+            SEXP srcfile = dyntrace_get_attribute(srcref, R_SrcfileSymbol);
+            if (TYPEOF(srcfile) == ENVSXP) {
+                auto it = srcfile_ids.find(srcfile);
+                if (it == srcfile_ids.end()) {
+                    if (srcfile_anchor == R_NilValue) {
+                        srcfile_anchor = Rf_cons(R_NilValue, R_NilValue);
+                        R_PreserveObject(srcfile_anchor);
+                    }
+                    SETCDR(srcfile_anchor, Rf_cons(srcfile, CDR(srcfile_anchor)));
+
+                    srcfile_info_t srcfile_info;
+                    srcfile_info.srcfile_id = srcfile_ids.size();
+                    SEXP filename = Rf_findVarInFrame(srcfile, filename_symbol);
+                    if (TYPEOF(filename) == STRSXP && LENGTH(filename) > 0)
+                        srcfile_info.filename = CHAR(STRING_ELT(filename, 0));
+                    srcfiles.push_back(srcfile_info);
+                    srcfile_ids[srcfile] = srcfile_info.srcfile_id;
+                    info.srcfile_id = srcfile_info.srcfile_id;
+                } else {
+                    info.srcfile_id = it->second;
+                }
+            }
+        }
+
+        infos.push_back(info);
+    }
+}
+
+void tracer_state_t::release_callsites() {
+    if (callsite_anchor != R_NilValue)
+        R_ReleaseObject(callsite_anchor);
+    callsite_anchor = R_NilValue;
+    callsite_id_offset += callsites.size();
+    callsite_ids.clear();
+    callsites.clear();
+}
+
+void tracer_state_t::release_srcfiles() {
+    if (srcfile_anchor != R_NilValue)
+        R_ReleaseObject(srcfile_anchor);
+    srcfile_anchor = R_NilValue;
+    srcfile_ids.clear();
+}
+
+void tracer_state_t::get_footprint(vector<footprint_info_t> &footprint) const {
+    footprint.push_back({"promise_origin", promise_origin.size(),
+                         unordered_table_size(promise_origin),
+                         gc_trigger_counter});
+    footprint.push_back({"fresh_promises", fresh_promises.size(),
+                         unordered_table_size(fresh_promises),
+                         gc_trigger_counter});
+    footprint.push_back({"promise_ids", promise_ids.size(),
+                         unordered_table_size(promise_ids),
+                         gc_trigger_counter});
+    footprint.push_back(
+        {"promise_lookup_gc_trigger_counter",
+         promise_lookup_gc_trigger_counter.size(),
+         unordered_table_size(promise_lookup_gc_trigger_counter),
+         gc_trigger_counter});
+    footprint.push_back({"retired_promises", retired_promises.size(),
+                         unordered_table_size(retired_promises),
+                         gc_trigger_counter});
+    footprint.push_back(
+        {"already_inserted_negative_promises",
+         already_inserted_negative_promises.size(),
+         unordered_table_size(already_inserted_negative_promises),
+         gc_trigger_counter});
+    footprint.push_back({"function_ids", function_ids.size(),
+                         unordered_table_size(function_ids),
+                         gc_trigger_counter});
+    footprint.push_back({"already_inserted_functions",
+                         already_inserted_functions.size(),
+                         unordered_table_size(already_inserted_functions),
+                         gc_trigger_counter});
+    footprint.push_back({"argument_ids", argument_ids.size(),
+                         ordered_table_size(argument_ids),
+                         gc_trigger_counter});
+    footprint.push_back({"callsite_ids", callsite_ids.size(),
+                         unordered_table_size(callsite_ids) +
+                             callsites.capacity() * sizeof(pair<SEXP, SEXP>),
+                         gc_trigger_counter});
+    footprint.push_back({"srcfile_ids", srcfile_ids.size(),
+                         unordered_table_size(srcfile_ids),
+                         gc_trigger_counter});
+}
+
 tracer_state_t::tracer_state_t(const std::string database_path,
-                               const std::string schema_path,
-                               bool verbose = false)
-    : database_path(database_path), schema_path(schema_path), verbose(verbose) {
+                               const std::string schema_path, bool verbose,
+                               int promise_retirement_epochs,
+                               size_t promise_memory_limit,
+                               bool aggregate_builtins,
+                               const vector<string> &traced_builtins)
+    : promise_retirement_epochs(promise_retirement_epochs),
+      promise_memory_limit(promise_memory_limit),
+      aggregate_builtins(aggregate_builtins),
+      traced_builtins(traced_builtins.begin(), traced_builtins.end()),
+      database_path(database_path), schema_path(schema_path), verbose(verbose) {
     indent = 0;
     clock_id = 0;
     call_id_counter = 0;
@@ -87,6 +429,9 @@ tracer_state_t::tracer_state_t(const std::string database_path,
     prom_neg_id_counter = 0;
     argument_id_sequence = 0;
     gc_trigger_counter = 0;
+    callsite_id_offset = 0;
+    callsite_anchor = R_NilValue;
+    srcfile_anchor = R_NilValue;
 }
 
 const std::string &tracer_state_t::get_database_filepath() const {
@@ -99,6 +444,22 @@ const std::string &tracer_state_t::get_schema_filepath() const {
 
 bool tracer_state_t::get_verbosity_state() const { return verbose; }
 
+call_id_t tracer_state_t::get_fork_id_base(pid_t pid) {
+    return (call_id_t)pid << FORK_ID_SHIFT;
+}
+
+void tracer_state_t::fork_child(pid_t pid) {
+    call_id_t id_base = get_fork_id_base(pid);
+    call_id_counter = id_base;
+    prom_id_counter = id_base;
+    prom_neg_id_counter = -(prom_id_t)id_base;
+    argument_id_sequence = id_base;
+    // the parent writes the counts of its calls up to the fork
+    builtin_counters.clear();
+    already_inserted_functions.clear();
+    already_inserted_negative_promises.clear();
+}
+
 void tracer_state_t::reset() {
     clock_id = 0;
     call_id_counter = 0;
@@ -107,10 +468,12 @@ void tracer_state_t::reset() {
     prom_neg_id_counter = 0;
     argument_id_sequence = 0;
     gc_trigger_counter = 0;
+    callsite_id_offset = 0;
     already_inserted_functions.clear();
     already_inserted_negative_promises.clear();
     promise_lookup_gc_trigger_counter.clear();
     function_ids.clear();
     argument_ids.clear();
     promise_ids.clear();
+    retired_promises.clear();
 }
@@ -2,9 +2,10 @@
 #define __STATE_HPP__
 
 #include <functional>
+#include "utilities.hpp"
 #include <map>
-#include <r.h>
 #include <stack>
+#include <sys/types.h>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
@@ -36,6 +37,9 @@ typedef unsigned long int arg_id_t; // integer
 
 typedef int event_t;
 
+typedef int callsite_id_t; // integer, index into tracer_state_t::callsites
+typedef int srcfile_id_t;  // integer
+
 typedef pair<call_id_t, string> arg_key_t;
 
 rid_t get_sexp_address(SEXP e);
@@ -129,9 +133,9 @@ struct call_info_t {
     function_type fn_type;
     fn_id_t fn_id;
     fn_addr_t fn_addr; // TODO unnecessary?
-    string fn_definition;
-    string loc;
-    string callsite;
+    string fn_definition; // only set if the function was not inserted yet
+    string loc;           // only set if the function was not inserted yet
+    callsite_id_t callsite_id = -1;
     bool fn_compiled;
 
     string name; // fully qualified function name, if available
@@ -218,6 +222,12 @@ struct closure_info_t : call_info_t {
 
 struct builtin_info_t : call_info_t {};
 
+// Number of calls to one builtin or special made directly from the call
+// parent_call_id, used instead of per-call rows when aggregate_builtins is on.
+struct builtin_count_info_t : call_info_t {
+    unsigned long count = 0;
+};
+
 // FIXME would it make sense to add type of action here?
 struct prom_basic_info_t {
     prom_id_t prom_id;
@@ -240,6 +250,22 @@ struct prom_info_t : prom_basic_info_t {
     sexp_type return_type;
 };
 
+// Written once per distinct call when the trace is finished.
+struct callsite_info_t {
+    callsite_id_t callsite_id;
+    string callsite; // deparsed call
+    srcfile_id_t srcfile_id; // -1 if the call has no srcref
+    int first_line;
+    int first_column;
+    int last_line;
+    int last_column;
+};
+
+struct srcfile_info_t {
+    srcfile_id_t srcfile_id;
+    string filename;
+};
+
 struct unwind_info_t {
     vector<call_id_t> unwound_calls;
     vector<prom_id_t> unwound_promises;
@@ -257,6 +283,47 @@ struct prom_gc_info_t {
     int gc_trigger_counter;
 };
 
+enum class retirement_reason {
+    EPOCH = 0,   // not touched for promise_retirement_epochs collections
+    CEILING = 1, // evicted because the promise tables hit promise_memory_limit
+    FORGOTTEN = 2 // retired entry dropped to stay under promise_memory_limit,
+                  // later events of the promise get a fresh ID
+};
+
+// What is kept of a retired promise until it is unmarked, so that its later
+// events keep its ID and origin.
+struct retired_promise_t {
+    prom_id_t prom_id;
+    call_id_t from_call_id;
+    int last_touched;
+};
+
+struct prom_retirement_info_t {
+    prom_id_t prom_id;
+    call_id_t from_call_id;
+    int last_touched; // gc_trigger_counter at the last event of the promise
+    retirement_reason reason;
+    int gc_trigger_counter;
+};
+
+// Size of one of the tracer's own tables, reported at every gc_exit.
+struct footprint_info_t {
+    string table;
+    size_t entries;
+    size_t bytes; // estimate, includes node and bucket overhead
+    int gc_trigger_counter;
+};
+
+// A child forked by parallel, recorded by the parent. The child writes its
+// events to segment and numbers its calls, promises and arguments from
+// id_base, see tracer_state_t::fork_child.
+struct fork_info_t {
+    pid_t child_pid;
+    call_id_t call_id; // innermost call of the parent at the fork
+    call_id_t id_base;
+    string segment;
+};
+
 struct type_gc_info_t {
     int gc_trigger_counter;
     int type;
@@ -279,6 +346,15 @@ bool negative_promise_already_inserted(prom_id_t id);
 // Wraper for findVar. Does not look up the value if it already is PROMSXP.
 SEXP get_promise(SEXP var, SEXP rho);
 
+// Name of a symbol, of a primitive, or of the function of a call. NULL for
+// anything else, e.g. anonymous calls.
+const char *get_name(SEXP sexp);
+// Deparsed expression, also used to identify functions.
+string get_expression(SEXP sexp);
+// file:line:column of the srcref of a closure, "" if it has none.
+string get_location(SEXP op);
+bool is_byte_compiled(SEXP op);
+
 template <typename T>
 void get_stack_parent(T &info, vector<stack_event_t> &stack) {
     // put the body here
@@ -343,7 +419,60 @@ struct tracer_state_t {
     unordered_set<prom_id_t> fresh_promises;
     // Map from promise address to promise ID;
     unordered_map<prom_key_t, prom_id_t, prom_id_triple_hash> promise_ids;
+    // Map from promise ID to the gc_trigger_counter of the last event seen for
+    // that promise. Only maintained when retirement is enabled.
     unordered_map<prom_id_t, int> promise_lookup_gc_trigger_counter;
+    unordered_map<prom_key_t, retired_promise_t, prom_id_triple_hash>
+        retired_promises;
+
+    // Promise metadata is normally dropped when gc_promise_unmarked fires.
+    // Promises which are never unmarked in a traced pass (or which live for
+    // the whole pass) are retired once they have not been touched for
+    // promise_retirement_epochs collections, and the coldest promises are
+    // evicted when the tables above exceed promise_memory_limit bytes.
+    // Retired promises are written to the trace and their entries in the
+    // tables above collapse into one entry of retired_promises, which the
+    // next event of the promise moves back. Those entries count against
+    // promise_memory_limit too, the oldest are forgotten when retiring live
+    // promises is not enough. Zero disables either check.
+    int promise_retirement_epochs;
+    size_t promise_memory_limit;
+
+    // When aggregate_builtins is set, builtins and specials whose names are
+    // not in traced_builtins are not recorded call by call. Their calls are
+    // counted per calling closure (indexed by PRIMOFFSET) and written out
+    // when that closure exits.
+    bool aggregate_builtins;
+    unordered_set<string> traced_builtins;
+    unordered_map<call_id_t, unordered_map<int, builtin_count_info_t>>
+        builtin_counters;
+    // Per PRIMOFFSET: 0 unknown, 1 aggregated, 2 traced call by call.
+    vector<char> builtin_aggregation;
+
+    bool is_aggregated_builtin(const SEXP op);
+
+    // Calls record only a callsite ID. The call and the srcref current when
+    // it was first seen are kept alive on callsite_anchor until they are
+    // deparsed, see get_callsites. That happens when the trace finishes or,
+    // from an entry hook, once CALLSITE_BATCH_SIZE callsites are pending, so
+    // that programs building calls at run time do not keep all of them
+    // alive. A call seen again after its batch was released gets a new ID.
+    static const size_t CALLSITE_BATCH_SIZE = 4096;
+    unordered_map<SEXP, callsite_id_t> callsite_ids;
+    vector<pair<SEXP, SEXP>> callsites; // pending (call, srcref), ID - offset
+    callsite_id_t callsite_id_offset;   // ID of callsites[0]
+    SEXP callsite_anchor;
+    // Srcfile environments stay preserved on srcfile_anchor for the whole
+    // trace so that their IDs hold across batches.
+    unordered_map<SEXP, srcfile_id_t> srcfile_ids;
+    SEXP srcfile_anchor;
+
+    callsite_id_t get_callsite_id(SEXP call, SEXP srcref);
+    bool has_full_callsite_batch() const;
+    void get_callsites(vector<srcfile_info_t> &srcfiles,
+                       vector<callsite_info_t> &infos);
+    void release_callsites();
+    void release_srcfiles();
 
     call_id_t call_id_counter; // IDs assigned should be globally unique but we
                                // can reset it after each pass if overwrite is
@@ -362,11 +491,8 @@ struct tracer_state_t {
     unordered_set<fn_id_t> already_inserted_functions; // Should be kept across
                                                        // Rdt calls (unless
                                                        // overwrite is true)
-    unordered_set<fn_id_t> already_inserted_negative_promises; // Should be kept
-                                                               // across Rdt
-                                                               // calls (unless
-                                                               // overwrite is
-                                                               // true)
+    // Should be kept across Rdt calls (unless overwrite is true)
+    unordered_set<prom_id_t> already_inserted_negative_promises;
     arg_id_t argument_id_sequence; // Should be globally unique (can reset
                                    // between tracer calls if overwrite is true)
     map<arg_key_t, arg_id_t> argument_ids; // Should be kept across Rdt calls
@@ -382,8 +508,34 @@ struct tracer_state_t {
     void adjust_stacks(SEXP rho, unwind_info_t &info);
     //    void adjust_prom_stack(SEXP rho, vector<prom_id_t> & unwound_prom);
 
+    // Records an event for the promise (creation, force or lookup) in the
+    // current gc epoch.
+    void touch_promise(prom_id_t prom_id);
+    // Drops all metadata about the promise, called when it is unmarked.
+    void forget_promise(prom_id_t prom_id);
+    // Restores the metadata of the retired promise at key and sets prom_id
+    // to its ID. False if there is none.
+    bool revive_promise(const prom_key_t &key, prom_id_t &prom_id);
+    // Called at gc_exit, retires cold promises and returns them.
+    void retire_promises(vector<prom_retirement_info_t> &retired);
+    void forget_retired_promises(vector<prom_retirement_info_t> &retired);
+    void get_footprint(vector<footprint_info_t> &footprint) const;
+
+    // Forked children number calls, promises and arguments from
+    // pid << FORK_ID_SHIFT, a range neither the parent (which stays below
+    // 2^40) nor any other live child uses. Function and callsite IDs stay
+    // local to the segment of each process.
+    static const int FORK_ID_SHIFT = 40;
+    static call_id_t get_fork_id_base(pid_t pid);
+    // Called in a child after the fork: moves the counters to the range of
+    // pid and forgets which functions and promises the parent has written,
+    // so that the segment of the child is self-contained.
+    void fork_child(pid_t pid);
+
     tracer_state_t(std::string database_path, std::string schema_path,
-                   bool verbose);
+                   bool verbose, int promise_retirement_epochs,
+                   size_t promise_memory_limit, bool aggregate_builtins,
+                   const vector<string> &traced_builtins);
 
     const std::string &get_database_filepath() const;
 
@@ -393,6 +545,10 @@ struct tracer_state_t {
 
   private:
     void reset();
+    size_t promise_tables_size() const;
+    void retire_promise(prom_id_t prom_id, int last_touched,
+                        retirement_reason reason,
+                        vector<prom_retirement_info_t> &retired);
 
     std::string database_path;
     std::string schema_path;
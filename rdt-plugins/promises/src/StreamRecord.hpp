@@ -0,0 +1,214 @@
+#ifndef __STREAM_RECORD_HPP__
+#define __STREAM_RECORD_HPP__
+
+// Wire format of the binary event stream written by StreamSerializer.
+//
+// The stream is a sequence of records. Every record starts with a fixed size
+// stream_record_header_t followed by `size` bytes of payload. Fixed size
+// payloads are the packed structs below; records carrying text (METADATA,
+// FUNCTION, TRACER_FOOTPRINT, SRCFILE, CALLSITE and FORK) append the text after the
+// struct without a terminating NUL. All integers are in host byte order, the
+// stream is meant for consumers running on the same machine.
+//
+// This header is shared with the tools in tools/ and must not depend on R
+// headers.
+
+#include <cstddef>
+#include <cstdint>
+
+#define RDT_STREAM_MAGIC 0x53544452 // "RDTS"
+#define RDT_STREAM_VERSION 3
+
+enum class stream_record_type : uint16_t {
+    HELLO = 0,
+    METADATA = 1,
+    FUNCTION = 2,
+    FUNCTION_ENTRY = 3,
+    FUNCTION_EXIT = 4,
+    BUILTIN_ENTRY = 5,
+    BUILTIN_EXIT = 6,
+    PROMISE_CREATED = 7,
+    PROMISE_FORCE_ENTRY = 8,
+    PROMISE_FORCE_EXIT = 9,
+    PROMISE_LOOKUP = 10,
+    PROMISE_EXPRESSION_LOOKUP = 11,
+    PROMISE_LIFECYCLE = 12,
+    VECTOR_ALLOC = 13,
+    GC_EXIT = 14,
+    UNWIND = 15,
+    STATISTICS = 16,
+    PROMISE_RETIREMENT = 17,
+    TRACER_FOOTPRINT = 18,
+    BUILTIN_COUNT = 19,
+    SRCFILE = 20,
+    CALLSITE = 21,
+    FORK = 22,
+
+    // number of record types, not a record type
+    COUNT = 23
+};
+
+#pragma pack(push, 1)
+
+struct stream_record_header_t {
+    uint16_t type;
+    uint16_t reserved;
+    uint32_t size; // payload size in bytes, excluding this header
+};
+
+struct stream_hello_record_t {
+    uint32_t magic;
+    uint32_t version;
+    int32_t pid;
+};
+
+// followed by key_size bytes of key and value_size bytes of value
+struct stream_metadata_record_t {
+    uint32_t key_size;
+    uint32_t value_size;
+};
+
+// sent once per function id, followed by the function name
+struct stream_function_record_t {
+    int32_t fn_id;
+    uint8_t fn_type;
+    uint8_t compiled;
+    // rdt_definition_hash of the deparsed definition (functions.definition in
+    // trace databases), fn_id is only unique within a trace
+    uint64_t definition_hash;
+};
+
+// used for FUNCTION_ENTRY, FUNCTION_EXIT, BUILTIN_ENTRY and BUILTIN_EXIT
+struct stream_call_record_t {
+    uint64_t timestamp; // nanoseconds since the start of the trace
+    uint64_t call_id;
+    uint64_t parent_call_id;
+    int64_t in_prom_id;
+    int32_t fn_id;
+    int32_t callsite_id; // -1 on exit records, see CALLSITE
+    uint8_t fn_type;
+    uint8_t recursion;
+};
+
+// followed by the file name
+struct stream_srcfile_record_t {
+    int32_t srcfile_id;
+};
+
+// sent for every distinct callsite in batches and when the trace finishes,
+// followed by the deparsed call
+struct stream_callsite_record_t {
+    int32_t callsite_id;
+    int32_t srcfile_id; // -1 if the call has no srcref
+    int32_t first_line;
+    int32_t first_column;
+    int32_t last_line;
+    int32_t last_column;
+};
+
+// calls to fn_id made directly from call_id, with aggregate_builtins
+struct stream_builtin_count_record_t {
+    uint64_t call_id;
+    uint64_t count;
+    int32_t fn_id;
+};
+
+struct stream_promise_created_record_t {
+    uint64_t timestamp;
+    int64_t prom_id;
+    int64_t in_prom_id;
+    int32_t depth;
+    uint8_t prom_type;
+};
+
+// used for PROMISE_FORCE_ENTRY, PROMISE_LOOKUP and PROMISE_EXPRESSION_LOOKUP
+struct stream_promise_evaluation_record_t {
+    uint64_t timestamp;
+    int64_t prom_id;
+    uint64_t from_call_id;
+    uint64_t in_call_id;
+    int64_t in_prom_id;
+    int32_t clock_id;
+    int32_t effective_distance_from_origin;
+    int32_t actual_distance_from_origin;
+    int32_t depth;
+    uint8_t lifestyle;
+};
+
+struct stream_promise_force_exit_record_t {
+    uint64_t timestamp;
+    int64_t prom_id;
+    int32_t clock_id;
+    uint8_t return_type;
+};
+
+struct stream_promise_lifecycle_record_t {
+    int64_t prom_id;
+    int32_t event;
+    int32_t gc_trigger_counter;
+};
+
+struct stream_vector_alloc_record_t {
+    uint64_t call_id; // innermost call on the tracer's stack
+    int64_t length;
+    int64_t bytes;
+    int32_t gc_trigger_counter;
+    int32_t type;
+};
+
+struct stream_gc_exit_record_t {
+    uint64_t timestamp;
+    double ncells;
+    double vcells;
+    int32_t counter;
+};
+
+struct stream_unwind_record_t {
+    uint64_t timestamp;
+    uint32_t unwound_calls;
+    uint32_t unwound_promises;
+};
+
+struct stream_promise_retirement_record_t {
+    int64_t prom_id;
+    uint64_t from_call_id;
+    int32_t last_touched;
+    int32_t gc_trigger_counter;
+    uint8_t reason;
+};
+
+// followed by the name of the table
+struct stream_tracer_footprint_record_t {
+    uint64_t entries;
+    uint64_t bytes;
+    int32_t gc_trigger_counter;
+};
+
+// a child forked by parallel, followed by the path of the stream the child
+// writes to; see fork_info_t
+struct stream_fork_record_t {
+    uint64_t timestamp;
+    uint64_t call_id;
+    uint64_t id_base;
+    int32_t pid;
+};
+
+// last record of a stream; counts are indexed by stream_record_type
+struct stream_statistics_record_t {
+    uint64_t emitted[static_cast<int>(stream_record_type::COUNT)];
+    uint64_t dropped[static_cast<int>(stream_record_type::COUNT)];
+};
+
+#pragma pack(pop)
+
+// 64 bit FNV-1a
+inline uint64_t rdt_definition_hash(const char *definition, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(definition[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+#endif /* __STREAM_RECORD_HPP__ */
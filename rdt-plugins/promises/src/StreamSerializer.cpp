@@ -0,0 +1,526 @@
+#include "StreamSerializer.hpp"
+#include "globals.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const char *stream_record_type_names[] = {
+    "hello",
+    "metadata",
+    "function",
+    "function_entry",
+    "function_exit",
+    "builtin_entry",
+    "builtin_exit",
+    "promise_created",
+    "promise_force_entry",
+    "promise_force_exit",
+    "promise_lookup",
+    "promise_expression_lookup",
+    "promise_lifecycle",
+    "vector_alloc",
+    "gc_exit",
+    "unwind",
+    "statistics",
+    "promise_retirement",
+    "tracer_footprint",
+    "builtin_count",
+    "srcfile",
+    "callsite",
+    "fork"};
+
+static_assert(sizeof(stream_record_type_names) / sizeof(const char *) ==
+                  static_cast<int>(stream_record_type::COUNT),
+              "every stream record type needs a name");
+
+stream_policy string_to_stream_policy(const std::string &policy) {
+    if (policy == "block")
+        return stream_policy::BLOCK;
+    return stream_policy::DROP;
+}
+
+StreamSerializer::StreamSerializer(const std::string &stream_path,
+                                   stream_policy policy, size_t buffer_size,
+                                   int block_timeout, bool verbose)
+    : stream_path(stream_path), policy(policy),
+      block_timeout(std::max(block_timeout, 0)),
+      verbose(verbose), buffer(buffer_size) {
+    // Hand data to the kernel in reasonably large chunks but early enough
+    // that a burst of events does not immediately fill the buffer.
+    flush_threshold = std::min<size_t>(64 * 1024, buffer_size / 2);
+    memset(&statistics, 0, sizeof(statistics));
+    start_time = std::chrono::steady_clock::now();
+    open_stream(stream_path);
+
+    stream_hello_record_t hello;
+    hello.magic = RDT_STREAM_MAGIC;
+    hello.version = RDT_STREAM_VERSION;
+    hello.pid = getpid();
+    emit(stream_record_type::HELLO, {{&hello, sizeof(hello)}});
+}
+
+StreamSerializer::~StreamSerializer() { close_stream(); }
+
+// One attempt to connect to the consumer. Returns -1 with errno set if there
+// is none yet.
+static int connect_stream(const std::string &stream_path, bool &is_socket) {
+    struct stat status;
+    int descriptor;
+
+    if (stat(stream_path.c_str(), &status) == 0 && S_ISFIFO(status.st_mode)) {
+        // Without O_NONBLOCK, opening a FIFO for writing waits for the
+        // consumer to open it for reading; with it, the open fails with
+        // ENXIO instead.
+        is_socket = false;
+        return open(stream_path.c_str(), O_WRONLY | O_NONBLOCK);
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, stream_path.c_str(),
+            sizeof(address.sun_path) - 1);
+
+    is_socket = true;
+    descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (descriptor != -1 &&
+        connect(descriptor, (struct sockaddr *)&address, sizeof(address)) ==
+            -1) {
+        int error = errno;
+        close(descriptor);
+        errno = error;
+        descriptor = -1;
+    }
+    return descriptor;
+}
+
+// Without a consumer, the policy applies as if the stream were full: DROP
+// gives up at once, BLOCK waits for one for at most block_timeout
+// milliseconds. Either way the trace goes on, with every event counted as
+// dropped.
+void StreamSerializer::open_stream(const std::string &stream_path) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(block_timeout);
+
+    while ((descriptor = connect_stream(stream_path, is_socket)) == -1 &&
+           (errno == ENXIO || errno == ECONNREFUSED || errno == ENOENT) &&
+           policy == stream_policy::BLOCK &&
+           std::chrono::steady_clock::now() < deadline)
+        usleep(10 * 1000);
+
+    if (descriptor == -1) {
+        cerr << "Warning: could not open trace stream " << stream_path
+             << ", message (" << errno << "): " << strerror(errno)
+             << ", dropping all events\n";
+        disconnected = true;
+        return;
+    }
+
+    // Writes to a FIFO without a reader raise SIGPIPE, which would kill R.
+    // Detect that through EPIPE instead.
+    if (!is_socket)
+        previous_sigpipe_handler = signal(SIGPIPE, SIG_IGN);
+
+    fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL) | O_NONBLOCK);
+}
+
+void StreamSerializer::close_stream() {
+    if (descriptor == -1)
+        return;
+
+    close(descriptor);
+    descriptor = -1;
+
+    if (!is_socket)
+        signal(SIGPIPE, previous_sigpipe_handler);
+}
+
+uint64_t StreamSerializer::timestamp() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start_time)
+        .count();
+}
+
+void StreamSerializer::compact() {
+    if (pending_begin == 0)
+        return;
+    memmove(buffer.data(), buffer.data() + pending_begin,
+            pending_end - pending_begin);
+    pending_end -= pending_begin;
+    pending_begin = 0;
+}
+
+void StreamSerializer::disconnect() {
+    if (verbose)
+        cerr << "Warning: trace stream consumer disconnected ("
+             << strerror(errno) << "), dropping remaining events\n";
+    disconnected = true;
+    lost_bytes += pending_end - pending_begin;
+    pending_begin = pending_end = 0;
+}
+
+// Performs one write of the pending bytes. If the consumer is not ready and
+// block is true, waits for it for at most block_timeout milliseconds (not at
+// all if block_timeout is 0). Returns false if nothing could be written.
+bool StreamSerializer::write_pending(bool block) {
+    while (!disconnected && pending_begin < pending_end) {
+        const char *data = buffer.data() + pending_begin;
+        size_t size = pending_end - pending_begin;
+        ssize_t written = is_socket ? send(descriptor, data, size, MSG_NOSIGNAL)
+                                    : write(descriptor, data, size);
+
+        if (written > 0) {
+            pending_begin += written;
+            if (pending_begin == pending_end)
+                pending_begin = pending_end = 0;
+            return true;
+        }
+
+        if (written == -1 && errno == EINTR)
+            continue;
+
+        if (written == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!block)
+                return false;
+
+            struct pollfd request = {descriptor, POLLOUT, 0};
+            int ready = poll(&request, 1, block_timeout);
+            if (ready == 0)
+                return false;
+            if (ready == -1 && errno != EINTR) {
+                disconnect();
+                return false;
+            }
+            continue;
+        }
+
+        disconnect();
+    }
+    return false;
+}
+
+// Makes room for size more bytes in the buffer. Under the DROP policy this
+// never waits; under the BLOCK policy it waits for the consumer to make
+// progress. Returns false if the record has to be dropped.
+bool StreamSerializer::reserve(size_t size) {
+    if (size > buffer.size())
+        return false;
+
+    while (!disconnected) {
+        if (buffer.size() - pending_end >= size)
+            return true;
+        compact();
+        if (buffer.size() - pending_end >= size)
+            return true;
+        if (!write_pending(policy == stream_policy::BLOCK))
+            return false;
+    }
+
+    return false;
+}
+
+void StreamSerializer::emit(stream_record_type type,
+                            std::initializer_list<fragment_t> fragments) {
+    int index = to_underlying_type(type);
+    size_t payload_size = 0;
+
+    for (auto const &fragment : fragments)
+        payload_size += fragment.second;
+
+    stream_record_header_t header;
+    header.type = index;
+    header.reserved = 0;
+    header.size = payload_size;
+
+    if (!reserve(sizeof(header) + payload_size)) {
+        statistics.dropped[index]++;
+        return;
+    }
+
+    memcpy(buffer.data() + pending_end, &header, sizeof(header));
+    pending_end += sizeof(header);
+    for (auto const &fragment : fragments) {
+        memcpy(buffer.data() + pending_end, fragment.first, fragment.second);
+        pending_end += fragment.second;
+    }
+    statistics.emitted[index]++;
+
+    if (pending_end - pending_begin >= flush_threshold)
+        write_pending(false);
+}
+
+void StreamSerializer::emit_metadata(const metadata_t &info) {
+    for (auto const &i : info) {
+        stream_metadata_record_t record;
+        record.key_size = i.first.size();
+        record.value_size = i.second.size();
+        emit(stream_record_type::METADATA,
+             {{&record, sizeof(record)},
+              {i.first.data(), i.first.size()},
+              {i.second.data(), i.second.size()}});
+    }
+}
+
+void StreamSerializer::emit_function(const call_info_t &info) {
+    stream_function_record_t record;
+    record.fn_id = info.fn_id;
+    record.fn_type = to_underlying_type(info.fn_type);
+    record.compiled = info.fn_compiled ? 1 : 0;
+    record.definition_hash = rdt_definition_hash(info.fn_definition.data(),
+                                                 info.fn_definition.size());
+    emit(stream_record_type::FUNCTION,
+         {{&record, sizeof(record)}, {info.name.data(), info.name.size()}});
+}
+
+void StreamSerializer::emit_call(stream_record_type type,
+                                 const call_info_t &info) {
+    stream_call_record_t record;
+    record.timestamp = timestamp();
+    record.call_id = info.call_id;
+    record.parent_call_id = info.parent_call_id;
+    record.in_prom_id = info.in_prom_id;
+    record.fn_id = info.fn_id;
+    record.callsite_id = info.callsite_id;
+    record.fn_type = to_underlying_type(info.fn_type);
+    record.recursion = to_underlying_type(info.recursion);
+    emit(type, {{&record, sizeof(record)}});
+}
+
+void StreamSerializer::emit_promise_evaluation(stream_record_type type,
+                                               const prom_info_t &info,
+                                               int clock_id) {
+    stream_promise_evaluation_record_t record;
+    record.timestamp = timestamp();
+    record.prom_id = info.prom_id;
+    record.from_call_id = info.from_call_id;
+    record.in_call_id = info.in_call_id;
+    record.in_prom_id = info.in_prom_id;
+    record.clock_id = clock_id;
+    record.effective_distance_from_origin = info.effective_distance_from_origin;
+    record.actual_distance_from_origin = info.actual_distance_from_origin;
+    record.depth = info.depth;
+    record.lifestyle = to_underlying_type(info.lifestyle);
+    emit(type, {{&record, sizeof(record)}});
+}
+
+void StreamSerializer::serialize_start_trace(const metadata_t &info) {
+    emit_metadata(info);
+}
+
+void StreamSerializer::serialize_finish_trace(const metadata_t &info) {
+    emit_metadata(info);
+
+    // A snapshot, the statistics record does not count itself.
+    stream_statistics_record_t record = statistics;
+    emit(stream_record_type::STATISTICS, {{&record, sizeof(record)}});
+
+    // Whatever the policy, give the consumer a chance to read the tail of
+    // the trace.
+    while (pending_begin < pending_end && write_pending(true))
+        ;
+
+    report_statistics();
+}
+
+void StreamSerializer::report_statistics() const {
+    uint64_t dropped = 0;
+    for (int i = 0; i < to_underlying_type(stream_record_type::COUNT); ++i)
+        dropped += statistics.dropped[i];
+
+    if (!verbose && dropped == 0 && lost_bytes == 0)
+        return;
+
+    cerr << "Trace stream " << stream_path << ": " << dropped
+         << " events dropped, " << lost_bytes
+         << " bytes lost on disconnect\n";
+
+    for (int i = 0; i < to_underlying_type(stream_record_type::COUNT); ++i) {
+        if (statistics.emitted[i] == 0 && statistics.dropped[i] == 0)
+            continue;
+        cerr << "    " << stream_record_type_names[i] << ": "
+             << statistics.emitted[i] << " emitted, " << statistics.dropped[i]
+             << " dropped\n";
+    }
+}
+
+void StreamSerializer::serialize_function_entry(const closure_info_t &info) {
+    if (register_inserted_function(info.fn_id))
+        emit_function(info);
+    emit_call(stream_record_type::FUNCTION_ENTRY, info);
+}
+
+void StreamSerializer::serialize_function_exit(const closure_info_t &info) {
+    emit_call(stream_record_type::FUNCTION_EXIT, info);
+}
+
+void StreamSerializer::serialize_builtin_entry(const builtin_info_t &info) {
+    if (register_inserted_function(info.fn_id))
+        emit_function(info);
+    emit_call(stream_record_type::BUILTIN_ENTRY, info);
+}
+
+void StreamSerializer::serialize_builtin_exit(const builtin_info_t &info) {
+    emit_call(stream_record_type::BUILTIN_EXIT, info);
+}
+
+void StreamSerializer::serialize_builtin_count(
+    const builtin_count_info_t &info) {
+    if (register_inserted_function(info.fn_id))
+        emit_function(info);
+
+    stream_builtin_count_record_t record;
+    record.call_id = info.parent_call_id;
+    record.count = info.count;
+    record.fn_id = info.fn_id;
+    emit(stream_record_type::BUILTIN_COUNT, {{&record, sizeof(record)}});
+}
+
+void StreamSerializer::serialize_force_promise_entry(const prom_info_t &info,
+                                                     int clock_id) {
+    emit_promise_evaluation(stream_record_type::PROMISE_FORCE_ENTRY, info,
+                            clock_id);
+}
+
+void StreamSerializer::serialize_force_promise_exit(const prom_info_t &info,
+                                                    int clock_id) {
+    stream_promise_force_exit_record_t record;
+    record.timestamp = timestamp();
+    record.prom_id = info.prom_id;
+    record.clock_id = clock_id;
+    record.return_type = to_underlying_type(info.return_type);
+    emit(stream_record_type::PROMISE_FORCE_EXIT, {{&record, sizeof(record)}});
+}
+
+void StreamSerializer::serialize_promise_created(
+    const prom_basic_info_t &info) {
+    stream_promise_created_record_t record;
+    record.timestamp = timestamp();
+    record.prom_id = info.prom_id;
+    record.in_prom_id = info.in_prom_id;
+    record.depth = info.depth;
+    record.prom_type = to_underlying_type(info.prom_type);
+    emit(stream_record_type::PROMISE_CREATED, {{&record, sizeof(record)}});
+}
+
+void StreamSerializer::serialize_promise_lookup(const prom_info_t &info,
+                                                int clock_id) {
+    emit_promise_evaluation(stream_record_type::PROMISE_LOOKUP, info,
+                            clock_id);
+}
+
+void StreamSerializer::serialize_promise_expression_lookup(
+    const prom_info_t &info, int clock_id) {
+    emit_promise_evaluation(stream_record_type::PROMISE_EXPRESSION_LOOKUP,
+                            info, clock_id);
+}
+
+void StreamSerializer::serialize_promise_lifecycle(const prom_gc_info_t &info) {
+    stream_promise_lifecycle_record_t record;
+    record.prom_id = info.promise_id;
+    record.event = info.event;
+    record.gc_trigger_counter = info.gc_trigger_counter;
+    emit(stream_record_type::PROMISE_LIFECYCLE, {{&record, sizeof(record)}});
+}
+
+void StreamSerializer::serialize_vector_alloc(const type_gc_info_t &info) {
+    stream_vector_alloc_record_t record;
+    record.call_id = tracer_state().fun_stack.empty()
+                         ? 0
+                         : get<0>(tracer_state().fun_stack.back());
+    record.length = info.length;
+    record.bytes = info.bytes;
+    record.gc_trigger_counter = info.gc_trigger_counter;
+    record.type = info.type;
+    emit(stream_record_type::VECTOR_ALLOC, {{&record, sizeof(record)}});
+}
+
+void StreamSerializer::serialize_gc_exit(const gc_info_t &info) {
+    stream_gc_exit_record_t record;
+    record.timestamp = timestamp();
+    record.ncells = info.ncells;
+    record.vcells = info.vcells;
+    record.counter = info.counter;
+    emit(stream_record_type::GC_EXIT, {{&record, sizeof(record)}});
+
+    // A collection is a natural pause in the event flow, use it to hand the
+    // buffered events to the consumer.
+    write_pending(false);
+}
+
+void StreamSerializer::serialize_unwind(const unwind_info_t &info) {
+    stream_unwind_record_t record;
+    record.timestamp = timestamp();
+    record.unwound_calls = info.unwound_calls.size();
+    record.unwound_promises = info.unwound_promises.size();
+    emit(stream_record_type::UNWIND, {{&record, sizeof(record)}});
+}
+
+void StreamSerializer::serialize_srcfile(const srcfile_info_t &info) {
+    stream_srcfile_record_t record;
+    record.srcfile_id = info.srcfile_id;
+    emit(stream_record_type::SRCFILE,
+         {{&record, sizeof(record)},
+          {info.filename.data(), info.filename.size()}});
+}
+
+void StreamSerializer::serialize_callsite(const callsite_info_t &info) {
+    stream_callsite_record_t record;
+    record.callsite_id = info.callsite_id;
+    record.srcfile_id = info.srcfile_id;
+    record.first_line = info.first_line;
+    record.first_column = info.first_column;
+    record.last_line = info.last_line;
+    record.last_column = info.last_column;
+    emit(stream_record_type::CALLSITE,
+         {{&record, sizeof(record)},
+          {info.callsite.data(), info.callsite.size()}});
+}
+
+void StreamSerializer::serialize_promise_retirement(
+    const prom_retirement_info_t &info) {
+    stream_promise_retirement_record_t record;
+    record.prom_id = info.prom_id;
+    record.from_call_id = info.from_call_id;
+    record.last_touched = info.last_touched;
+    record.gc_trigger_counter = info.gc_trigger_counter;
+    record.reason = to_underlying_type(info.reason);
+    emit(stream_record_type::PROMISE_RETIREMENT, {{&record, sizeof(record)}});
+}
+
+void StreamSerializer::serialize_tracer_footprint(
+    const footprint_info_t &info) {
+    stream_tracer_footprint_record_t record;
+    record.entries = info.entries;
+    record.bytes = info.bytes;
+    record.gc_trigger_counter = info.gc_trigger_counter;
+    emit(stream_record_type::TRACER_FOOTPRINT,
+         {{&record, sizeof(record)}, {info.table.data(), info.table.size()}});
+}
+
+void StreamSerializer::serialize_fork(const fork_info_t &info) {
+    stream_fork_record_t record;
+    record.timestamp = timestamp();
+    record.call_id = info.call_id;
+    record.id_base = info.id_base;
+    record.pid = info.child_pid;
+    emit(stream_record_type::FORK,
+         {{&record, sizeof(record)},
+          {info.segment.data(), info.segment.size()}});
+}
+
+std::string StreamSerializer::get_segment_filepath(pid_t pid) const {
+    return stream_path + "." + std::to_string(pid);
+}
+
+// The child does not share the stream of the parent: records of both would
+// interleave. It connects to a stream of its own, with the same policy; with
+// no consumer there, its events are dropped.
+Serializer *StreamSerializer::create_segment_serializer(pid_t pid) const {
+    return new StreamSerializer(get_segment_filepath(pid), policy,
+                                buffer.size(), block_timeout, verbose);
+}
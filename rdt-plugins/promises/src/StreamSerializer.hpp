@@ -0,0 +1,102 @@
+#ifndef __STREAM_SERIALIZER__
+#define __STREAM_SERIALIZER__
+
+#include "Serializer.hpp"
+#include "State.hpp"
+#include "StreamRecord.hpp"
+#include "utilities.hpp"
+#include <chrono>
+#include <csignal>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+// What to do with an event when the consumer does not keep up and the
+// stream buffer is full.
+enum class stream_policy {
+    DROP = 0, // discard the event and count it, R never waits
+    BLOCK = 1 // wait for the consumer (at most block_timeout milliseconds)
+};
+
+// Streams binary event records (see StreamRecord.hpp) over a Unix domain
+// socket or a FIFO. Records are staged in a fixed size buffer and written
+// with non-blocking I/O, so a slow consumer only costs R time when the
+// policy is BLOCK.
+class StreamSerializer : public Serializer {
+  public:
+    StreamSerializer(const std::string &stream_path, stream_policy policy,
+                     size_t buffer_size, int block_timeout,
+                     bool verbose = false);
+    ~StreamSerializer() override;
+    void serialize_start_trace(const metadata_t &info) override;
+    void serialize_finish_trace(const metadata_t &info) override;
+    void serialize_function_entry(const closure_info_t &info) override;
+    void serialize_function_exit(const closure_info_t &info) override;
+    void serialize_builtin_entry(const builtin_info_t &info) override;
+    void serialize_builtin_exit(const builtin_info_t &info) override;
+    void serialize_builtin_count(const builtin_count_info_t &info) override;
+    void serialize_force_promise_entry(const prom_info_t &info,
+                                       int clock_id) override;
+    void serialize_force_promise_exit(const prom_info_t &info,
+                                      int clock_id) override;
+    void serialize_promise_created(const prom_basic_info_t &info) override;
+    void serialize_promise_lookup(const prom_info_t &info,
+                                  int clock_id) override;
+    void serialize_promise_expression_lookup(const prom_info_t &info,
+                                             int clock_id) override;
+    void serialize_promise_lifecycle(const prom_gc_info_t &info) override;
+    void serialize_vector_alloc(const type_gc_info_t &info) override;
+    void serialize_gc_exit(const gc_info_t &info) override;
+    void serialize_unwind(const unwind_info_t &info) override;
+    void serialize_srcfile(const srcfile_info_t &info) override;
+    void serialize_callsite(const callsite_info_t &info) override;
+    void
+    serialize_promise_retirement(const prom_retirement_info_t &info) override;
+    void serialize_tracer_footprint(const footprint_info_t &info) override;
+    void serialize_fork(const fork_info_t &info) override;
+    std::string get_segment_filepath(pid_t pid) const override;
+    Serializer *create_segment_serializer(pid_t pid) const override;
+
+  private:
+    typedef std::pair<const void *, size_t> fragment_t;
+
+    void open_stream(const std::string &stream_path);
+    void close_stream();
+    void emit(stream_record_type type,
+              std::initializer_list<fragment_t> fragments);
+    bool reserve(size_t size);
+    bool write_pending(bool block);
+    void compact();
+    void disconnect();
+    void report_statistics() const;
+    uint64_t timestamp() const;
+
+    void emit_metadata(const metadata_t &info);
+    void emit_function(const call_info_t &info);
+    void emit_call(stream_record_type type, const call_info_t &info);
+    void emit_promise_evaluation(stream_record_type type,
+                                 const prom_info_t &info, int clock_id);
+
+    std::string stream_path;
+    stream_policy policy;
+    int block_timeout;
+    bool verbose;
+    int descriptor = -1;
+    bool is_socket = false;
+    bool disconnected = false;
+    void (*previous_sigpipe_handler)(int) = SIG_DFL;
+
+    std::vector<char> buffer;
+    size_t pending_begin = 0;
+    size_t pending_end = 0;
+    size_t flush_threshold;
+    uint64_t lost_bytes = 0;
+
+    std::chrono::steady_clock::time_point start_time;
+    stream_statistics_record_t statistics;
+};
+
+stream_policy string_to_stream_policy(const std::string &policy);
+
+#endif /* __STREAM_SERIALIZER__ */
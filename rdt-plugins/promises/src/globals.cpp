@@ -1,20 +1,16 @@
 #include "globals.hpp"
 
-SqlSerializer * serializer = nullptr;
-tracer_state_t * state = nullptr;
-
-tracer_state_t &tracer_state() { return *state; }
+static inline tracer_t &tracer() {
+    return *static_cast<tracer_t *>(
+        dyntrace_active_dyntrace_context->dyntracer_context);
+}
 
-SqlSerializer &tracer_serializer() { return *serializer; }
+tracer_state_t &tracer_state() { return *tracer().state; }
 
-tracer_state_t *set_tracer_state(tracer_state_t *new_state) {
-  tracer_state_t *old_state = state;
-  state = new_state;
-  return old_state;
-}
+Serializer &tracer_serializer() { return *tracer().serializer; }
 
-SqlSerializer *set_tracer_serializer(SqlSerializer *new_serializer) {
-  SqlSerializer *old_serializer = serializer;
-  serializer = new_serializer;
-  return old_serializer;
+Serializer *set_tracer_serializer(Serializer *new_serializer) {
+    Serializer *old_serializer = tracer().serializer;
+    tracer().serializer = new_serializer;
+    return old_serializer;
 }
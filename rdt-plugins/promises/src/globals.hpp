@@ -2,14 +2,20 @@
 #define __GLOBALS_HPP__
 
 #include "State.hpp"
-#include "SqlSerializer.hpp"
+#include "Serializer.hpp"
 
-tracer_state_t &tracer_state();
+// The context of a promises dyntracer.
+struct tracer_t {
+    tracer_state_t *state;
+    Serializer *serializer;
+};
 
-SqlSerializer &tracer_serializer();
+// The state and serializer of the dyntracer whose probe is running, taken
+// from the active dyntrace context. Only valid inside probes.
+tracer_state_t &tracer_state();
 
-tracer_state_t *set_tracer_state(tracer_state_t *new_state);
+Serializer &tracer_serializer();
 
-SqlSerializer *set_tracer_serializer(SqlSerializer *new_serializer);
+Serializer *set_tracer_serializer(Serializer *new_serializer);
 
 #endif /* __GLOBALS_HPP__ */
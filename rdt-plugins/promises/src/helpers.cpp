@@ -26,7 +26,9 @@ prom_id_t get_promise_id(SEXP promise) {
     if (it != promise_ids.end()) {
         prom_id = it->second;
     } else {
-        prom_id = make_promise_id(promise, true);
+        // A retired promise is still the same promise.
+        if (!tracer_state().revive_promise(key, prom_id))
+            prom_id = make_promise_id(promise, true);
     }
 
     return prom_id;
@@ -49,6 +51,9 @@ prom_id_t make_promise_id(SEXP promise, bool negative) {
         (prom_type == 21) ? TYPEOF(BODY_EXPR(PRCODE(promise))) : 0;
     prom_key_t key(prom_addr, prom_type, orig_type);
     tracer_state().promise_ids[key] = prom_id;
+    // a retired promise left behind at this address was not unmarked
+    tracer_state().retired_promises.erase(key);
+    tracer_state().touch_promise(prom_id);
 
     auto &already_inserted_negative_promises =
         tracer_state().already_inserted_negative_promises;
@@ -58,9 +63,7 @@ prom_id_t make_promise_id(SEXP promise, bool negative) {
 }
 
 fn_id_t get_function_id(SEXP func) {
-    const char *def = get_expression(func);
-    assert(def != NULL);
-    fn_key_t definition = def;
+    fn_key_t definition = get_expression(func);
 
     auto &function_ids = tracer_state().function_ids;
     auto it = function_ids.find(definition);
@@ -118,12 +121,49 @@ SEXP get_promise(SEXP var, SEXP rho) {
     if (TYPEOF(var) == PROMSXP) {
         prom = var;
     } else if (TYPEOF(var) == SYMSXP) {
-        prom = findVar(var, rho);
+        prom = Rf_findVar(var, rho);
     }
 
     return prom;
 }
 
+const char *get_name(SEXP sexp) {
+    switch (TYPEOF(sexp)) {
+        case CHARSXP:
+            return CHAR(sexp);
+        case LANGSXP:
+            return get_name(CAR(sexp));
+        case BUILTINSXP:
+        case SPECIALSXP:
+            return PRIMNAME(sexp);
+        case SYMSXP:
+            return CHAR(PRINTNAME(sexp));
+        default:
+            return NULL;
+    }
+}
+
+string get_expression(SEXP sexp) {
+    char *deparsed = serialize_sexp(sexp);
+    string expression = deparsed == NULL ? "" : deparsed;
+    free(deparsed);
+    return expression;
+}
+
+string get_location(SEXP op) {
+    dyntrace_srcref_t location;
+    if (TYPEOF(op) != CLOSXP ||
+        !dyntrace_get_srcref(dyntrace_get_attribute(op, R_SrcrefSymbol),
+                             &location))
+        return "";
+    return string(CHKSTR(location.filename)) + ":" +
+           to_string(location.line) + ":" + to_string(location.column);
+}
+
+bool is_byte_compiled(SEXP op) {
+    return TYPEOF(op) == CLOSXP && TYPEOF(BODY(op)) == BCODESXP;
+}
+
 prom_id_t get_parent_promise() {
     for (std::vector<stack_event_t>::reverse_iterator iterator =
              tracer_state().full_stack.rbegin();
@@ -1,6 +1,39 @@
 #include "hooks.hpp"
+#include <unistd.h>
+
+// Writes out the builtin counters of a call which is exiting or unwound.
+static void flush_builtin_counters(call_id_t call_id) {
+    auto &counters = tracer_state().builtin_counters;
+    auto it = counters.find(call_id);
+    if (it == counters.end())
+        return;
+
+    for (auto const &counter : it->second)
+        tracer_serializer().serialize_builtin_count(counter.second);
+    counters.erase(it);
+}
+
+static void count_builtin(const SEXP op, function_type fn_type) {
+    call_id_t caller = get<0>(tracer_state().fun_stack.back());
+    auto &counter = tracer_state().builtin_counters[caller][PRIMOFFSET(op)];
+    if (counter.count == 0)
+        counter = builtin_count_get_info(op, fn_type);
+    counter.count++;
+}
 
-void begin(const SEXP prom) {
+// Deparses the pending callsites, writes them out and releases them.
+static void flush_callsites() {
+    vector<srcfile_info_t> srcfiles;
+    vector<callsite_info_t> callsites;
+    tracer_state().get_callsites(srcfiles, callsites);
+    for (auto const &srcfile : srcfiles)
+        tracer_serializer().serialize_srcfile(srcfile);
+    for (auto const &callsite : callsites)
+        tracer_serializer().serialize_callsite(callsite);
+    tracer_state().release_callsites();
+}
+
+void begin(dyntrace_context_t *context, const SEXP prom) {
     PROTECT(prom);
     tracer_state().start_pass(prom);
 
@@ -11,12 +44,26 @@ void begin(const SEXP prom) {
     UNPROTECT(1);
 }
 
-void end() {
-    tracer_state().finish_pass();
+// Writes out what is still kept in memory and closes the trace.
+static void finish_trace() {
+    // Whatever is left was called from outside of any traced closure, or its
+    // caller did not exit through function_exit.
+    while (!tracer_state().builtin_counters.empty())
+        flush_builtin_counters(
+            tracer_state().builtin_counters.begin()->first);
+
+    flush_callsites();
+    tracer_state().release_srcfiles();
 
     metadata_t metadata;
     get_current_time_metadata(metadata, "END");
+    get_governor_metadata(metadata);
     tracer_serializer().serialize_finish_trace(metadata);
+}
+
+void end(dyntrace_context_t *context) {
+    tracer_state().finish_pass();
+    finish_trace();
 
     if (!tracer_state().fun_stack.empty()) {
         Rprintf("Function stack is not balanced: %d remaining.\n",
@@ -32,7 +79,8 @@ void end() {
 }
 
 // Triggered when entering function evaluation.
-void function_entry(const SEXP call, const SEXP op, const SEXP rho) {
+void function_entry(dyntrace_context_t *context, const SEXP call,
+                    const SEXP op, const SEXP rho) {
     PROTECT(call);
     PROTECT(op);
     PROTECT(rho);
@@ -59,17 +107,21 @@ void function_entry(const SEXP call, const SEXP op, const SEXP rho) {
         }
     }
 
+    if (tracer_state().has_full_callsite_batch())
+        flush_callsites();
+
     UNPROTECT(3);
 }
 
-void function_exit(const SEXP call, const SEXP op, const SEXP rho,
-                   const SEXP retval) {
+void function_exit(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                   const SEXP rho, const SEXP retval) {
     PROTECT(call);
     PROTECT(op);
     PROTECT(rho);
     PROTECT(retval);
 
     closure_info_t info = function_exit_get_info(call, op, rho);
+    flush_builtin_counters(info.call_id);
     tracer_serializer().serialize_function_exit(info);
 
     // Current function ID is popped in function_exit_get_info
@@ -84,6 +136,12 @@ void print_entry_info(const SEXP call, const SEXP op, const SEXP rho,
     PROTECT(op);
     PROTECT(rho);
 
+    if (tracer_state().is_aggregated_builtin(op)) {
+        count_builtin(op, fn_type);
+        UNPROTECT(3);
+        return;
+    }
+
     builtin_info_t info = builtin_entry_get_info(call, op, rho, fn_type);
     tracer_serializer().serialize_builtin_entry(info);
 
@@ -91,10 +149,14 @@ void print_entry_info(const SEXP call, const SEXP op, const SEXP rho,
         make_tuple(info.call_id, info.fn_id, info.fn_type));
     tracer_state().curr_env_stack.push(info.call_ptr | 1);
 
+    if (tracer_state().has_full_callsite_batch())
+        flush_callsites();
+
     UNPROTECT(3);
 }
 
-void builtin_entry(const SEXP call, const SEXP op, const SEXP rho) {
+void builtin_entry(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                   const SEXP rho) {
     PROTECT(call);
     PROTECT(op);
     PROTECT(rho);
@@ -110,7 +172,8 @@ void builtin_entry(const SEXP call, const SEXP op, const SEXP rho) {
     UNPROTECT(3);
 }
 
-void specialsxp_entry(const SEXP call, const SEXP op, const SEXP rho) {
+void specialsxp_entry(dyntrace_context_t *context, const SEXP call,
+                      const SEXP op, const SEXP rho) {
     PROTECT(call);
     PROTECT(op);
     PROTECT(rho);
@@ -126,7 +189,14 @@ void print_exit_info(const SEXP call, const SEXP op, const SEXP rho,
     PROTECT(op);
     PROTECT(rho);
 
+    // Aggregated calls did not push anything on the stacks.
+    if (tracer_state().is_aggregated_builtin(op)) {
+        UNPROTECT(3);
+        return;
+    }
+
     builtin_info_t info = builtin_exit_get_info(call, op, rho, fn_type);
+    flush_builtin_counters(info.call_id);
     tracer_serializer().serialize_builtin_exit(info);
 
     tracer_state().fun_stack.pop_back();
@@ -135,8 +205,8 @@ void print_exit_info(const SEXP call, const SEXP op, const SEXP rho,
     UNPROTECT(3);
 }
 
-void builtin_exit(const SEXP call, const SEXP op, const SEXP rho,
-                  const SEXP retval) {
+void builtin_exit(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                  const SEXP rho, const SEXP retval) {
     PROTECT(call);
     PROTECT(op);
     PROTECT(rho);
@@ -153,8 +223,8 @@ void builtin_exit(const SEXP call, const SEXP op, const SEXP rho,
     UNPROTECT(4);
 }
 
-void specialsxp_exit(const SEXP call, const SEXP op, const SEXP rho,
-                     const SEXP retval) {
+void specialsxp_exit(dyntrace_context_t *context, const SEXP call,
+                     const SEXP op, const SEXP rho, const SEXP retval) {
     PROTECT(call);
     PROTECT(op);
     PROTECT(rho);
@@ -165,11 +235,12 @@ void specialsxp_exit(const SEXP call, const SEXP op, const SEXP rho,
     UNPROTECT(4);
 }
 
-void promise_created(const SEXP prom, const SEXP rho) {
+void promise_created(dyntrace_context_t *context, const SEXP prom,
+                     const SEXP rho) {
     PROTECT(prom);
     PROTECT(rho);
 
-    prom_basic_info_t info = create_promise_get_info(prom, rho);
+    prom_basic_info_t info = create_promise_get_info(prom);
     tracer_serializer().serialize_promise_created(info);
     if (info.prom_id >= 0) { // maybe we don't need this check
         tracer_serializer().serialize_promise_lifecycle(
@@ -179,111 +250,116 @@ void promise_created(const SEXP prom, const SEXP rho) {
 }
 
 // Promise is being used inside a function body for the first time.
-void force_promise_entry(const SEXP symbol, const SEXP rho) {
-    PROTECT(symbol);
-    PROTECT(rho);
+void promise_force_entry(dyntrace_context_t *context, const SEXP promise) {
+    PROTECT(promise);
 
-    prom_info_t info = force_promise_entry_get_info(symbol, rho);
+    prom_info_t info = force_promise_entry_get_info(promise);
     tracer_serializer().serialize_force_promise_entry(info,
                                                       tracer_state().clock_id);
     tracer_state().clock_id++;
+    tracer_state().touch_promise(info.prom_id);
     if (info.prom_id >= 0) {
         tracer_serializer().serialize_promise_lifecycle(
             {info.prom_id, 1, tracer_state().gc_trigger_counter});
     }
 
-    UNPROTECT(2);
+    UNPROTECT(1);
 }
 
-void force_promise_exit(const SEXP symbol, const SEXP rho, const SEXP val) {
-    PROTECT(symbol);
-    PROTECT(rho);
-    PROTECT(val);
+void promise_force_exit(dyntrace_context_t *context, const SEXP promise) {
+    PROTECT(promise);
 
-    prom_info_t info = force_promise_exit_get_info(symbol, rho, val);
+    prom_info_t info = force_promise_exit_get_info(promise);
     tracer_serializer().serialize_force_promise_exit(info, tracer_state().clock_id);
     tracer_state().clock_id++;
 
-    UNPROTECT(3);
+    UNPROTECT(1);
 }
 
-void promise_lookup(const SEXP symbol, const SEXP rho, const SEXP val) {
-    PROTECT(symbol);
-    PROTECT(rho);
-    PROTECT(val);
+void promise_value_lookup(dyntrace_context_t *context, const SEXP promise) {
+    PROTECT(promise);
 
-    prom_info_t info = promise_lookup_get_info(symbol, rho, val);
+    prom_info_t info = promise_lookup_get_info(promise);
     if (info.prom_id >= 0) {
         tracer_serializer().serialize_promise_lookup(info,
                                                      tracer_state().clock_id);
         tracer_state().clock_id++;
+        tracer_state().touch_promise(info.prom_id);
         tracer_serializer().serialize_promise_lifecycle(
             {info.prom_id, 1, tracer_state().gc_trigger_counter});
     }
 
-    UNPROTECT(3);
+    UNPROTECT(1);
 }
 
-void promise_expression_lookup(const SEXP prom, const SEXP rho) {
+void promise_expression_lookup(dyntrace_context_t *context, const SEXP prom) {
     PROTECT(prom);
-    PROTECT(rho);
 
-    prom_info_t info = promise_expression_lookup_get_info(prom, rho);
+    prom_info_t info = promise_expression_lookup_get_info(prom);
     if (info.prom_id >= 0) {
         tracer_serializer().serialize_promise_expression_lookup(
             info, tracer_state().clock_id);
         tracer_state().clock_id++;
+        tracer_state().touch_promise(info.prom_id);
         tracer_serializer().serialize_promise_lifecycle(
             {info.prom_id, 3, tracer_state().gc_trigger_counter});
     }
 
-    UNPROTECT(2);
+    UNPROTECT(1);
 }
 
-void gc_promise_unmarked(const SEXP promise) {
+void gc_promise_unmarked(dyntrace_context_t *context, const SEXP promise) {
     PROTECT(promise);
     prom_addr_t addr = get_sexp_address(promise);
     prom_id_t id = get_promise_id(promise);
-    auto &promise_origin = tracer_state().promise_origin;
 
     if (id >= 0) {
         tracer_serializer().serialize_promise_lifecycle(
             {id, 2, tracer_state().gc_trigger_counter});
     }
 
-    auto iter = promise_origin.find(id);
-    if (iter != promise_origin.end()) {
-        // If this is one of our traced promises,
-        // delete it from origin map because it is ready to be GCed
-        promise_origin.erase(iter);
-        // Rprintf("Promise %#x deleted.\n", id);
-    }
+    // If this is one of our traced promises, delete everything we know about
+    // it because it is ready to be GCed
+    tracer_state().forget_promise(id);
 
     unsigned int prom_type = TYPEOF(PRCODE(promise));
     unsigned int orig_type =
         (prom_type == 21) ? TYPEOF(BODY_EXPR(PRCODE(promise))) : 0;
     prom_key_t key(addr, prom_type, orig_type);
     tracer_state().promise_ids.erase(key);
+    tracer_state().retired_promises.erase(key);
     UNPROTECT(1);
 }
 
-void gc_entry(R_size_t size_needed) {
+void gc_entry(dyntrace_context_t *context, R_size_t size_needed) {
     tracer_state().gc_trigger_counter = 1 + tracer_state().gc_trigger_counter;
 }
 
-void gc_exit(int gc_count, double vcells, double ncells) {
+void gc_exit(dyntrace_context_t *context, int gc_count, double vcells,
+             double ncells, const dyntrace_gc_info_t *gc_info) {
     gc_info_t info = gc_exit_get_info(gc_count, vcells, ncells);
     info.counter = tracer_state().gc_trigger_counter;
     tracer_serializer().serialize_gc_exit(info);
+
+    vector<prom_retirement_info_t> retired;
+    tracer_state().retire_promises(retired);
+    for (auto const &retirement : retired)
+        tracer_serializer().serialize_promise_retirement(retirement);
+
+    vector<footprint_info_t> footprint;
+    tracer_state().get_footprint(footprint);
+    for (auto const &table : footprint)
+        tracer_serializer().serialize_tracer_footprint(table);
 }
 
-void vector_alloc(int sexptype, long length, long bytes, const char *srcref) {
+void vector_alloc(dyntrace_context_t *context, int sexptype, long length,
+                  long bytes, SEXP srcref) {
     type_gc_info_t info{tracer_state().gc_trigger_counter, sexptype, length,
                         bytes};
     tracer_serializer().serialize_vector_alloc(info);
 }
 
-void jump_ctxt(const SEXP rho, const SEXP val) {
+void jump_ctxt(dyntrace_context_t *context, const SEXP rho, const SEXP val) {
     PROTECT(rho);
     PROTECT(val);
 
@@ -292,8 +368,45 @@ void jump_ctxt(const SEXP rho, const SEXP val) {
     unwind_info_t info;
 
     tracer_state().adjust_stacks(rho, info);
+    for (call_id_t call_id : info.unwound_calls)
+        flush_builtin_counters(call_id);
 
     tracer_serializer().serialize_unwind(info);
 
     UNPROTECT(2);
 }
+
+void fork_parent(dyntrace_context_t *context, pid_t child_pid, int estranged) {
+    fork_info_t info;
+    info.child_pid = child_pid;
+    info.call_id = get<0>(tracer_state().fun_stack.back());
+    info.id_base = tracer_state_t::get_fork_id_base(child_pid);
+    info.segment = tracer_serializer().get_segment_filepath(child_pid);
+    tracer_serializer().serialize_fork(info);
+}
+
+// The child continues the trace of the parent in a segment of its own. The
+// serializer of the parent is abandoned, not deleted: deleting it would
+// flush the events buffered by the parent a second time, or finalize the
+// sqlite connection of the parent, which must not be used across fork.
+void fork_child(dyntrace_context_t *context, pid_t parent_pid) {
+    pid_t pid = getpid();
+    set_tracer_serializer(tracer_serializer().create_segment_serializer(pid));
+    tracer_state().fork_child(pid);
+
+    metadata_t metadata;
+    get_environment_metadata(metadata);
+    get_current_time_metadata(metadata, "START");
+    metadata["RDT_FORK_PARENT_PID"] = to_string(parent_pid);
+    metadata["RDT_FORK_ID_BASE"] =
+        to_string(tracer_state_t::get_fork_id_base(pid));
+    tracer_serializer().serialize_start_trace(metadata);
+}
+
+// The child leaves with _exit from inside the calls active at the fork,
+// end() never runs in it and its stacks are not expected to balance.
+void fork_child_exit(dyntrace_context_t *context, int status) {
+    finish_trace();
+    tracer_state().fun_stack.clear();
+    tracer_state().full_stack.clear();
+}
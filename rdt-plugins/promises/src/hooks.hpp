@@ -1,35 +1,43 @@
 #ifndef __HOOKS_HPP__
 #define __HOOKS_HPP__
 
-#include <rdt.h>
 #include "globals.hpp"
 #include "utilities.hpp"
 #include "recorder.hpp"
 
-void begin(const SEXP prom);
-void end();
-void function_entry(const SEXP call, const SEXP op, const SEXP rho);
-void function_exit(const SEXP call, const SEXP op, const SEXP rho,
-                   const SEXP retval);
+void begin(dyntrace_context_t *context, const SEXP prom);
+void end(dyntrace_context_t *context);
+void function_entry(dyntrace_context_t *context, const SEXP call,
+                    const SEXP op, const SEXP rho);
+void function_exit(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                   const SEXP rho, const SEXP retval);
 void print_entry_info(const SEXP call, const SEXP op, const SEXP rho,
                       function_type fn_type);
-void builtin_entry(const SEXP call, const SEXP op, const SEXP rho);
-void specialsxp_entry(const SEXP call, const SEXP op, const SEXP rho);
+void builtin_entry(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                   const SEXP rho);
+void specialsxp_entry(dyntrace_context_t *context, const SEXP call,
+                      const SEXP op, const SEXP rho);
 void print_exit_info(const SEXP call, const SEXP op, const SEXP rho,
                      function_type fn_type);
-void builtin_exit(const SEXP call, const SEXP op, const SEXP rho,
-                  const SEXP retval);
-void specialsxp_exit(const SEXP call, const SEXP op, const SEXP rho,
-                     const SEXP retval);
-void promise_created(const SEXP prom, const SEXP rho);
-void force_promise_entry(const SEXP symbol, const SEXP rho);
-void force_promise_exit(const SEXP symbol, const SEXP rho, const SEXP val);
-void promise_lookup(const SEXP symbol, const SEXP rho, const SEXP val);
-void promise_expression_lookup(const SEXP prom, const SEXP rho);
-void gc_promise_unmarked(const SEXP promise);
-void gc_entry(R_size_t size_needed);
-void gc_exit(int gc_count, double vcells, double ncells);
-void vector_alloc(int sexptype, long length, long bytes, const char *srcref);
-void jump_ctxt(const SEXP rho, const SEXP val);
+void builtin_exit(dyntrace_context_t *context, const SEXP call, const SEXP op,
+                  const SEXP rho, const SEXP retval);
+void specialsxp_exit(dyntrace_context_t *context, const SEXP call,
+                     const SEXP op, const SEXP rho, const SEXP retval);
+void promise_created(dyntrace_context_t *context, const SEXP prom,
+                     const SEXP rho);
+void promise_force_entry(dyntrace_context_t *context, const SEXP promise);
+void promise_force_exit(dyntrace_context_t *context, const SEXP promise);
+void promise_value_lookup(dyntrace_context_t *context, const SEXP promise);
+void promise_expression_lookup(dyntrace_context_t *context, const SEXP prom);
+void gc_promise_unmarked(dyntrace_context_t *context, const SEXP promise);
+void gc_entry(dyntrace_context_t *context, R_size_t size_needed);
+void gc_exit(dyntrace_context_t *context, int gc_count, double vcells,
+             double ncells, const dyntrace_gc_info_t *gc_info);
+void vector_alloc(dyntrace_context_t *context, int sexptype, long length,
+                  long bytes, SEXP srcref);
+void jump_ctxt(dyntrace_context_t *context, const SEXP rho, const SEXP val);
+void fork_parent(dyntrace_context_t *context, pid_t child_pid, int estranged);
+void fork_child(dyntrace_context_t *context, pid_t parent_pid);
+void fork_child_exit(dyntrace_context_t *context, int status);
 
 #endif /* __HOOKS_HPP__ */
@@ -32,6 +32,29 @@ void get_current_time_metadata(metadata_t &metadata, string prefix) {
         to_string(static_cast<long int>(time));
 }
 
+// The budget and decisions of the overhead governor when dyntrace() was
+// given an overhead_budget. The probes it disabled are missing from the
+// trace after the decision.
+void get_governor_metadata(metadata_t &metadata) {
+    if (dyntrace_active_dyntrace_context == NULL)
+        return;
+    const dyntracing_context_t *context =
+        dyntrace_active_dyntrace_context->dyntracing_context;
+    if (context->overhead_budget <= 0)
+        return;
+
+    metadata["RDT_OVERHEAD_BUDGET"] = to_string(context->overhead_budget);
+    for (int i = 0; i < context->governor_decision_count; ++i) {
+        const dyntrace_governor_decision_t &decision =
+            context->governor_decisions[i];
+        metadata["RDT_GOVERNOR_DECISION_" + to_string(i)] =
+            string(dyntrace_probe_names[decision.probe]) +
+            " period=" + to_string(decision.period) +
+            " overhead=" + to_string(decision.overhead) +
+            " program_time=" + to_string((long)decision.program_time);
+    }
+}
+
 recursion_type is_recursive(fn_id_t function) {
     for (vector<call_stack_elem_t>::reverse_iterator i =
              tracer_state().fun_stack.rbegin();
@@ -161,8 +184,7 @@ void get_full_type_inner(SEXP sexp, SEXP rho, full_sexp_type &result,
     }
 
     if (type == sexp_type::SYM) {
-        bool try_to_attach_symbol_value =
-            (rho != R_NilValue) ? isEnvironment(rho) : false;
+        bool try_to_attach_symbol_value = TYPEOF(rho) == ENVSXP;
         if (!try_to_attach_symbol_value)
             return;
         /* FIXME - findVar can eval an expression. This can fire another hook,
@@ -234,8 +256,7 @@ void get_full_type_inner(SEXP sexp, SEXP rho, full_sexp_type &result,
     }
 }
 
-inline void get_full_type(SEXP promise, SEXP rho,
-                          full_sexp_type &result) { // FIXME remove rho
+inline void get_full_type(SEXP promise, full_sexp_type &result) {
     set<SEXP> visited;
     get_full_type_inner(PRCODE(promise), PRENV(promise), result, visited);
 }
@@ -245,7 +266,7 @@ closure_info_t function_entry_get_info(const SEXP call, const SEXP op,
     closure_info_t info;
 
     const char *name = get_name(call);
-    const char *ns = get_ns_name(op);
+    const char *ns = dyntrace_get_namespace_name(CLOENV(op));
 
     info.fn_compiled = is_byte_compiled(op);
     info.fn_type = function_type::CLOSURE;
@@ -258,15 +279,16 @@ closure_info_t function_entry_get_info(const SEXP call, const SEXP op,
     call_stack_elem_t elem = tracer_state().fun_stack.back();
     info.parent_call_id = get<0>(elem);
 
-    char *location = get_location(op);
-    if (location != NULL)
-        info.loc = location;
-    free(location);
+    // The location and definition are only stored with the function, once.
+    if (!function_already_inserted(info.fn_id)) {
+        info.loc = get_location(op);
+        info.fn_definition = get_expression(op);
+    }
 
-    char *callsite = get_callsite(1);
-    if (callsite != NULL)
-        info.callsite = callsite;
-    free(callsite);
+    // R_Srcref is the srcref of op by now, the one current at the call was
+    // saved in the context of the closure.
+    info.callsite_id =
+        tracer_state().get_callsite_id(call, R_GlobalContext->srcref);
 
     if (ns) {
         info.name = string(ns) + "::" + CHKSTR(name);
@@ -276,7 +298,6 @@ closure_info_t function_entry_get_info(const SEXP call, const SEXP op,
     }
 
     info.arguments = get_arguments(info.call_id, op, rho);
-    info.fn_definition = get_expression(op);
 
     info.recursion = is_recursive(info.fn_id);
 
@@ -296,7 +317,7 @@ closure_info_t function_exit_get_info(const SEXP call, const SEXP op,
     closure_info_t info;
 
     const char *name = get_name(call);
-    const char *ns = get_ns_name(op);
+    const char *ns = dyntrace_get_namespace_name(CLOENV(op));
 
     info.fn_compiled = is_byte_compiled(op);
     info.fn_id = get_function_id(op);
@@ -305,16 +326,6 @@ closure_info_t function_exit_get_info(const SEXP call, const SEXP op,
     info.call_id = get<0>(elem);
     info.fn_type = function_type::CLOSURE;
 
-    char *location = get_location(op);
-    if (location != NULL)
-        info.loc = location;
-    free(location);
-
-    char *callsite = get_callsite(0);
-    if (callsite != NULL)
-        info.callsite = callsite;
-    free(callsite);
-
     if (ns) {
         info.name = string(ns) + "::" + CHKSTR(name);
     } else {
@@ -323,7 +334,6 @@ closure_info_t function_exit_get_info(const SEXP call, const SEXP op,
     }
 
     info.arguments = get_arguments(info.call_id, op, rho);
-    info.fn_definition = get_expression(op);
 
     tracer_state().fun_stack.pop_back();
     call_stack_elem_t elem_parent = tracer_state().fun_stack.back();
@@ -350,23 +360,18 @@ builtin_info_t builtin_entry_get_info(const SEXP call, const SEXP op,
     info.name = info.name;
     info.fn_type = fn_type;
     info.fn_compiled = is_byte_compiled(op);
-    info.fn_definition = get_expression(op);
 
     // R_FunTab[PRIMOFFSET(op)].eval % 100 )/10 ==
 
     call_stack_elem_t elem = tracer_state().fun_stack.back();
     info.parent_call_id = get<0>(elem);
 
-    char *location = get_location(op);
-    if (location != NULL) {
-        info.loc = location;
+    if (!function_already_inserted(info.fn_id)) {
+        info.loc = get_location(op);
+        info.fn_definition = get_expression(op);
     }
-    free(location);
 
-    char *callsite = get_callsite(0);
-    if (callsite != NULL)
-        info.callsite = callsite;
-    free(callsite);
+    info.callsite_id = tracer_state().get_callsite_id(call, R_Srcref);
 
     info.call_ptr = get_sexp_address(rho);
     info.call_id = make_funcall_id(op);
@@ -390,6 +395,29 @@ builtin_info_t builtin_entry_get_info(const SEXP call, const SEXP op,
     return info;
 }
 
+// Only called for the first call to op from the current closure, the counter
+// is incremented in hooks.
+builtin_count_info_t builtin_count_get_info(const SEXP op,
+                                            function_type fn_type) {
+    builtin_count_info_t info;
+
+    info.name = PRIMNAME(op);
+    info.fn_id = get_function_id(op);
+    info.fn_addr = get_function_addr(op);
+    info.fn_type = fn_type;
+    info.fn_compiled = false;
+    if (!function_already_inserted(info.fn_id))
+        info.fn_definition = get_expression(op);
+
+    call_stack_elem_t elem = tracer_state().fun_stack.back();
+    info.call_id = get<0>(elem);
+    info.parent_call_id = get<0>(elem);
+    info.in_prom_id = get_parent_promise();
+    info.recursion = recursion_type::UNKNOWN;
+
+    return info;
+}
+
 builtin_info_t builtin_exit_get_info(const SEXP call, const SEXP op,
                                      const SEXP rho, function_type fn_type) {
     builtin_info_t info;
@@ -405,22 +433,11 @@ builtin_info_t builtin_exit_get_info(const SEXP call, const SEXP op,
         info.name = name;
     info.fn_type = fn_type;
     info.fn_compiled = is_byte_compiled(op);
-    info.fn_definition = get_expression(op);
 
     call_stack_elem_t parent_elem = tracer_state().fun_stack.back();
     info.parent_call_id = get<0>(parent_elem);
     info.recursion = is_recursive(info.fn_id);
 
-    char *location = get_location(op);
-    if (location != NULL)
-        info.loc = location;
-    free(location);
-
-    char *callsite = get_callsite(0);
-    if (callsite != NULL)
-        info.callsite = callsite;
-    free(callsite);
-
     tracer_state().full_stack.pop_back();
     get_stack_parent(info, tracer_state().full_stack);
     info.in_prom_id = get_parent_promise();
@@ -436,14 +453,14 @@ gc_info_t gc_exit_get_info(int gc_count, double vcells, double ncells) {
     return info;
 }
 
-prom_basic_info_t create_promise_get_info(const SEXP promise, const SEXP rho) {
+prom_basic_info_t create_promise_get_info(const SEXP promise) {
     prom_basic_info_t info;
 
     info.prom_id = make_promise_id(promise);
     tracer_state().fresh_promises.insert(info.prom_id);
 
     info.prom_type = static_cast<sexp_type>(TYPEOF(PRCODE(promise)));
-    get_full_type(promise, rho, info.full_type);
+    get_full_type(promise, info.full_type);
 
     get_stack_parent(info, tracer_state().full_stack);
     info.in_prom_id = get_parent_promise();
@@ -452,14 +469,11 @@ prom_basic_info_t create_promise_get_info(const SEXP promise, const SEXP rho) {
     return info;
 }
 
-prom_info_t force_promise_entry_get_info(const SEXP symbol, const SEXP rho) {
+// The forced promise is passed without the variable it is bound to, info.name
+// stays empty.
+prom_info_t force_promise_entry_get_info(const SEXP promise_expression) {
     prom_info_t info;
 
-    const char *name = get_name(symbol);
-    if (name != NULL)
-        info.name = name;
-
-    SEXP promise_expression = get_promise(symbol, rho);
     info.prom_id = get_promise_id(promise_expression);
 
     call_stack_elem_t call_stack_elem = tracer_state().fun_stack.back();
@@ -469,7 +483,7 @@ prom_info_t force_promise_entry_get_info(const SEXP symbol, const SEXP rho) {
     set_distances_and_lifestyle(info);
 
     info.prom_type = static_cast<sexp_type>(TYPEOF(PRCODE(promise_expression)));
-    get_full_type(promise_expression, rho, info.full_type);
+    get_full_type(promise_expression, info.full_type);
     info.return_type = sexp_type::OMEGA;
 
     get_stack_parent(info, tracer_state().full_stack);
@@ -484,15 +498,9 @@ prom_info_t force_promise_entry_get_info(const SEXP symbol, const SEXP rho) {
     return info;
 }
 
-prom_info_t force_promise_exit_get_info(const SEXP symbol, const SEXP rho,
-                                        const SEXP val) {
+prom_info_t force_promise_exit_get_info(const SEXP promise_expression) {
     prom_info_t info;
 
-    const char *name = get_name(symbol);
-    if (name != NULL)
-        info.name = name;
-
-    SEXP promise_expression = get_promise(symbol, rho);
     info.prom_id = get_promise_id(promise_expression);
 
     call_stack_elem_t stack_elem = tracer_state().fun_stack.back();
@@ -502,8 +510,9 @@ prom_info_t force_promise_exit_get_info(const SEXP symbol, const SEXP rho,
     set_distances_and_lifestyle(info);
 
     info.prom_type = static_cast<sexp_type>(TYPEOF(PRCODE(promise_expression)));
-    get_full_type(promise_expression, rho, info.full_type);
-    info.return_type = static_cast<sexp_type>(TYPEOF(val));
+    get_full_type(promise_expression, info.full_type);
+    info.return_type =
+        static_cast<sexp_type>(TYPEOF(PRVALUE(promise_expression)));
 
     tracer_state().full_stack.pop_back();
 
@@ -514,15 +523,9 @@ prom_info_t force_promise_exit_get_info(const SEXP symbol, const SEXP rho,
     return info;
 }
 
-prom_info_t promise_lookup_get_info(const SEXP symbol, const SEXP rho,
-                                    const SEXP val) {
+prom_info_t promise_lookup_get_info(const SEXP promise_expression) {
     prom_info_t info;
 
-    const char *name = get_name(symbol);
-    if (name != NULL)
-        info.name = name;
-
-    SEXP promise_expression = get_promise(symbol, rho);
     info.prom_id = get_promise_id(promise_expression);
 
     call_stack_elem_t stack_elem = tracer_state().fun_stack.back();
@@ -533,7 +536,8 @@ prom_info_t promise_lookup_get_info(const SEXP symbol, const SEXP rho,
 
     info.prom_type = static_cast<sexp_type>(TYPEOF(PRCODE(promise_expression)));
     info.full_type.push_back(sexp_type::OMEGA);
-    info.return_type = static_cast<sexp_type>(TYPEOF(val));
+    info.return_type =
+        static_cast<sexp_type>(TYPEOF(PRVALUE(promise_expression)));
 
     get_stack_parent(info, tracer_state().full_stack);
     info.in_prom_id = get_parent_promise();
@@ -542,8 +546,7 @@ prom_info_t promise_lookup_get_info(const SEXP symbol, const SEXP rho,
     return info;
 }
 
-prom_info_t promise_expression_lookup_get_info(const SEXP prom,
-                                               const SEXP rho) {
+prom_info_t promise_expression_lookup_get_info(const SEXP prom) {
     prom_info_t info;
 
     info.prom_id = get_promise_id(prom);
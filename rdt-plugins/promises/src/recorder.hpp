@@ -3,15 +3,14 @@
 
 #include <chrono>
 #include <ctime>
-#include <inspect.h>
 #include <tuple>
 #include "State.hpp"
 #include "globals.hpp"
-#include <rdt.h>
 #include <set>
 
 void get_environment_metadata(metadata_t &metadata);
 void get_current_time_metadata(metadata_t &metadata, string prefix);
+void get_governor_metadata(metadata_t &metadata);
 closure_info_t function_entry_get_info(const SEXP call,
                                        const SEXP op,
                                        const SEXP rho);
@@ -22,19 +21,16 @@ builtin_info_t builtin_entry_get_info(const SEXP call,
                                       const SEXP op,
                                       const SEXP rho,
                                       function_type fn_type);
+builtin_count_info_t builtin_count_get_info(const SEXP op,
+                                            function_type fn_type);
 builtin_info_t builtin_exit_get_info(const SEXP call,
                                      const SEXP op,
                                      const SEXP rho,
                                      function_type fn_type);
-prom_basic_info_t create_promise_get_info(const SEXP promise, const SEXP rho);
-prom_info_t force_promise_entry_get_info(const SEXP symbol, const SEXP rho);
-prom_info_t force_promise_exit_get_info(const SEXP symbol,
-                                        const SEXP rho,
-                                        const SEXP val);
-prom_info_t promise_lookup_get_info(const SEXP symbol,
-                                    const SEXP rho,
-                                    const SEXP val);
-prom_info_t promise_expression_lookup_get_info(const SEXP prom,
-                                               const SEXP rho);
+prom_basic_info_t create_promise_get_info(const SEXP promise);
+prom_info_t force_promise_entry_get_info(const SEXP promise);
+prom_info_t force_promise_exit_get_info(const SEXP promise);
+prom_info_t promise_lookup_get_info(const SEXP promise);
+prom_info_t promise_expression_lookup_get_info(const SEXP prom);
 gc_info_t gc_exit_get_info(int gc_count, double vcells, double ncells);
 #endif /* __RECORDER_HPP__ */
@@ -1,54 +1,95 @@
 #include "tracer.hpp"
 
+DYNTRACE_PLUGIN_ABI;
+
 static tracer_state_t *create_tracer_state(SEXP options) {
     return new tracer_state_t(
         sexp_to_string(get_named_list_element(options, "database_filepath")),
         sexp_to_string(get_named_list_element(options, "schema_filepath")),
-        sexp_to_bool(get_named_list_element(options, "verbose"), false));
+        sexp_to_bool(get_named_list_element(options, "verbose"), false),
+        sexp_to_int(
+            get_named_list_element(options, "promise_retirement_epochs"), 0),
+        // promise_memory_limit is given in megabytes
+        1024UL * 1024UL *
+            sexp_to_int(get_named_list_element(options, "promise_memory_limit"),
+                        0),
+        sexp_to_bool(get_named_list_element(options, "aggregate_builtins"),
+                     false),
+        sexp_to_string_vector(
+            get_named_list_element(options, "traced_builtins")));
 }
 
-static SqlSerializer *create_tracer_serializer(const tracer_state_t &state) {
-    return new SqlSerializer(state.get_database_filepath(),
-                             state.get_schema_filepath(),
-                             state.get_verbosity_state());
+static Serializer *create_tracer_serializer(SEXP options,
+                                            const tracer_state_t &state) {
+    std::string output_format =
+        sexp_to_string(get_named_list_element(options, "output_format"), "sql");
+
+    if (output_format == "stream") {
+        return new StreamSerializer(
+            sexp_to_string(get_named_list_element(options, "stream_filepath")),
+            string_to_stream_policy(sexp_to_string(
+                get_named_list_element(options, "stream_policy"), "drop")),
+            sexp_to_int(get_named_list_element(options, "stream_buffer_size"),
+                        4 * 1024 * 1024),
+            // milliseconds the BLOCK policy waits for the consumer, 0 never
+            sexp_to_int(get_named_list_element(options, "stream_timeout"),
+                        1000),
+            state.get_verbosity_state());
+    }
+
+    return new SqlSerializer(
+        state.get_database_filepath(), state.get_schema_filepath(),
+        state.get_verbosity_state(),
+        sexp_to_bool(get_named_list_element(options, "in_memory"), false),
+        sexp_to_int(get_named_list_element(options, "backup_pages"), 0),
+        // memory_limit is given in megabytes
+        1024L * 1024L *
+            sexp_to_int(get_named_list_element(options, "memory_limit"), 0));
 }
 
-static rdt_handler *create_rdt_handler() {
+SEXP create_dyntracer(SEXP options) {
 
     // calloc initializes the memory to zero. This ensures that probes not
-    // attached to hooks will point to NULL. Replacing calloc with malloc will
-    // cause segfaults.
-    rdt_handler *h = (rdt_handler *)calloc(1, sizeof(rdt_handler));
-
-    h->probe_begin = begin;
-    h->probe_end = end;
-    h->probe_function_entry = function_entry;
-    h->probe_function_exit = function_exit;
-    h->probe_builtin_entry = builtin_entry;
-    h->probe_builtin_exit = builtin_exit;
-    h->probe_specialsxp_entry = specialsxp_entry;
-    h->probe_specialsxp_exit = specialsxp_exit;
-    h->probe_gc_promise_unmarked = gc_promise_unmarked;
-    h->probe_force_promise_entry = force_promise_entry;
-    h->probe_force_promise_exit = force_promise_exit;
-    h->probe_promise_created = promise_created;
-    h->probe_promise_lookup = promise_lookup;
-    h->probe_promise_expression_lookup = promise_expression_lookup;
-    h->probe_vector_alloc = vector_alloc;
-    h->probe_gc_entry = gc_entry;
-    h->probe_gc_exit = gc_exit;
-    h->probe_jump_ctxt = jump_ctxt;
-
-    return h;
+    // attached will point to NULL.
+    dyntracer_t *dyntracer = (dyntracer_t *)calloc(1, sizeof(dyntracer_t));
+
+    dyntracer->probe_begin = begin;
+    dyntracer->probe_end = end;
+    dyntracer->probe_function_entry = function_entry;
+    dyntracer->probe_function_exit = function_exit;
+    dyntracer->probe_builtin_entry = builtin_entry;
+    dyntracer->probe_builtin_exit = builtin_exit;
+    dyntracer->probe_specialsxp_entry = specialsxp_entry;
+    dyntracer->probe_specialsxp_exit = specialsxp_exit;
+    dyntracer->probe_gc_promise_unmarked = gc_promise_unmarked;
+    dyntracer->probe_promise_force_entry = promise_force_entry;
+    dyntracer->probe_promise_force_exit = promise_force_exit;
+    dyntracer->probe_promise_created = promise_created;
+    dyntracer->probe_promise_value_lookup = promise_value_lookup;
+    dyntracer->probe_promise_expression_lookup = promise_expression_lookup;
+    dyntracer->probe_vector_alloc = vector_alloc;
+    dyntracer->probe_gc_entry = gc_entry;
+    dyntracer->probe_gc_exit = gc_exit;
+    dyntracer->probe_jump_ctxt = jump_ctxt;
+    dyntracer->probe_fork_parent = fork_parent;
+    dyntracer->probe_fork_child = fork_child;
+    dyntracer->probe_fork_child_exit = fork_child_exit;
+
+    tracer_state_t *state = create_tracer_state(options);
+    dyntracer->context =
+        new tracer_t{state, create_tracer_serializer(options, *state)};
+
+    return dyntracer_to_sexp(dyntracer, "dyntracer.promises");
 }
 
-rdt_handler *setup_tracing(SEXP options) {
-    set_tracer_state(create_tracer_state(options));
-    set_tracer_serializer(create_tracer_serializer(tracer_state()));
-    return create_rdt_handler();
+static void destroy_promises_dyntracer(dyntracer_t *dyntracer) {
+    tracer_t *tracer = static_cast<tracer_t *>(dyntracer->context);
+    delete tracer->serializer;
+    delete tracer->state;
+    delete tracer;
+    free(dyntracer);
 }
 
-void cleanup_tracing(SEXP options) {
-    delete &tracer_serializer();
-    delete &tracer_state();
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp, destroy_promises_dyntracer);
 }
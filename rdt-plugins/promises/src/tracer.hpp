@@ -2,6 +2,7 @@
 #define __TRACER_HPP__
 
 #include "SqlSerializer.hpp"
+#include "StreamSerializer.hpp"
 #include "globals.hpp"
 #include "hooks.hpp"
 #include "recorder.hpp"
@@ -19,9 +20,10 @@
 extern "C" {
 #endif
 
-rdt_handler *setup_tracing(SEXP options);
+// Entry points for dyntraceLoad and dyntraceDestroy, see the README.
+SEXP create_dyntracer(SEXP options);
 
-void cleanup_tracing(SEXP options);
+SEXP destroy_dyntracer(SEXP dyntracer_sexp);
 
 #ifdef __cplusplus
 }
@@ -46,3 +46,11 @@ std::string sexp_to_string(SEXP value, std::string default_value) {
     else
         return default_value;
 }
+
+std::vector<std::string> sexp_to_string_vector(SEXP value) {
+    std::vector<std::string> strings;
+    if (value != NULL && value != R_NilValue && TYPEOF(value) == STRSXP)
+        for (int i = 0; i < LENGTH(value); ++i)
+            strings.push_back(CHAR(STRING_ELT(value, i)));
+    return strings;
+}
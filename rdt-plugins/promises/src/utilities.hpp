@@ -1,10 +1,16 @@
 #ifndef __UTILITIES_HPP__
 #define __UTILITIES_HPP__
 
+// The plugin is compiled with R_NO_REMAP, otherwise the length() macro of
+// Rinternals.h breaks the standard library headers; use the Rf_ names.
+// USE_RINTERNALS exposes the accessors of Defn.h (PRCODE, PRIMOFFSET...),
+// R_USE_SIGNALS the contexts (R_GlobalContext).
+#define USE_RINTERNALS
+#define R_USE_SIGNALS 1
+#include <Rdyntrace.h>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
-#include <rdt.h>
 #include <string>
 #include <vector>
 
@@ -21,6 +27,8 @@ int sexp_to_int(SEXP value, int default_value = 0);
 std::string sexp_to_string(SEXP value,
                            std::string default_value = std::string(""));
 
+std::vector<std::string> sexp_to_string_vector(SEXP value);
+
 template <typename T>
 std::underlying_type_t<T> to_underlying_type(const T &enum_val) {
     return static_cast<std::underlying_type_t<T>>(enum_val);
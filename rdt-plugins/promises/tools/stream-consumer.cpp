@@ -0,0 +1,375 @@
+// Reference consumer for the binary trace stream written by StreamSerializer.
+//
+// Listens on a Unix domain socket (or reads a FIFO with --fifo), decodes the
+// records described in src/StreamRecord.hpp and periodically prints rolling
+// call counts and promise statistics. It is deliberately small; use it as a
+// starting point for interactive investigations.
+//
+//   rdt-stream-consumer [--fifo] [--window SECONDS] [--interval SECONDS]
+//                       [--top N] PATH
+//
+// Start the consumer first, then trace with
+//
+//   tracer <- dyntraceLoad("lib/librdt-promises.so",
+//                          list(output_format="stream",
+//                               stream_filepath=PATH, stream_policy="drop"))
+//   dyntrace(tracer, {...})
+//   dyntraceDestroy(tracer)
+
+#include "StreamRecord.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+struct consumer_options_t {
+    string path;
+    bool fifo = false;
+    double window = 10.0;  // seconds of trace time
+    double interval = 1.0; // seconds of wall time between reports
+    size_t top = 10;
+};
+
+struct promise_statistics_t {
+    uint64_t created = 0;
+    uint64_t forced = 0;
+    uint64_t looked_up = 0;
+    uint64_t expression_looked_up = 0;
+    uint64_t collected = 0;
+    uint64_t retired = 0;
+    uint64_t force_depth = 0;
+    uint64_t lifestyles[6] = {0, 0, 0, 0, 0, 0};
+};
+
+struct consumer_state_t {
+    unordered_map<int32_t, string> function_names;
+    unordered_map<int32_t, uint64_t> total_calls;
+    unordered_map<int32_t, uint64_t> window_calls;
+    deque<pair<uint64_t, int32_t>> window_events;
+    uint64_t calls = 0;
+    uint64_t now = 0; // latest trace timestamp seen
+    uint64_t gc_count = 0;
+    uint64_t unwinds = 0;
+    uint64_t records = 0;
+    bool finished = false;
+    promise_statistics_t promises;
+    stream_statistics_record_t statistics;
+};
+
+static const char *lifestyle_names[] = {
+    "virgin", "local", "branch_local", "escaped", "immediate_local",
+    "immediate_branch_local"};
+
+static void usage(const char *program) {
+    cerr << "usage: " << program
+         << " [--fifo] [--window SECONDS] [--interval SECONDS] [--top N] PATH"
+         << endl;
+    exit(1);
+}
+
+static consumer_options_t parse_options(int argc, char **argv) {
+    consumer_options_t options;
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "--fifo")
+            options.fifo = true;
+        else if (argument == "--window" && i + 1 < argc)
+            options.window = atof(argv[++i]);
+        else if (argument == "--interval" && i + 1 < argc)
+            options.interval = atof(argv[++i]);
+        else if (argument == "--top" && i + 1 < argc)
+            options.top = atoi(argv[++i]);
+        else if (argument[0] == '-' || !options.path.empty())
+            usage(argv[0]);
+        else
+            options.path = argument;
+    }
+    if (options.path.empty())
+        usage(argv[0]);
+    return options;
+}
+
+static int open_input(const consumer_options_t &options) {
+    if (options.fifo) {
+        struct stat status;
+        if (stat(options.path.c_str(), &status) != 0 &&
+            mkfifo(options.path.c_str(), 0600) != 0) {
+            perror("mkfifo");
+            exit(1);
+        }
+        int descriptor = open(options.path.c_str(), O_RDONLY);
+        if (descriptor == -1) {
+            perror("open");
+            exit(1);
+        }
+        return descriptor;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, options.path.c_str(),
+            sizeof(address.sun_path) - 1);
+    unlink(options.path.c_str());
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server == -1 ||
+        bind(server, (struct sockaddr *)&address, sizeof(address)) == -1 ||
+        listen(server, 1) == -1) {
+        perror("socket");
+        exit(1);
+    }
+
+    cerr << "waiting for tracer on " << options.path << endl;
+    int descriptor = accept(server, nullptr, nullptr);
+    if (descriptor == -1) {
+        perror("accept");
+        exit(1);
+    }
+    close(server);
+    unlink(options.path.c_str());
+    return descriptor;
+}
+
+static bool read_fully(int descriptor, void *data, size_t size) {
+    char *cursor = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t count = read(descriptor, cursor, size);
+        if (count == 0)
+            return false;
+        if (count == -1) {
+            if (errno == EINTR)
+                continue;
+            perror("read");
+            return false;
+        }
+        cursor += count;
+        size -= count;
+    }
+    return true;
+}
+
+template <typename T> static T payload_as(const vector<char> &payload) {
+    T record;
+    memset(&record, 0, sizeof(record));
+    memcpy(&record, payload.data(), min(sizeof(record), payload.size()));
+    return record;
+}
+
+static void record_call(consumer_state_t &state,
+                        const consumer_options_t &options,
+                        const stream_call_record_t &record) {
+    uint64_t window = options.window * 1e9;
+
+    state.calls++;
+    state.now = max(state.now, record.timestamp);
+    state.total_calls[record.fn_id]++;
+    state.window_calls[record.fn_id]++;
+    state.window_events.emplace_back(record.timestamp, record.fn_id);
+
+    while (!state.window_events.empty() &&
+           state.window_events.front().first + window < state.now) {
+        auto iterator =
+            state.window_calls.find(state.window_events.front().second);
+        if (--iterator->second == 0)
+            state.window_calls.erase(iterator);
+        state.window_events.pop_front();
+    }
+}
+
+static void process_record(consumer_state_t &state,
+                           const consumer_options_t &options,
+                           stream_record_type type,
+                           const vector<char> &payload) {
+    state.records++;
+
+    switch (type) {
+        case stream_record_type::HELLO: {
+            auto record = payload_as<stream_hello_record_t>(payload);
+            if (record.magic != RDT_STREAM_MAGIC ||
+                record.version != RDT_STREAM_VERSION) {
+                cerr << "not an rdt trace stream (version " << record.version
+                     << ")" << endl;
+                exit(1);
+            }
+            cerr << "tracing R process " << record.pid << endl;
+            break;
+        }
+        case stream_record_type::FUNCTION: {
+            auto record = payload_as<stream_function_record_t>(payload);
+            state.function_names[record.fn_id] =
+                string(payload.data() + sizeof(record),
+                       payload.size() - sizeof(record));
+            break;
+        }
+        case stream_record_type::FUNCTION_ENTRY:
+        case stream_record_type::BUILTIN_ENTRY:
+            record_call(state, options,
+                        payload_as<stream_call_record_t>(payload));
+            break;
+        case stream_record_type::BUILTIN_COUNT: {
+            auto record = payload_as<stream_builtin_count_record_t>(payload);
+            state.calls += record.count;
+            state.total_calls[record.fn_id] += record.count;
+            break;
+        }
+        case stream_record_type::PROMISE_CREATED:
+            state.promises.created++;
+            break;
+        case stream_record_type::PROMISE_FORCE_ENTRY: {
+            auto record =
+                payload_as<stream_promise_evaluation_record_t>(payload);
+            state.promises.forced++;
+            state.promises.force_depth += record.depth;
+            if (record.lifestyle < 6)
+                state.promises.lifestyles[record.lifestyle]++;
+            break;
+        }
+        case stream_record_type::PROMISE_LOOKUP:
+            state.promises.looked_up++;
+            break;
+        case stream_record_type::PROMISE_EXPRESSION_LOOKUP:
+            state.promises.expression_looked_up++;
+            break;
+        case stream_record_type::PROMISE_LIFECYCLE: {
+            auto record =
+                payload_as<stream_promise_lifecycle_record_t>(payload);
+            if (record.event == 2)
+                state.promises.collected++;
+            break;
+        }
+        case stream_record_type::PROMISE_RETIREMENT:
+            state.promises.retired++;
+            break;
+        case stream_record_type::GC_EXIT:
+            state.gc_count++;
+            break;
+        case stream_record_type::UNWIND:
+            state.unwinds++;
+            break;
+        case stream_record_type::FORK: {
+            auto record = payload_as<stream_fork_record_t>(payload);
+            cerr << "R process forked child " << record.pid
+                 << ", which streams to "
+                 << string(payload.data() + sizeof(record),
+                           payload.size() - sizeof(record))
+                 << endl;
+            break;
+        }
+        case stream_record_type::STATISTICS:
+            state.statistics =
+                payload_as<stream_statistics_record_t>(payload);
+            state.finished = true;
+            break;
+        default:
+            break;
+    }
+}
+
+static string function_name(const consumer_state_t &state, int32_t fn_id) {
+    auto iterator = state.function_names.find(fn_id);
+    if (iterator == state.function_names.end() || iterator->second.empty())
+        return "<fn " + to_string(fn_id) + ">";
+    return iterator->second;
+}
+
+static void print_report(const consumer_state_t &state,
+                         const consumer_options_t &options) {
+    vector<pair<uint64_t, int32_t>> hottest;
+    for (auto const &entry : state.window_calls)
+        hottest.emplace_back(entry.second, entry.first);
+    sort(hottest.rbegin(), hottest.rend());
+    if (hottest.size() > options.top)
+        hottest.resize(options.top);
+
+    printf("== t=%.3fs records=%lu calls=%lu (last %.1fs: %lu) gc=%lu "
+           "unwinds=%lu\n",
+           state.now / 1e9, state.records, state.calls, options.window,
+           state.window_events.size(), state.gc_count, state.unwinds);
+
+    for (auto const &entry : hottest)
+        printf("   %10lu %10lu  %s\n", entry.first,
+               state.total_calls.at(entry.second),
+               function_name(state, entry.second).c_str());
+
+    const promise_statistics_t &promises = state.promises;
+    printf("   promises: created=%lu forced=%lu (%.1f%%) lookups=%lu "
+           "expression_lookups=%lu collected=%lu retired=%lu "
+           "mean_force_depth=%.2f\n",
+           promises.created, promises.forced,
+           promises.created ? 100.0 * promises.forced / promises.created : 0.0,
+           promises.looked_up, promises.expression_looked_up,
+           promises.collected, promises.retired,
+           promises.forced ? (double)promises.force_depth / promises.forced
+                           : 0.0);
+    printf("   lifestyles:");
+    for (int i = 0; i < 6; ++i)
+        printf(" %s=%lu", lifestyle_names[i], promises.lifestyles[i]);
+    printf("\n");
+    fflush(stdout);
+}
+
+static void print_statistics(const consumer_state_t &state) {
+    uint64_t emitted = 0, dropped = 0;
+    for (int i = 0; i < static_cast<int>(stream_record_type::COUNT); ++i) {
+        emitted += state.statistics.emitted[i];
+        dropped += state.statistics.dropped[i];
+    }
+    if (!state.finished) {
+        printf("== stream ended without statistics record\n");
+        return;
+    }
+    printf("== tracer emitted %lu records, dropped %lu (%.2f%%)\n", emitted,
+           dropped,
+           emitted + dropped ? 100.0 * dropped / (emitted + dropped) : 0.0);
+}
+
+int main(int argc, char **argv) {
+    consumer_options_t options = parse_options(argc, argv);
+    consumer_state_t state;
+    memset(&state.statistics, 0, sizeof(state.statistics));
+
+    int descriptor = open_input(options);
+
+    auto last_report = chrono::steady_clock::now();
+    stream_record_header_t header;
+    vector<char> payload;
+
+    while (read_fully(descriptor, &header, sizeof(header))) {
+        payload.resize(header.size);
+        if (!read_fully(descriptor, payload.data(), header.size))
+            break;
+
+        if (header.type < static_cast<uint16_t>(stream_record_type::COUNT))
+            process_record(state, options,
+                           static_cast<stream_record_type>(header.type),
+                           payload);
+
+        auto now = chrono::steady_clock::now();
+        if (chrono::duration<double>(now - last_report).count() >=
+            options.interval) {
+            print_report(state, options);
+            last_report = now;
+        }
+    }
+
+    close(descriptor);
+    print_report(state, options);
+    print_statistics(state);
+    return 0;
+}
@@ -0,0 +1,670 @@
+// Compares two promise tracer traces function by function and reports the
+// statistically significant differences, e.g. between two versions of a
+// package or two R builds running the same vignette.
+//
+//   rdt-trace-diff [--alpha P] [--min-calls N] [--correction METHOD] [--all]
+//                  [--output FILE] TRACE_A TRACE_B
+//
+// A trace is either a trace database (output_format = "sql" or "db") or a
+// binary trace stream saved to a file, e.g. by tracing to a FIFO read by
+// cat:
+//
+//   mkfifo /tmp/rdt.fifo; cat /tmp/rdt.fifo > trace.bin &
+//   tracer <- dyntraceLoad("lib/librdt-promises.so",
+//                          list(output_format="stream",
+//                               stream_filepath="/tmp/rdt.fifo",
+//                               stream_policy="block"))
+//   dyntrace(tracer, {...})
+//   dyntraceDestroy(tracer)
+//
+// Both kinds are read in one pass with memory proportional to the number of
+// functions: streams record by record, databases through aggregate queries
+// evaluated by SQLite. Databases do not record timing, allocations per call
+// or the functions running when the collector was triggered, those columns
+// are NA for them.
+//
+// Functions are matched by qualified name and definition hash. A function
+// whose definition changed is matched by name alone when the name is unique
+// on both sides.
+//
+// Counts (calls, forced promises, allocations, collections triggered) are
+// compared with a Poisson test conditional on their sum: both runs execute
+// the same workload, so the counts should have the same rate. Mean call
+// times are compared with Welch's test, using the normal approximation;
+// functions called fewer than min-calls times on either side are not tested
+// for time.
+//
+// A diff runs up to five tests per function, thousands in all, so that some
+// would fall under alpha by chance alone. The p-values reported are adjusted
+// over all the tests run: with Benjamini-Hochberg by default, which bounds the
+// expected share of false discoveries among the differences reported by
+// alpha, with Bonferroni (--correction bonferroni), which bounds the chance
+// of any false discovery, or not at all (--correction none).
+
+#include "StreamRecord.hpp"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+enum class correction_t { BENJAMINI_HOCHBERG, BONFERRONI, NONE };
+
+struct diff_options_t {
+    string paths[2];
+    string output;
+    double alpha = 0.01;
+    uint64_t min_calls = 10;
+    correction_t correction = correction_t::BENJAMINI_HOCHBERG;
+    bool all = false;
+};
+
+// Running mean and variance (Welford).
+struct moments_t {
+    uint64_t count = 0;
+    double mean = 0;
+    double m2 = 0;
+
+    void add(double value) {
+        count++;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0; }
+};
+
+struct function_summary_t {
+    string name;
+    uint64_t definition_hash = 0;
+    uint64_t calls = 0;
+    uint64_t forces = 0;
+    uint64_t allocations = 0;
+    uint64_t allocated_bytes = 0;
+    uint64_t gc_triggers = 0;
+    moments_t time; // inclusive time per call in microseconds
+};
+
+struct trace_summary_t {
+    string path;
+    // false for databases, which have no timing, allocation and collection
+    // columns
+    bool timed = false;
+    vector<function_summary_t> functions;
+};
+
+static void usage(const char *program) {
+    cerr << "usage: " << program
+         << " [--alpha P] [--min-calls N] [--correction bh|bonferroni|none]"
+            " [--all] [--output FILE] TRACE_A TRACE_B"
+         << endl;
+    exit(1);
+}
+
+static diff_options_t parse_options(int argc, char **argv) {
+    diff_options_t options;
+    int traces = 0;
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "--alpha" && i + 1 < argc)
+            options.alpha = atof(argv[++i]);
+        else if (argument == "--min-calls" && i + 1 < argc)
+            options.min_calls = strtoull(argv[++i], nullptr, 10);
+        else if (argument == "--correction" && i + 1 < argc) {
+            string correction = argv[++i];
+            if (correction == "bh")
+                options.correction = correction_t::BENJAMINI_HOCHBERG;
+            else if (correction == "bonferroni")
+                options.correction = correction_t::BONFERRONI;
+            else if (correction == "none")
+                options.correction = correction_t::NONE;
+            else
+                usage(argv[0]);
+        } else if (argument == "--all")
+            options.all = true;
+        else if (argument == "--output" && i + 1 < argc)
+            options.output = argv[++i];
+        else if (argument[0] == '-' || traces == 2)
+            usage(argv[0]);
+        else
+            options.paths[traces++] = argument;
+    }
+    if (traces != 2)
+        usage(argv[0]);
+    return options;
+}
+
+static bool is_database(const string &path) {
+    char magic[16] = {0};
+    ifstream file(path, ios::binary);
+    file.read(magic, sizeof(magic));
+    return file.gcount() == sizeof(magic) &&
+           memcmp(magic, "SQLite format 3", sizeof(magic)) == 0;
+}
+
+//-----------------------------------------------------------------------------
+// binary trace streams
+//-----------------------------------------------------------------------------
+
+class StreamReader {
+  public:
+    explicit StreamReader(trace_summary_t &trace) : trace(trace) {
+        trace.timed = true;
+    }
+
+    void read(const string &path) {
+        int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor == -1) {
+            cerr << "Error: could not open " << path << ": "
+                 << strerror(errno) << endl;
+            exit(1);
+        }
+
+        stream_record_header_t header;
+        vector<char> payload;
+        while (read_fully(descriptor, &header, sizeof(header))) {
+            payload.resize(header.size);
+            if (!read_fully(descriptor, payload.data(), header.size)) {
+                cerr << "Warning: " << path << " ends in the middle of a record"
+                     << endl;
+                break;
+            }
+            if (header.type <
+                static_cast<uint16_t>(stream_record_type::COUNT))
+                process(static_cast<stream_record_type>(header.type), payload);
+        }
+        close(descriptor);
+
+        // calls still active when the trace ended
+        while (!stack.empty())
+            leave(last_timestamp);
+    }
+
+  private:
+    struct frame_t {
+        uint64_t call_id;
+        int function;
+        uint64_t timestamp;
+    };
+
+    static bool read_fully(int descriptor, void *data, size_t size) {
+        char *cursor = static_cast<char *>(data);
+        while (size > 0) {
+            ssize_t count = ::read(descriptor, cursor, size);
+            if (count == 0)
+                return false;
+            if (count == -1) {
+                if (errno == EINTR)
+                    continue;
+                perror("read");
+                return false;
+            }
+            cursor += count;
+            size -= count;
+        }
+        return true;
+    }
+
+    template <typename T> static T payload_as(const vector<char> &payload) {
+        T record;
+        memset(&record, 0, sizeof(record));
+        memcpy(&record, payload.data(), min(sizeof(record), payload.size()));
+        return record;
+    }
+
+    int get_function(int32_t fn_id) {
+        auto iterator = functions.find(fn_id);
+        if (iterator != functions.end())
+            return iterator->second;
+        // calls of functions whose FUNCTION record was dropped
+        trace.functions.emplace_back();
+        trace.functions.back().name = "<fn " + to_string(fn_id) + ">";
+        functions[fn_id] = trace.functions.size() - 1;
+        return trace.functions.size() - 1;
+    }
+
+    // The function running call_id, the innermost call if it is not active.
+    function_summary_t *get_caller(uint64_t call_id) {
+        if (stack.empty())
+            return nullptr;
+        for (auto frame = stack.rbegin(); frame != stack.rend(); ++frame)
+            if (frame->call_id == call_id)
+                return &trace.functions[frame->function];
+        return &trace.functions[stack.back().function];
+    }
+
+    void leave(uint64_t timestamp) {
+        const frame_t &frame = stack.back();
+        trace.functions[frame.function].time.add(
+            (timestamp - min(timestamp, frame.timestamp)) / 1e3);
+        stack.pop_back();
+    }
+
+    void process(stream_record_type type, const vector<char> &payload) {
+        switch (type) {
+            case stream_record_type::HELLO: {
+                auto record = payload_as<stream_hello_record_t>(payload);
+                if (record.magic != RDT_STREAM_MAGIC ||
+                    record.version != RDT_STREAM_VERSION) {
+                    cerr << "Error: " << trace.path
+                         << " is not an rdt trace stream (version "
+                         << record.version << ")" << endl;
+                    exit(1);
+                }
+                break;
+            }
+            case stream_record_type::FUNCTION: {
+                auto record = payload_as<stream_function_record_t>(payload);
+                int function = get_function(record.fn_id);
+                trace.functions[function].name =
+                    string(payload.data() + sizeof(record),
+                           payload.size() - sizeof(record));
+                trace.functions[function].definition_hash =
+                    record.definition_hash;
+                break;
+            }
+            case stream_record_type::FUNCTION_ENTRY:
+            case stream_record_type::BUILTIN_ENTRY: {
+                auto record = payload_as<stream_call_record_t>(payload);
+                int function = get_function(record.fn_id);
+                trace.functions[function].calls++;
+                stack.push_back({record.call_id, function, record.timestamp});
+                last_timestamp = max(last_timestamp, record.timestamp);
+                break;
+            }
+            case stream_record_type::FUNCTION_EXIT:
+            case stream_record_type::BUILTIN_EXIT: {
+                auto record = payload_as<stream_call_record_t>(payload);
+                last_timestamp = max(last_timestamp, record.timestamp);
+                // exits of calls entered before the trace began
+                if (!stack.empty() && stack.back().call_id == record.call_id)
+                    leave(record.timestamp);
+                break;
+            }
+            case stream_record_type::UNWIND: {
+                auto record = payload_as<stream_unwind_record_t>(payload);
+                for (uint32_t i = 0; i < record.unwound_calls && !stack.empty();
+                     ++i)
+                    leave(record.timestamp);
+                break;
+            }
+            case stream_record_type::BUILTIN_COUNT: {
+                auto record =
+                    payload_as<stream_builtin_count_record_t>(payload);
+                trace.functions[get_function(record.fn_id)].calls +=
+                    record.count;
+                break;
+            }
+            case stream_record_type::PROMISE_FORCE_ENTRY: {
+                auto record =
+                    payload_as<stream_promise_evaluation_record_t>(payload);
+                if (function_summary_t *caller = get_caller(record.in_call_id))
+                    caller->forces++;
+                break;
+            }
+            case stream_record_type::VECTOR_ALLOC: {
+                auto record = payload_as<stream_vector_alloc_record_t>(payload);
+                if (function_summary_t *caller = get_caller(record.call_id)) {
+                    caller->allocations++;
+                    caller->allocated_bytes += record.bytes;
+                }
+                break;
+            }
+            case stream_record_type::GC_EXIT:
+                if (!stack.empty())
+                    trace.functions[stack.back().function].gc_triggers++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    trace_summary_t &trace;
+    unordered_map<int32_t, int> functions;
+    vector<frame_t> stack;
+    uint64_t last_timestamp = 0;
+};
+
+//-----------------------------------------------------------------------------
+// trace databases
+//-----------------------------------------------------------------------------
+
+// Calls per function, with the builtins aggregated by aggregate_builtins,
+// and promises forced in calls of the function (event_type 0xf). The name is
+// taken in the same pass over calls (max ignores null names).
+static const char *database_query =
+    "select f.id, f.definition, coalesce(c.name, b.name),"
+    " coalesce(c.calls, 0) + coalesce(b.calls, 0), coalesce(p.forces, 0)"
+    " from functions f"
+    " left join (select function_id, count(*) calls, max(function_name) name"
+    "  from calls group by function_id) c on c.function_id = f.id"
+    " left join (select function_id, sum(count) calls, max(function_name) name"
+    "  from builtin_counts group by function_id) b on b.function_id = f.id"
+    " left join (select calls.function_id, count(*) forces"
+    "  from promise_evaluations join calls on calls.id = in_call_id"
+    "  where event_type = 15 group by calls.function_id) p"
+    " on p.function_id = f.id";
+
+static void read_database(const string &path, trace_summary_t &trace) {
+    sqlite3 *database;
+    sqlite3_stmt *statement;
+
+    if (sqlite3_open_v2(path.c_str(), &database, SQLITE_OPEN_READONLY,
+                        nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(database, database_query, -1, &statement,
+                           nullptr) != SQLITE_OK) {
+        cerr << "Error: could not query " << path << ": "
+             << sqlite3_errmsg(database) << endl;
+        exit(1);
+    }
+
+    int result;
+    while ((result = sqlite3_step(statement)) == SQLITE_ROW) {
+        trace.functions.emplace_back();
+        function_summary_t &function = trace.functions.back();
+
+        const char *definition =
+            reinterpret_cast<const char *>(sqlite3_column_text(statement, 1));
+        if (definition != nullptr)
+            function.definition_hash =
+                rdt_definition_hash(definition, strlen(definition));
+
+        const char *name =
+            reinterpret_cast<const char *>(sqlite3_column_text(statement, 2));
+        function.name = name != nullptr
+                            ? name
+                            : "<fn " + to_string(sqlite3_column_int64(
+                                           statement, 0)) +
+                                  ">";
+        function.calls = sqlite3_column_int64(statement, 3);
+        function.forces = sqlite3_column_int64(statement, 4);
+    }
+    if (result != SQLITE_DONE) {
+        cerr << "Error: could not query " << path << ": "
+             << sqlite3_errmsg(database) << endl;
+        exit(1);
+    }
+
+    sqlite3_finalize(statement);
+    sqlite3_close(database);
+}
+
+static trace_summary_t read_trace(const string &path) {
+    trace_summary_t trace;
+    trace.path = path;
+    if (is_database(path))
+        read_database(path, trace);
+    else
+        StreamReader(trace).read(path);
+    return trace;
+}
+
+//-----------------------------------------------------------------------------
+// comparison
+//-----------------------------------------------------------------------------
+
+// Two-sided p-value of a standard normal statistic.
+static double normal_p_value(double z) {
+    return erfc(fabs(z) / sqrt(2.0));
+}
+
+// Equal rates given that the same workload produced a and b: conditionally
+// on a + b, a is binomial with p = 1/2. NaN, no test, when both are 0: it
+// could not reject anything but would count in the adjustment.
+static double count_p_value(uint64_t a, uint64_t b) {
+    if (a + b == 0)
+        return NAN;
+    return normal_p_value((double(a) - double(b)) / sqrt(double(a + b)));
+}
+
+static double time_p_value(const moments_t &a, const moments_t &b) {
+    double error = sqrt(a.variance() / a.count + b.variance() / b.count);
+    if (error == 0)
+        return a.mean == b.mean ? 1 : 0;
+    return normal_p_value((a.mean - b.mean) / error);
+}
+
+struct match_t {
+    const function_summary_t *a;
+    const function_summary_t *b;
+    const char *status;
+};
+
+// Functions traced several times under the same key (e.g. the same
+// definition evaluated in different environments) are merged.
+static unordered_map<string, function_summary_t>
+merge_by_key(const trace_summary_t &trace) {
+    unordered_map<string, function_summary_t> merged;
+    for (const function_summary_t &function : trace.functions) {
+        function_summary_t &entry =
+            merged[function.name + "\t" +
+                   to_string(function.definition_hash)];
+        if (entry.name.empty()) {
+            entry = function;
+            continue;
+        }
+        entry.calls += function.calls;
+        entry.forces += function.forces;
+        entry.allocations += function.allocations;
+        entry.allocated_bytes += function.allocated_bytes;
+        entry.gc_triggers += function.gc_triggers;
+        // pooled moments
+        moments_t &time = entry.time;
+        const moments_t &other = function.time;
+        if (other.count > 0) {
+            uint64_t count = time.count + other.count;
+            double delta = other.mean - time.mean;
+            time.m2 += other.m2 +
+                       delta * delta * time.count * other.count / count;
+            time.mean += delta * other.count / count;
+            time.count = count;
+        }
+    }
+    return merged;
+}
+
+static vector<match_t>
+match_functions(const unordered_map<string, function_summary_t> &a,
+                const unordered_map<string, function_summary_t> &b) {
+    vector<match_t> matches;
+    unordered_map<string, vector<const function_summary_t *>> a_by_name,
+        b_by_name;
+
+    for (auto const &entry : a) {
+        auto other = b.find(entry.first);
+        if (other != b.end())
+            matches.push_back({&entry.second, &other->second, "same"});
+        else
+            a_by_name[entry.second.name].push_back(&entry.second);
+    }
+    for (auto const &entry : b)
+        if (a.find(entry.first) == a.end())
+            b_by_name[entry.second.name].push_back(&entry.second);
+
+    for (auto const &entry : a_by_name) {
+        auto other = b_by_name.find(entry.first);
+        if (entry.second.size() == 1 && other != b_by_name.end() &&
+            other->second.size() == 1) {
+            matches.push_back(
+                {entry.second[0], other->second[0], "definition_changed"});
+            b_by_name.erase(other);
+        } else {
+            for (const function_summary_t *function : entry.second)
+                matches.push_back({function, nullptr, "only_a"});
+        }
+    }
+    for (auto const &entry : b_by_name)
+        for (const function_summary_t *function : entry.second)
+            matches.push_back({nullptr, function, "only_b"});
+    return matches;
+}
+
+// Adjusts the p-values in place for the number of tests. NaN marks a test
+// that was not run.
+static void adjust_p_values(vector<double *> &p_values,
+                            correction_t correction) {
+    size_t tests = p_values.size();
+    if (correction == correction_t::NONE || tests == 0)
+        return;
+
+    if (correction == correction_t::BONFERRONI) {
+        for (double *p_value : p_values)
+            *p_value = min(1.0, *p_value * tests);
+        return;
+    }
+
+    // Benjamini-Hochberg: the k-th smallest p-value becomes p * tests / k,
+    // made monotone from the largest down.
+    sort(p_values.begin(), p_values.end(),
+         [](const double *x, const double *y) { return *x < *y; });
+    double adjusted = 1;
+    for (size_t k = tests; k > 0; --k) {
+        double *p_value = p_values[k - 1];
+        adjusted = min(adjusted, *p_value * tests / k);
+        *p_value = adjusted;
+    }
+}
+
+enum metric_t { CALLS, FORCES, ALLOCATIONS, GC_TRIGGERS, TIME, METRICS };
+
+static const char *metric_names[METRICS] = {"calls", "forces", "allocations",
+                                            "gc_triggers", "time"};
+
+struct comparison_t {
+    const match_t *match;
+    double p_values[METRICS];
+};
+
+static void write_p_value(ostream &output, double p_value) {
+    if (std::isnan(p_value))
+        output << "\tNA";
+    else
+        output << "\t" << p_value;
+}
+
+static void write_count(ostream &output, bool available, uint64_t a,
+                        uint64_t b, double p_value) {
+    if (!available) {
+        output << "\tNA\tNA\tNA";
+        return;
+    }
+    output << "\t" << a << "\t" << b;
+    write_p_value(output, p_value);
+}
+
+int main(int argc, char **argv) {
+    diff_options_t options = parse_options(argc, argv);
+    trace_summary_t traces[2] = {read_trace(options.paths[0]),
+                                 read_trace(options.paths[1])};
+    auto a = merge_by_key(traces[0]);
+    auto b = merge_by_key(traces[1]);
+    vector<match_t> matches = match_functions(a, b);
+    bool timed = traces[0].timed && traces[1].timed;
+
+    sort(matches.begin(), matches.end(),
+         [](const match_t &x, const match_t &y) {
+             const function_summary_t *fx = x.a ? x.a : x.b;
+             const function_summary_t *fy = y.a ? y.a : y.b;
+             return fx->name < fy->name;
+         });
+
+    // Run every test first, the adjustment depends on all the p-values.
+    const function_summary_t empty;
+    vector<comparison_t> comparisons;
+    vector<double *> p_values;
+    comparisons.reserve(matches.size());
+    for (const match_t &match : matches) {
+        const function_summary_t &fa = match.a ? *match.a : empty;
+        const function_summary_t &fb = match.b ? *match.b : empty;
+        comparisons.push_back({&match, {NAN, NAN, NAN, NAN, NAN}});
+        double *p = comparisons.back().p_values;
+
+        p[CALLS] = count_p_value(fa.calls, fb.calls);
+        p[FORCES] = count_p_value(fa.forces, fb.forces);
+        if (timed) {
+            p[ALLOCATIONS] = count_p_value(fa.allocations, fb.allocations);
+            p[GC_TRIGGERS] = count_p_value(fa.gc_triggers, fb.gc_triggers);
+            if (fa.time.count >= options.min_calls &&
+                fb.time.count >= options.min_calls)
+                p[TIME] = time_p_value(fa.time, fb.time);
+        }
+    }
+    for (comparison_t &comparison : comparisons)
+        for (double &p_value : comparison.p_values)
+            if (!std::isnan(p_value))
+                p_values.push_back(&p_value);
+    adjust_p_values(p_values, options.correction);
+
+    ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            cerr << "Error: could not open " << options.output << endl;
+            return 1;
+        }
+    }
+    ostream &output = options.output.empty() ? cout : file;
+
+    output << "function\tmatch\tcalls_a\tcalls_b\tcalls_p\tforces_a\t"
+              "forces_b\tforces_p\tallocations_a\tallocations_b\t"
+              "allocations_p\tallocated_bytes_a\tallocated_bytes_b\t"
+              "gc_triggers_a\tgc_triggers_b\tgc_triggers_p\tmean_time_us_a\t"
+              "mean_time_us_b\ttime_p\tsignificant\n";
+
+    size_t reported = 0;
+    for (const comparison_t &comparison : comparisons) {
+        const match_t &match = *comparison.match;
+        const function_summary_t &fa = match.a ? *match.a : empty;
+        const function_summary_t &fb = match.b ? *match.b : empty;
+        const double *p = comparison.p_values;
+        string significant;
+        ostringstream row;
+
+        for (int metric = 0; metric < METRICS; ++metric)
+            if (p[metric] < options.alpha)
+                significant += (significant.empty() ? "" : ",") +
+                               string(metric_names[metric]);
+
+        row << (match.a ? fa.name : fb.name) << "\t" << match.status;
+        write_count(row, true, fa.calls, fb.calls, p[CALLS]);
+        write_count(row, true, fa.forces, fb.forces, p[FORCES]);
+        write_count(row, timed, fa.allocations, fb.allocations,
+                    p[ALLOCATIONS]);
+        if (timed)
+            row << "\t" << fa.allocated_bytes << "\t" << fb.allocated_bytes;
+        else
+            row << "\tNA\tNA";
+        write_count(row, timed, fa.gc_triggers, fb.gc_triggers,
+                    p[GC_TRIGGERS]);
+        if (timed) {
+            row << "\t" << fa.time.mean << "\t" << fb.time.mean;
+            write_p_value(row, p[TIME]);
+        } else {
+            row << "\tNA\tNA\tNA";
+        }
+
+        if (!options.all && significant.empty())
+            continue;
+        output << row.str() << "\t" << significant << "\n";
+        reported++;
+    }
+
+    cerr << matches.size() << " functions compared, " << p_values.size()
+         << " tests, " << reported
+         << (options.all ? " reported" : " with significant differences")
+         << endl;
+    return 0;
+}
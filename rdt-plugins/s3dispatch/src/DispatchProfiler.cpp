@@ -0,0 +1,131 @@
+#include "DispatchProfiler.hpp"
+#include "TsvWriter.hpp"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+DispatchProfiler::DispatchProfiler(const std::string &dispatches_filepath,
+                                   const std::string &generics_filepath,
+                                   int min_dispatches, int min_hit_percent,
+                                   bool verbose)
+    : dispatches_filepath(dispatches_filepath),
+      generics_filepath(generics_filepath), min_dispatches(min_dispatches),
+      min_hit_percent(min_hit_percent), verbose(verbose) {}
+
+void DispatchProfiler::begin() { generics.clear(); }
+
+void DispatchProfiler::end() {
+    if (!dispatches_filepath.empty())
+        write_dispatches();
+    if (!generics_filepath.empty())
+        write_generics();
+
+    if (verbose) {
+        uint64_t dispatches = 0, lookup_time = 0;
+        for (auto const &entry : generics) {
+            dispatches += entry.second.dispatches;
+            lookup_time += entry.second.lookup_time;
+        }
+        cerr << "S3 dispatch: " << generics.size() << " generics, "
+             << dispatches << " dispatches, " << lookup_time / 1e6
+             << "ms resolving methods\n";
+    }
+}
+
+void DispatchProfiler::lookup(const char *generic, SEXP klass, SEXP method,
+                              int class_index, uint64_t lookup_time) {
+    int nclass = Rf_length(klass);
+    class_key.clear();
+    for (int i = 0; i < nclass; ++i) {
+        if (i > 0)
+            class_key += ',';
+        class_key += CHAR(STRING_ELT(klass, i));
+    }
+
+    generic_dispatch_t &entry = generics[generic];
+    entry.dispatches++;
+    entry.lookup_time += lookup_time;
+
+    class_dispatch_t &dispatch = entry.classes[class_key];
+    if (dispatch.dispatches++ == 0) {
+        dispatch.class_index = class_index;
+        if (TYPEOF(method) == SYMSXP)
+            dispatch.method = CHAR(PRINTNAME(method));
+    }
+    dispatch.lookups += class_index == -1 ? nclass + 1 : class_index + 1;
+    dispatch.lookup_time += lookup_time;
+}
+
+// Lookup time a cache keyed by class vector would have saved: all but the
+// first dispatch of every class vector, at the mean cost of its lookups.
+static uint64_t cacheable_time(const class_dispatch_t &dispatch) {
+    return dispatch.lookup_time -
+           dispatch.lookup_time / max(dispatch.dispatches, uint64_t(1));
+}
+
+void DispatchProfiler::write_dispatches() const {
+    TsvWriter file(dispatches_filepath,
+                   {"generic", "class", "method", "class_index", "dispatches",
+                    "lookups", "lookup_ms", "mean_lookup_us"});
+    if (!file.is_open())
+        return;
+
+    struct row_t {
+        const string *generic;
+        const string *classes;
+        const class_dispatch_t *dispatch;
+    };
+    vector<row_t> rows;
+    for (auto const &generic : generics)
+        for (auto const &entry : generic.second.classes)
+            rows.push_back({&generic.first, &entry.first, &entry.second});
+    sort(rows.begin(), rows.end(), [](const row_t &a, const row_t &b) {
+        return a.dispatch->lookup_time > b.dispatch->lookup_time;
+    });
+
+    for (auto const &row : rows) {
+        const class_dispatch_t &dispatch = *row.dispatch;
+        file.row(*row.generic, *row.classes,
+                 dispatch.method.empty() ? "<none>" : dispatch.method,
+                 dispatch.class_index, dispatch.dispatches, dispatch.lookups,
+                 dispatch.lookup_time / 1e6,
+                 dispatch.lookup_time / 1e3 / dispatch.dispatches);
+    }
+}
+
+void DispatchProfiler::write_generics() const {
+    TsvWriter file(generics_filepath,
+                   {"generic", "dispatches", "class_vectors", "lookup_ms",
+                    "mean_lookup_us", "cache_hit_percent", "cache_saving_ms",
+                    "cache_candidate"});
+    if (!file.is_open())
+        return;
+
+    typedef pair<string, const generic_dispatch_t *> row_t;
+    vector<row_t> rows;
+    for (auto const &entry : generics)
+        rows.emplace_back(entry.first, &entry.second);
+    sort(rows.begin(), rows.end(), [](const row_t &a, const row_t &b) {
+        return a.second->lookup_time > b.second->lookup_time;
+    });
+
+    for (auto const &row : rows) {
+        const generic_dispatch_t &generic = *row.second;
+        uint64_t saving = 0;
+        for (auto const &entry : generic.classes)
+            saving += cacheable_time(entry.second);
+
+        double hit_percent =
+            100.0 * (generic.dispatches - generic.classes.size()) /
+            generic.dispatches;
+        bool candidate = generic.dispatches >= (uint64_t)min_dispatches &&
+                         hit_percent >= min_hit_percent;
+
+        file.row(row.first, generic.dispatches, generic.classes.size(),
+                 generic.lookup_time / 1e6,
+                 generic.lookup_time / 1e3 / generic.dispatches, hit_percent,
+                 saving / 1e6, candidate ? "yes" : "no");
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef __DISPATCH_PROFILER_HPP__
+#define __DISPATCH_PROFILER_HPP__
+
+#include "utilities.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Dispatches of a generic on one class vector.
+struct class_dispatch_t {
+    uint64_t dispatches = 0;
+    uint64_t lookups = 0;     // R_LookupMethod calls
+    uint64_t lookup_time = 0; // nanoseconds
+    std::string method;       // "" if no method was found
+    int class_index = -1;
+};
+
+struct generic_dispatch_t {
+    // Keyed by the class vector joined with ",".
+    std::unordered_map<std::string, class_dispatch_t> classes;
+    uint64_t dispatches = 0;
+    uint64_t lookup_time = 0;
+};
+
+// Accounts for the cost of S3 method resolution in usemethod: per generic and
+// class vector, the number of dispatches, the method lookups and their time
+// and the method found.
+//
+// A cache keyed by generic and class vector would only pay the first lookup of
+// every class vector. Generics dispatched at least min_dispatches times whose
+// hit rate in such a cache would reach min_hit_percent are flagged as cache
+// candidates.
+class DispatchProfiler {
+  public:
+    DispatchProfiler(const std::string &dispatches_filepath,
+                     const std::string &generics_filepath, int min_dispatches,
+                     int min_hit_percent, bool verbose);
+
+    void begin();
+    void end();
+    void lookup(const char *generic, SEXP klass, SEXP method, int class_index,
+                uint64_t lookup_time);
+
+  private:
+    void write_dispatches() const;
+    void write_generics() const;
+
+    std::string dispatches_filepath;
+    std::string generics_filepath;
+    int min_dispatches;
+    int min_hit_percent;
+    bool verbose;
+
+    std::unordered_map<std::string, generic_dispatch_t> generics;
+    // Reused to build the class vector key without reallocating.
+    std::string class_key;
+};
+
+#endif /* __DISPATCH_PROFILER_HPP__ */
@@ -0,0 +1,11 @@
+#include "probes.hpp"
+
+RDT_PROFILER_ACCESSOR(DispatchProfiler)
+
+RDT_FORWARD_BEGIN_END_PROBES(profiler)
+
+void S3_method_lookup(dyntrace_context_t *context, const char *generic,
+                      const SEXP klass, const SEXP method, int class_index,
+                      uint64_t lookup_time) {
+    profiler(context).lookup(generic, klass, method, class_index, lookup_time);
+}
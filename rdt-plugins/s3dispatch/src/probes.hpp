@@ -0,0 +1,13 @@
+#ifndef __PROBES_HPP__
+#define __PROBES_HPP__
+
+#include "DispatchProfiler.hpp"
+#include "probe_forwarding.hpp"
+
+RDT_DECLARE_BEGIN_END_PROBES();
+
+void S3_method_lookup(dyntrace_context_t *context, const char *generic,
+                      const SEXP klass, const SEXP method, int class_index,
+                      uint64_t lookup_time);
+
+#endif /* __PROBES_HPP__ */
@@ -0,0 +1,39 @@
+#include "tracer.hpp"
+
+DYNTRACE_PLUGIN_ABI;
+
+static DispatchProfiler *create_dispatch_profiler(SEXP options) {
+    return new DispatchProfiler(
+        sexp_to_string(get_named_list_element(options, "dispatches_filepath"),
+                       "s3_dispatches.tsv"),
+        sexp_to_string(get_named_list_element(options, "generics_filepath"),
+                       "s3_generics.tsv"),
+        sexp_to_int(get_named_list_element(options, "min_dispatches"), 1000),
+        sexp_to_int(get_named_list_element(options, "min_hit_percent"), 90),
+        sexp_to_bool(get_named_list_element(options, "verbose"), false));
+}
+
+SEXP create_dyntracer(SEXP options) {
+
+    // calloc initializes the memory to zero. This ensures that probes not
+    // attached will point to NULL.
+    dyntracer_t *dyntracer = (dyntracer_t *)calloc(1, sizeof(dyntracer_t));
+
+    dyntracer->probe_begin = begin;
+    dyntracer->probe_end = end;
+    dyntracer->probe_S3_method_lookup = S3_method_lookup;
+    // The probes only read the class vectors and keep counts.
+    dyntracer->non_allocating = 1;
+    dyntracer->context = create_dispatch_profiler(options);
+
+    return dyntracer_to_sexp(dyntracer, "dyntracer.s3dispatch");
+}
+
+static void destroy_dispatch_dyntracer(dyntracer_t *dyntracer) {
+    delete static_cast<DispatchProfiler *>(dyntracer->context);
+    free(dyntracer);
+}
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp, destroy_dispatch_dyntracer);
+}
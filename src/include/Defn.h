@@ -554,6 +554,7 @@ typedef struct RCNTXT {
     SEXP returnValue;           /* only set during on.exit calls */
     struct RCNTXT *jumptarget;	/* target for a continuing jump */
     int jumpmask;               /* associated LONGJMP argument */
+    int depth;                  /* number of contexts below this one */
 } RCNTXT, *context;
 
 /* The Various Context Types.
@@ -74,6 +74,7 @@ SEXP do_backsolve(SEXP, SEXP, SEXP, SEXP);
 SEXP do_baseenv(SEXP, SEXP, SEXP, SEXP);
 SEXP do_basename(SEXP, SEXP, SEXP, SEXP);
 SEXP do_bcprofcounts(SEXP, SEXP, SEXP, SEXP);
+SEXP do_dyntraceopcodes(SEXP, SEXP, SEXP, SEXP);
 SEXP do_bcprofstart(SEXP, SEXP, SEXP, SEXP);
 SEXP do_bcprofstop(SEXP, SEXP, SEXP, SEXP);
 SEXP do_begin(SEXP, SEXP, SEXP, SEXP);
@@ -420,6 +421,10 @@ SEXP do_transpose(SEXP, SEXP, SEXP, SEXP);
 SEXP do_trunc(SEXP, SEXP, SEXP, SEXP);
 SEXP do_tryCatchHelper(SEXP, SEXP, SEXP, SEXP);
 SEXP do_dyntrace(SEXP, SEXP, SEXP, SEXP);
+SEXP do_dyntracestatistics(SEXP, SEXP, SEXP, SEXP);
+SEXP do_dyntracerecord(SEXP, SEXP, SEXP, SEXP);
+SEXP do_dyntraceload(SEXP, SEXP, SEXP, SEXP);
+SEXP do_dyntracedestroy(SEXP, SEXP, SEXP, SEXP);
 SEXP do_typeof(SEXP, SEXP, SEXP, SEXP);
 SEXP do_unclass(SEXP, SEXP, SEXP, SEXP);
 SEXP do_unlink(SEXP, SEXP, SEXP, SEXP);
@@ -10,6 +10,7 @@
 extern "C" {
 #endif
 #include <stdint.h>
+#include <stddef.h>
 #define HAVE_DECL_SIZE_MAX 1
 #include <Defn.h>
 
@@ -18,22 +19,46 @@ extern "C" {
 #define DYNTRACE_PROBE_HEADER(probe_name)                                      \
   if (dyntrace_active_dyntracer != NULL &&                                     \
       dyntrace_active_dyntracer->probe_name != NULL &&                         \
-      !dyntrace_is_priviliged_mode()) {                                        \
+      !dyntrace_is_priviliged_mode() &&                                        \
+      DYNTRACE_PROBE_IS_ADMITTED(probe_name)) {                                \
     dyntrace_active_dyntrace_context->dyntracing_context->execution_time       \
         .expression += dyntrace_reset_stopwatch();                             \
     dyntrace_active_dyntrace_context->dyntracing_context->execution_count      \
         .probe_name++;                                                         \
     CHECK_REENTRANCY(probe_name);                                              \
     dyntrace_active_dyntracer_probe_name = #probe_name;                        \
-    dyntrace_disable_garbage_collector();
+    if (!dyntrace_active_dyntracer->non_allocating)                            \
+      dyntrace_disable_garbage_collector();
 
 #define DYNTRACE_PROBE_FOOTER(probe_name)                                      \
-  dyntrace_reinstate_garbage_collector();                                      \
+  if (!dyntrace_active_dyntracer->non_allocating)                              \
+    dyntrace_reinstate_garbage_collector();                                    \
   dyntrace_active_dyntracer_probe_name = NULL;                                 \
   dyntrace_active_dyntrace_context->dyntracing_context->execution_time         \
       .probe_name += dyntrace_reset_stopwatch();                               \
   }
 
+// index of a probe in execution_count_t and dyntrace_probe_names
+#define DYNTRACE_PROBE_INDEX(probe_name)                                       \
+  (offsetof(execution_count_t, probe_name) / sizeof(uint64_t))
+
+// false when the overhead governor samples the probe out or disabled it
+#define DYNTRACE_PROBE_IS_ADMITTED(probe_name)                                 \
+  (!dyntrace_governor_enabled ||                                               \
+   dyntrace_governor_admit(DYNTRACE_PROBE_INDEX(probe_name)))
+
+// Hooks of dyntrace(record = TRUE) and dyntrace(replay = record), see
+// src/main/dyntrace.c. DYNTRACE_REPLAY_FORCE_GC() is checked on every
+// allocation, before anything else decides whether to collect: it counts the
+// allocation and is true when the replayed trace collected there.
+// DYNTRACE_REPLAY_TIME(time) is the value Sys.time() returns instead of time.
+#define DYNTRACE_REPLAY_FORCE_GC()                                             \
+  (dyntrace_replay_mode != DYNTRACE_REPLAY_OFF && dyntrace_replay_allocate())
+
+#define DYNTRACE_REPLAY_TIME(time)                                             \
+  (dyntrace_replay_mode != DYNTRACE_REPLAY_OFF ? dyntrace_replay_time(time)    \
+                                               : (time))
+
 #define CHECK_REENTRANCY(probe_name)                                           \
   if (dyntrace_active_dyntracer_probe_name != NULL) {                          \
     Rf_error("[ERROR] - [NESTED HOOK EXECUTION] - %s triggers %s\n",           \
@@ -56,6 +81,12 @@ extern "C" {
 #define DYNTRACE_SHOULD_PROBE(probe_name)                                      \
   (dyntrace_active_dyntracer->probe_name != NULL)
 
+// true when the probe would fire, guards bookkeeping done only for it
+#define DYNTRACE_PROBE_IS_ATTACHED(probe_name)                                 \
+  (dyntrace_active_dyntracer != NULL &&                                        \
+   dyntrace_active_dyntracer->probe_name != NULL &&                            \
+   !dyntrace_is_priviliged_mode())
+
 #define DYNTRACE_PROBE_FUNCTION_ENTRY(call, op, rho)                           \
   DYNTRACE_PROBE_HEADER(probe_function_entry);                                 \
   PROTECT(call);                                                               \
@@ -174,24 +205,60 @@ extern "C" {
       dyntrace_active_dyntrace_context, sexptype, length, bytes, srcref);      \
   DYNTRACE_PROBE_FOOTER(probe_vector_alloc);
 
-#define DYNTRACE_PROBE_EVAL_ENTRY(e, rho)                                      \
-  DYNTRACE_PROBE_HEADER(probe_eval_entry);                                     \
-  PROTECT(e);                                                                  \
-  PROTECT(rho);                                                                \
-  dyntrace_active_dyntracer->probe_eval_entry(                                 \
-      dyntrace_active_dyntrace_context, e, rho);                               \
+// vectors in the small node classes, see dyntracer_t.small_vector_alloc
+#define DYNTRACE_PROBE_SMALL_VECTOR_ALLOC(sexptype, length, bytes, srcref)     \
+  if (dyntrace_active_dyntracer != NULL &&                                     \
+      dyntrace_active_dyntracer->small_vector_alloc) {                         \
+    DYNTRACE_PROBE_VECTOR_ALLOC(sexptype, length, bytes, srcref);              \
+  }
+
+#define DYNTRACE_PROBE_DUPLICATE(object, copy, deep, bytes)                    \
+  DYNTRACE_PROBE_HEADER(probe_duplicate);                                      \
+  PROTECT(object);                                                             \
+  PROTECT(copy);                                                               \
+  dyntrace_active_dyntracer->probe_duplicate(dyntrace_active_dyntrace_context, \
+                                             object, copy, deep, bytes,        \
+                                             R_Srcref);                        \
   UNPROTECT(2);                                                                \
-  DYNTRACE_PROBE_FOOTER(probe_eval_entry);
+  DYNTRACE_PROBE_FOOTER(probe_duplicate);
+
+// true when the eval probes fire for expressions of the type of e, see
+// dyntracer_t.eval_type_mask
+#define DYNTRACE_EVAL_TYPE_IS_TRACED(e)                                        \
+  (dyntrace_active_dyntracer != NULL &&                                        \
+   (dyntrace_active_dyntracer->eval_type_mask == 0 ||                          \
+    (dyntrace_active_dyntracer->eval_type_mask &                               \
+     DYNTRACE_SEXPTYPE_MASK(TYPEOF(e)))))
+
+#define DYNTRACE_PROBE_EVAL_ENTRY(e, rho)                                      \
+  if (DYNTRACE_EVAL_TYPE_IS_TRACED(e)) {                                       \
+    DYNTRACE_PROBE_HEADER(probe_eval_entry);                                   \
+    PROTECT(e);                                                                \
+    PROTECT(rho);                                                              \
+    dyntrace_active_dyntracer->probe_eval_entry(                               \
+        dyntrace_active_dyntrace_context, e, rho);                             \
+    UNPROTECT(2);                                                              \
+    DYNTRACE_PROBE_FOOTER(probe_eval_entry);                                   \
+  }
 
 #define DYNTRACE_PROBE_EVAL_EXIT(e, rho, retval)                               \
-  DYNTRACE_PROBE_HEADER(probe_eval_exit);                                      \
-  PROTECT(e);                                                                  \
-  PROTECT(rho);                                                                \
-  PROTECT(retval);                                                             \
-  dyntrace_active_dyntracer->probe_eval_exit(dyntrace_active_dyntrace_context, \
-                                             e, rho, retval);                  \
-  UNPROTECT(3);                                                                \
-  DYNTRACE_PROBE_FOOTER(probe_eval_exit);
+  if (DYNTRACE_EVAL_TYPE_IS_TRACED(e)) {                                       \
+    DYNTRACE_PROBE_HEADER(probe_eval_exit);                                    \
+    PROTECT(e);                                                                \
+    PROTECT(rho);                                                              \
+    PROTECT(retval);                                                           \
+    dyntrace_active_dyntracer->probe_eval_exit(                                \
+        dyntrace_active_dyntrace_context, e, rho, retval);                     \
+    UNPROTECT(3);                                                              \
+    DYNTRACE_PROBE_FOOTER(probe_eval_exit);                                    \
+  }
+
+// both eval probes for a self-evaluating e, which is its own value
+#define DYNTRACE_PROBE_EVAL_CONSTANT(e, rho)                                   \
+  if (DYNTRACE_EVAL_TYPE_IS_TRACED(e)) {                                       \
+    DYNTRACE_PROBE_EVAL_ENTRY(e, rho);                                         \
+    DYNTRACE_PROBE_EVAL_EXIT(e, rho, e);                                       \
+  }
 
 #define DYNTRACE_PROBE_GC_ENTRY(size_needed)                                   \
   DYNTRACE_PROBE_HEADER(probe_gc_entry);                                       \
@@ -199,10 +266,10 @@ extern "C" {
                                             size_needed);                      \
   DYNTRACE_PROBE_FOOTER(probe_gc_entry);
 
-#define DYNTRACE_PROBE_GC_EXIT(gc_count, vcells, ncells)                       \
+#define DYNTRACE_PROBE_GC_EXIT(gc_count, vcells, ncells, info)                 \
   DYNTRACE_PROBE_HEADER(probe_gc_exit);                                        \
   dyntrace_active_dyntracer->probe_gc_exit(dyntrace_active_dyntrace_context,   \
-                                           gc_count, vcells, ncells);          \
+                                           gc_count, vcells, ncells, info);    \
   DYNTRACE_PROBE_FOOTER(probe_gc_exit);
 
 #define DYNTRACE_PROBE_GC_PROMISE_UNMARKED(promise)                            \
@@ -268,6 +335,74 @@ extern "C" {
   UNPROTECT(3);                                                                \
   DYNTRACE_PROBE_FOOTER(probe_S3_dispatch_exit);
 
+#define DYNTRACE_PROBE_S3_METHOD_LOOKUP(generic, klass, method, class_index,   \
+                                        start)                                 \
+  DYNTRACE_PROBE_HEADER(probe_S3_method_lookup);                               \
+  PROTECT(klass);                                                              \
+  PROTECT(method);                                                             \
+  dyntrace_active_dyntracer->probe_S3_method_lookup(                           \
+      dyntrace_active_dyntrace_context, generic, klass, method, class_index,   \
+      dyntrace_timestamp() - (start));                                         \
+  UNPROTECT(2);                                                                \
+  DYNTRACE_PROBE_FOOTER(probe_S3_method_lookup);
+
+#define DYNTRACE_PROBE_JIT_COMPILE_ENTRY(call, op)                             \
+  DYNTRACE_PROBE_HEADER(probe_jit_compile_entry);                              \
+  PROTECT(call);                                                               \
+  PROTECT(op);                                                                 \
+  dyntrace_active_dyntracer->probe_jit_compile_entry(                          \
+      dyntrace_active_dyntrace_context, call, op,                              \
+      dyntrace_expression_size(BODY(op)));                                     \
+  UNPROTECT(2);                                                                \
+  DYNTRACE_PROBE_FOOTER(probe_jit_compile_entry);
+
+#define DYNTRACE_PROBE_JIT_COMPILE_EXIT(call, op, outcome, start)              \
+  DYNTRACE_PROBE_HEADER(probe_jit_compile_exit);                               \
+  PROTECT(call);                                                               \
+  PROTECT(op);                                                                 \
+  dyntrace_active_dyntracer->probe_jit_compile_exit(                           \
+      dyntrace_active_dyntrace_context, call, op, outcome,                     \
+      dyntrace_timestamp() - (start));                                         \
+  UNPROTECT(2);                                                                \
+  DYNTRACE_PROBE_FOOTER(probe_jit_compile_exit);
+
+#define DYNTRACE_PROBE_MATCH_ARGS(call, formals, formals_count,                \
+                                  supplied_count, partial_count, dots, start)  \
+  DYNTRACE_PROBE_HEADER(probe_match_args);                                     \
+  PROTECT(call);                                                               \
+  PROTECT(formals);                                                            \
+  dyntrace_active_dyntracer->probe_match_args(                                 \
+      dyntrace_active_dyntrace_context, call, formals, formals_count,          \
+      supplied_count, partial_count, dots, dyntrace_timestamp() - (start));    \
+  UNPROTECT(2);                                                                \
+  DYNTRACE_PROBE_FOOTER(probe_match_args);
+
+#define DYNTRACE_PROBE_CONTEXT_ENTRY(cptr)                                     \
+  DYNTRACE_PROBE_HEADER(probe_context_entry);                                  \
+  dyntrace_active_dyntracer->probe_context_entry(                              \
+      dyntrace_active_dyntrace_context, cptr);                                 \
+  DYNTRACE_PROBE_FOOTER(probe_context_entry);
+
+#define DYNTRACE_PROBE_CONTEXT_EXIT(cptr)                                      \
+  DYNTRACE_PROBE_HEADER(probe_context_exit);                                   \
+  dyntrace_active_dyntracer->probe_context_exit(                               \
+      dyntrace_active_dyntrace_context, cptr);                                 \
+  DYNTRACE_PROBE_FOOTER(probe_context_exit);
+
+// A jump out of a running probe, an error raised by the probe, is not
+// reported: CHECK_REENTRANCY would raise another error from R_jumpctxt.
+#define DYNTRACE_PROBE_CONTEXT_UNWIND(cptr, target, val, contexts, onexits,    \
+                                      start)                                   \
+  if (!dyntrace_is_active()) {                                                 \
+    DYNTRACE_PROBE_HEADER(probe_context_unwind);                               \
+    PROTECT(val);                                                              \
+    dyntrace_active_dyntracer->probe_context_unwind(                           \
+        dyntrace_active_dyntrace_context, cptr, target, val, contexts,         \
+        onexits, dyntrace_timestamp() - (start));                              \
+    UNPROTECT(1);                                                              \
+    DYNTRACE_PROBE_FOOTER(probe_context_unwind);                               \
+  }
+
 #define DYNTRACE_PROBE_ENVIRONMENT_DEFINE_VAR(symbol, value, rho)              \
   DYNTRACE_PROBE_HEADER(probe_environment_define_var);                         \
   PROTECT(symbol);                                                             \
@@ -297,19 +432,42 @@ extern "C" {
   UNPROTECT(2);                                                                \
   DYNTRACE_PROBE_FOOTER(probe_environment_remove_var);
 
-#define DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, value, rho)              \
+#define DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, value, rho, depth,       \
+                                             global_cache)                     \
   DYNTRACE_PROBE_HEADER(probe_environment_lookup_var);                         \
   PROTECT(symbol);                                                             \
   PROTECT(value);                                                              \
   PROTECT(rho);                                                                \
   dyntrace_active_dyntracer->probe_environment_lookup_var(                     \
-      dyntrace_active_dyntrace_context, symbol, value, rho);                   \
+      dyntrace_active_dyntrace_context, symbol, value, rho, depth,             \
+      global_cache);                                                           \
   UNPROTECT(3);                                                                \
   DYNTRACE_PROBE_FOOTER(probe_environment_lookup_var);
 
+#define DYNTRACE_PROBE_FORK_PARENT(child_pid, estranged)                       \
+  DYNTRACE_PROBE_HEADER(probe_fork_parent);                                    \
+  dyntrace_active_dyntracer->probe_fork_parent(                                \
+      dyntrace_active_dyntrace_context, child_pid, estranged);                 \
+  DYNTRACE_PROBE_FOOTER(probe_fork_parent);
+
+#define DYNTRACE_PROBE_FORK_CHILD(parent_pid)                                  \
+  dyntrace_fork_child_begin();                                                 \
+  DYNTRACE_PROBE_HEADER(probe_fork_child);                                     \
+  dyntrace_active_dyntracer->probe_fork_child(                                 \
+      dyntrace_active_dyntrace_context, parent_pid);                           \
+  DYNTRACE_PROBE_FOOTER(probe_fork_child);
+
+#define DYNTRACE_PROBE_FORK_CHILD_EXIT(status)                                 \
+  dyntrace_fork_child_end();                                                   \
+  DYNTRACE_PROBE_HEADER(probe_fork_child_exit);                                \
+  dyntrace_active_dyntracer->probe_fork_child_exit(                            \
+      dyntrace_active_dyntrace_context, status);                               \
+  DYNTRACE_PROBE_FOOTER(probe_fork_child_exit);
+
 #else
 #define DYNTRACE_PROBE_BEGIN(prom)
 #define DYNTRACE_PROBE_END()
+#define DYNTRACE_PROBE_IS_ATTACHED(probe_name) 0
 #define DYNTRACE_PROBE_FUNCTION_ENTRY(call, op, rho)
 #define DYNTRACE_PROBE_FUNCTION_EXIT(call, op, rho, retval)
 #define DYNTRACE_PROBE_BUILTIN_ENTRY(call, op, rho)
@@ -322,11 +480,14 @@ extern "C" {
 #define DYNTRACE_PROBE_PROMISE_VALUE_LOOKUP(promise)
 #define DYNTRACE_PROBE_PROMISE_EXPRESSION_LOOKUP(promise)
 #define DYNTRACE_PROBE_ERROR(call, message)
-#define DYNTRACE_PROBE_VECTOR_ALLOC(sexptype, length, bytes, scref)
+#define DYNTRACE_PROBE_VECTOR_ALLOC(sexptype, length, bytes, srcref)
+#define DYNTRACE_PROBE_SMALL_VECTOR_ALLOC(sexptype, length, bytes, srcref)
+#define DYNTRACE_PROBE_DUPLICATE(object, copy, deep, bytes)
 #define DYNTRACE_PROBE_EVAL_ENTRY(e, rho)
 #define DYNTRACE_PROBE_EVAL_EXIT(e, rho, retval)
+#define DYNTRACE_PROBE_EVAL_CONSTANT(e, rho)
 #define DYNTRACE_PROBE_GC_ENTRY(size_needed)
-#define DYNTRACE_PROBE_GC_EXIT(gc_count, vcells, ncells)
+#define DYNTRACE_PROBE_GC_EXIT(gc_count, vcells, ncells, info)
 #define DYNTRACE_PROBE_GC_PROMISE_UNMARKED(promise)
 #define DYNTRACE_PROBE_JUMP_CTXT(rho, val)
 #define DYNTRACE_PROBE_NEW_ENVIRONMENT(rho)
@@ -334,10 +495,26 @@ extern "C" {
 #define DYNTRACE_PROBE_S3_GENERIC_EXIT(generic, object, retval)
 #define DYNTRACE_PROBE_S3_DISPATCH_ENTRY(generic, clazz, method, object)
 #define DYNTRACE_PROBE_S3_DISPATCH_EXIT(generic, clazz, method, object, retval)
+#define DYNTRACE_PROBE_S3_METHOD_LOOKUP(generic, klass, method, class_index,   \
+                                        start)
+#define DYNTRACE_PROBE_JIT_COMPILE_ENTRY(call, op)
+#define DYNTRACE_PROBE_JIT_COMPILE_EXIT(call, op, outcome, start)
+#define DYNTRACE_PROBE_MATCH_ARGS(call, formals, formals_count,                \
+                                  supplied_count, partial_count, dots, start)
+#define DYNTRACE_PROBE_CONTEXT_ENTRY(cptr)
+#define DYNTRACE_PROBE_CONTEXT_EXIT(cptr)
+#define DYNTRACE_PROBE_CONTEXT_UNWIND(cptr, target, val, contexts, onexits,    \
+                                      start)
 #define DYNTRACE_PROBE_ENVIRONMENT_DEFINE_VAR(symbol, value, rho)
 #define DYNTRACE_PROBE_ENVIRONMENT_ASSIGN_VAR(symbol, value, rho)
 #define DYNTRACE_PROBE_ENVIRONMENT_REMOVE_VAR(symbol, rho)
-#define DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, value, rho)
+#define DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, value, rho, depth,       \
+                                             global_cache)
+#define DYNTRACE_PROBE_FORK_PARENT(child_pid, estranged)
+#define DYNTRACE_PROBE_FORK_CHILD(parent_pid)
+#define DYNTRACE_PROBE_FORK_CHILD_EXIT(status)
+#define DYNTRACE_REPLAY_FORCE_GC() 0
+#define DYNTRACE_REPLAY_TIME(time) (time)
 #endif
 
 /* ----------------------------------------------------------------------------
@@ -360,6 +537,7 @@ typedef struct {
   clock_t probe_promise_expression_lookup;
   clock_t probe_error;
   clock_t probe_vector_alloc;
+  clock_t probe_duplicate;
   clock_t probe_eval_entry;
   clock_t probe_eval_exit;
   clock_t probe_gc_entry;
@@ -371,47 +549,112 @@ typedef struct {
   clock_t probe_S3_generic_exit;
   clock_t probe_S3_dispatch_entry;
   clock_t probe_S3_dispatch_exit;
+  clock_t probe_S3_method_lookup;
+  clock_t probe_jit_compile_entry;
+  clock_t probe_jit_compile_exit;
+  clock_t probe_match_args;
+  clock_t probe_context_entry;
+  clock_t probe_context_exit;
+  clock_t probe_context_unwind;
   clock_t probe_environment_define_var;
   clock_t probe_environment_assign_var;
   clock_t probe_environment_remove_var;
   clock_t probe_environment_lookup_var;
+  clock_t probe_fork_parent;
+  clock_t probe_fork_child;
+  clock_t probe_fork_child_exit;
   clock_t expression;
+  // closures compiled by the JIT, probes fired by the compiler excluded
+  clock_t jit_compile;
 } execution_time_t;
 
 typedef struct {
-  unsigned int probe_begin;
-  unsigned int probe_end;
-  unsigned int probe_function_entry;
-  unsigned int probe_function_exit;
-  unsigned int probe_builtin_entry;
-  unsigned int probe_builtin_exit;
-  unsigned int probe_specialsxp_entry;
-  unsigned int probe_specialsxp_exit;
-  unsigned int probe_promise_created;
-  unsigned int probe_promise_force_entry;
-  unsigned int probe_promise_force_exit;
-  unsigned int probe_promise_value_lookup;
-  unsigned int probe_promise_expression_lookup;
-  unsigned int probe_error;
-  unsigned int probe_vector_alloc;
-  unsigned int probe_eval_entry;
-  unsigned int probe_eval_exit;
-  unsigned int probe_gc_entry;
-  unsigned int probe_gc_exit;
-  unsigned int probe_gc_promise_unmarked;
-  unsigned int probe_jump_ctxt;
-  unsigned int probe_new_environment;
-  unsigned int probe_S3_generic_entry;
-  unsigned int probe_S3_generic_exit;
-  unsigned int probe_S3_dispatch_entry;
-  unsigned int probe_S3_dispatch_exit;
-  unsigned int probe_environment_define_var;
-  unsigned int probe_environment_assign_var;
-  unsigned int probe_environment_remove_var;
-  unsigned int probe_environment_lookup_var;
-  unsigned int expression;
+  uint64_t probe_begin;
+  uint64_t probe_end;
+  uint64_t probe_function_entry;
+  uint64_t probe_function_exit;
+  uint64_t probe_builtin_entry;
+  uint64_t probe_builtin_exit;
+  uint64_t probe_specialsxp_entry;
+  uint64_t probe_specialsxp_exit;
+  uint64_t probe_promise_created;
+  uint64_t probe_promise_force_entry;
+  uint64_t probe_promise_force_exit;
+  uint64_t probe_promise_value_lookup;
+  uint64_t probe_promise_expression_lookup;
+  uint64_t probe_error;
+  uint64_t probe_vector_alloc;
+  uint64_t probe_duplicate;
+  uint64_t probe_eval_entry;
+  uint64_t probe_eval_exit;
+  uint64_t probe_gc_entry;
+  uint64_t probe_gc_exit;
+  uint64_t probe_gc_promise_unmarked;
+  uint64_t probe_jump_ctxt;
+  uint64_t probe_new_environment;
+  uint64_t probe_S3_generic_entry;
+  uint64_t probe_S3_generic_exit;
+  uint64_t probe_S3_dispatch_entry;
+  uint64_t probe_S3_dispatch_exit;
+  uint64_t probe_S3_method_lookup;
+  uint64_t probe_jit_compile_entry;
+  uint64_t probe_jit_compile_exit;
+  uint64_t probe_match_args;
+  uint64_t probe_context_entry;
+  uint64_t probe_context_exit;
+  uint64_t probe_context_unwind;
+  uint64_t probe_environment_define_var;
+  uint64_t probe_environment_assign_var;
+  uint64_t probe_environment_remove_var;
+  uint64_t probe_environment_lookup_var;
+  uint64_t probe_fork_parent;
+  uint64_t probe_fork_child;
+  uint64_t probe_fork_child_exit;
+  uint64_t expression;
 } execution_count_t;
 
+// number of probes, the fields of execution_count_t and execution_time_t
+// before expression
+#define DYNTRACE_PROBE_COUNT 41
+
+// bit of a SEXPTYPE in dyntracer_t.eval_type_mask
+#define DYNTRACE_SEXPTYPE_MASK(type) (1u << (type))
+
+// global_cache argument of probe_environment_lookup_var
+#define DYNTRACE_GLOBAL_CACHE_UNUSED -1
+#define DYNTRACE_GLOBAL_CACHE_MISS 0
+#define DYNTRACE_GLOBAL_CACHE_HIT 1
+
+// outcome argument of probe_jit_compile_exit
+#define DYNTRACE_JIT_COMPILED 0
+// the body was taken from the JIT cache of a closure with the same code
+#define DYNTRACE_JIT_CACHED 1
+// the closure was marked not to be compiled, the compiler failed or a cached
+// closure with the same code was found in a different environment
+#define DYNTRACE_JIT_NOT_COMPILED 2
+
+// Node classes of the generational collector (NUM_NODE_CLASSES in memory.c):
+// class 0 holds cons cells and other fixed size nodes, classes 1 to 5 small
+// vectors, class 6 vectors from custom allocators and class 7 large vectors.
+#define DYNTRACE_GC_NODE_CLASSES 8
+
+typedef struct {
+  int gc_count;
+  // number of old generations collected along with the youngest one, 2 is a
+  // full collection
+  int generation;
+  R_size_t size_needed;
+  // wall time spent collecting in seconds, finalizers excluded
+  double wall_time;
+  // nodes and bytes freed per node class; class 7 counts the large vectors
+  // released to malloc. The small classes are only counted when
+  // probe_gc_exit is attached, it takes a walk over the reclaimed nodes.
+  R_size_t reclaimed_nodes[DYNTRACE_GC_NODE_CLASSES];
+  R_size_t reclaimed_bytes[DYNTRACE_GC_NODE_CLASSES];
+  // pages of small nodes released to malloc
+  R_size_t pages_released;
+} dyntrace_gc_info_t;
+
 typedef struct {
   const char *r_compile_pkgs;
   const char *r_disable_bytecode;
@@ -419,12 +662,45 @@ typedef struct {
   const char *r_keep_pkg_source;
 } environment_variables_t;
 
+// A throttling decision of the overhead governor, see dyntrace() in
+// src/library/base/R/dyntrace.R.
+typedef struct {
+  // index of the probe in dyntrace_probe_names
+  int probe;
+  // the probe now fires once every period times, 0 if it was disabled; the
+  // exits of a disabled group still fire for the entries admitted before
+  unsigned int period;
+  // probe time over program time in the window that triggered the decision
+  double overhead;
+  // program time elapsed when the decision was taken, in clock ticks
+  clock_t program_time;
+} dyntrace_governor_decision_t;
+
 typedef struct {
   execution_time_t execution_time;
   execution_count_t execution_count;
+  // Probes the overhead governor sampled out or disabled, they are neither
+  // counted nor timed above.
+  execution_count_t skipped_count;
+  // Highest probe time to program time ratio allowed, 0 when the governor is
+  // off. Its decisions are kept in order.
+  double overhead_budget;
+  dyntrace_governor_decision_t *governor_decisions;
+  int governor_decision_count;
   environment_variables_t environment_variables;
   const char *begin_datetime;
   const char *end_datetime;
+  // Fixed cost of firing a probe, in clock ticks per probe, measured by
+  // dyntrace before probe_begin with an empty probe. expression_overhead is
+  // the part of it counted in execution_time.expression (argument set up,
+  // PROTECT, half of the stopwatch reads), hook_overhead the part counted in
+  // the execution time of the probe (dispatch, garbage collector toggling).
+  double probe_expression_overhead;
+  double probe_hook_overhead;
+  // Set before probe_end: execution_time.expression without the expression
+  // overhead of the probes fired, and the fixed cost of these probes.
+  clock_t program_time;
+  clock_t probe_overhead;
 } dyntracing_context_t;
 
 typedef struct {
@@ -432,6 +708,9 @@ typedef struct {
   dyntracing_context_t *dyntracing_context;
 } dyntrace_context_t;
 
+// RCNTXT of Defn.h, only complete with R_USE_SIGNALS
+struct RCNTXT;
+
 typedef struct {
 
   /***************************************************************************
@@ -551,20 +830,39 @@ typedef struct {
   /***************************************************************************
   Look for DYNTRACE_PROBE_VECTOR_ALLOC(...) in
   - src/main/memory.c
+  srcref is R_Srcref, the source reference being evaluated: R_NilValue, a
+  srcref (INTSXP) or, inside the byte-code interpreter, a marker symbol. It is
+  passed as is because the probe runs inside allocVector; the probe must not
+  allocate on the R heap. Vectors in the small node classes, most of the
+  allocations, are only reported to tracers which set small_vector_alloc.
   ***************************************************************************/
   void (*probe_vector_alloc)(dyntrace_context_t *dyntrace_context, int sexptype,
-                             long length, long bytes, const char *srcref);
+                             long length, long bytes, SEXP srcref);
+
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_DUPLICATE(...) in
+  - src/main/duplicate.c
+  Fires when duplicate() (deep is TRUE) or shallow_duplicate() copied object
+  into copy. bytes counts the vector payloads and nodes copied, attributes
+  and, for deep copies, elements included. srcref is R_Srcref, see
+  probe_vector_alloc. lazy_duplicate() never copies and does not fire.
+  ***************************************************************************/
+  void (*probe_duplicate)(dyntrace_context_t *dyntrace_context, SEXP object,
+                          SEXP copy, int deep, R_size_t bytes, SEXP srcref);
 
   /***************************************************************************
   Look for DYNTRACE_PROBE_EVAL_ENTRY(...) in
-  - src/main/eval.c
+  - src/main/eval.c (DYNTRACE_PROBE_EVAL_CONSTANT for self-evaluating e)
+  Only fires for the types in eval_type_mask. Self-evaluating expressions
+  (constants, NULL, closures...) fire both eval probes when eval returns
+  them, after eval checked for interrupts.
   ***************************************************************************/
   void (*probe_eval_entry)(dyntrace_context_t *dyntrace_context, SEXP e,
                            SEXP rho);
 
   /***************************************************************************
   Look for DYNTRACE_PROBE_EVAL_EXIT(...) in
-  - src/main/eval.c
+  - src/main/eval.c (DYNTRACE_PROBE_EVAL_CONSTANT for self-evaluating e)
   ***************************************************************************/
   void (*probe_eval_exit)(dyntrace_context_t *dyntrace_context, SEXP e,
                           SEXP rho, SEXP retval);
@@ -579,9 +877,12 @@ typedef struct {
   /***************************************************************************
   Look for DYNTRACE_PROBE_GC_EXIT(...) in
   - src/main/memory.c
+  vcells and ncells are the Mbytes of vectors and cons cells in use after the
+  collection, info details the collection that just finished.
   ***************************************************************************/
   void (*probe_gc_exit)(dyntrace_context_t *dyntrace_context, int gc_count,
-                        double vcells, double ncells);
+                        double vcells, double ncells,
+                        const dyntrace_gc_info_t *info);
 
   /***************************************************************************
   Fires when a promise gets garbage collected
@@ -641,6 +942,98 @@ typedef struct {
                                  const SEXP method, const SEXP object,
                                  const SEXP retval);
 
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_S3_METHOD_LOOKUP(...) in
+  - src/main/objects.c
+  Fires when usemethod has resolved the method for klass, the class vector
+  of the dispatched object, before dispatching to it. class_index is the
+  position in klass of the class that matched, length(klass) for the default
+  method and -1 if there is no method. method is the symbol of the method
+  (generic.class or generic.default), R_NilValue if there is none.
+  usemethod called R_LookupMethod class_index + 1 times (length(klass) + 1
+  if there is no method). lookup_time (nanoseconds) covers computing klass
+  and all the lookups.
+  ***************************************************************************/
+  void (*probe_S3_method_lookup)(dyntrace_context_t *dyntrace_context,
+                                 const char *generic, const SEXP klass,
+                                 const SEXP method, int class_index,
+                                 uint64_t lookup_time);
+
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_JIT_COMPILE_ENTRY(...) in
+  - src/main/eval.c
+  Fires when the JIT is about to compile the closure op before its first
+  execution through call. body_size is the number of nodes of the body of
+  op, which is still the AST.
+  ***************************************************************************/
+  void (*probe_jit_compile_entry)(dyntrace_context_t *dyntrace_context,
+                                  const SEXP call, const SEXP op,
+                                  int body_size);
+
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_JIT_COMPILE_EXIT(...) in
+  - src/main/eval.c
+  Fires after the JIT compiled op, outcome is one of DYNTRACE_JIT_*. The body
+  of op is the bytecode unless the outcome is DYNTRACE_JIT_NOT_COMPILED.
+  compile_time (nanoseconds) includes the probes fired by the compiler, which
+  runs R code; execution_time.jit_compile does not.
+  ***************************************************************************/
+  void (*probe_jit_compile_exit)(dyntrace_context_t *dyntrace_context,
+                                 const SEXP call, const SEXP op, int outcome,
+                                 uint64_t compile_time);
+
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_MATCH_ARGS(...) in
+  - src/main/match.c
+  Fires when matchArgs has matched the supplied arguments of call to formals,
+  for closure calls and the builtins matching their arguments by name.
+  partial_count is the number of arguments matched by partial name and dots
+  is 1 if formals has a ... argument. match_time is in nanoseconds. Calls
+  whose arguments do not match fail before the probe fires.
+  ***************************************************************************/
+  void (*probe_match_args)(dyntrace_context_t *dyntrace_context,
+                           const SEXP call, const SEXP formals,
+                           int formals_count, int supplied_count,
+                           int partial_count, int dots, uint64_t match_time);
+
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_CONTEXT_ENTRY(...) in
+  - src/main/context.c
+  Fires at the end of begincontext, cptr is R_GlobalContext. Its callflag
+  (CTXT_*), call, cloenv and depth (number of contexts below it) are set.
+  The caller runs SETJMP on cptr->cjmpbuf after the probe.
+  ***************************************************************************/
+  void (*probe_context_entry)(dyntrace_context_t *dyntrace_context,
+                              const struct RCNTXT *cptr);
+
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_CONTEXT_EXIT(...) in
+  - src/main/context.c
+  Fires when endcontext leaves cptr normally, after its on.exit code ran.
+  Contexts left by a longjmp are reported by probe_context_unwind instead.
+  ***************************************************************************/
+  void (*probe_context_exit)(dyntrace_context_t *dyntrace_context,
+                             const struct RCNTXT *cptr);
+
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_CONTEXT_UNWIND(...) in
+  - src/main/context.c
+  Fires in R_jumpctxt right before the longjmp to cptr, which stays active.
+  contexts is the number of contexts above cptr the jump leaves. target is
+  the final target of the jump. When a context in between has on.exit code,
+  cptr is that context, and the jump continues from endcontext after the
+  code ran, so one jump can be reported in several steps. onexits counts the C
+  cleanup thunks run before the longjmp and the on.exit code of cptr if it
+  is not the target. unwind_time (nanoseconds) covers the thunks and the
+  restoring of the interpreter state. A jump out of a probe, when the probe
+  raises an error, is not reported.
+  ***************************************************************************/
+  void (*probe_context_unwind)(dyntrace_context_t *dyntrace_context,
+                               const struct RCNTXT *cptr,
+                               const struct RCNTXT *target, const SEXP val,
+                               int contexts, int onexits,
+                               uint64_t unwind_time);
+
   /***************************************************************************
   Look for DYNTRACE_PROBE_ENVIRONMENT_DEFINE_VAR(...) in
   - src/main/envir.c
@@ -665,12 +1058,92 @@ typedef struct {
   /***************************************************************************
   Look for DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(...) in
   - src/main/envir.c
+  depth is the number of environments findVar searched before the one that
+  had the binding (0 if the first one had it). global_cache is
+  DYNTRACE_GLOBAL_CACHE_HIT when the global cache answered, in which case rho
+  is R_GlobalEnv and depth counts the local frames searched before it,
+  DYNTRACE_GLOBAL_CACHE_MISS when the search went past R_GlobalEnv without
+  the cache and DYNTRACE_GLOBAL_CACHE_UNUSED for bindings found in local
+  frames. findFun reports every binding it finds on the way, also those it
+  skips because they are not functions; a function of base found through the
+  base symbol cache is a DYNTRACE_GLOBAL_CACHE_HIT with rho R_BaseEnv.
   ***************************************************************************/
   void (*probe_environment_lookup_var)(dyntrace_context_t *dyntrace_context,
-                                       SEXP symbol, SEXP value, SEXP rho);
+                                       SEXP symbol, SEXP value, SEXP rho,
+                                       int depth, int global_cache);
+
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_FORK_PARENT(...) in
+  - src/library/parallel/src/fork.c
+  Fires in the parent after mc_fork (mcparallel, mclapply) forked child_pid.
+  estranged is 1 for children the parent does not keep track of.
+  ***************************************************************************/
+  void (*probe_fork_parent)(dyntrace_context_t *dyntrace_context,
+                            pid_t child_pid, int estranged);
+
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_FORK_CHILD(...) in
+  - src/library/parallel/src/fork.c
+  Fires in the child after mc_fork, before it runs any R code. The child
+  inherits the dyntracer and its context: tracers switch to an output of
+  their own here, e.g. one named after getpid(), and move their ids to a
+  range the parent does not use. execution_count and execution_time are
+  reset, the child reports its own.
+  ***************************************************************************/
+  void (*probe_fork_child)(dyntrace_context_t *dyntrace_context,
+                           pid_t parent_pid);
+
+  /***************************************************************************
+  Look for DYNTRACE_PROBE_FORK_CHILD_EXIT(...) in
+  - src/library/parallel/src/fork.c
+  Fires when a forked child leaves with mcexit. The child calls _exit and
+  never returns to dyntrace(), so probe_end does not fire in it: this is
+  where tracers write the output of the child. program_time and
+  probe_overhead are set as for probe_end.
+  ***************************************************************************/
+  void (*probe_fork_child_exit)(dyntrace_context_t *dyntrace_context,
+                                int status);
+
+  // Types of the expressions the eval probes fire for, an or of
+  // DYNTRACE_SEXPTYPE_MASK(type), e.g. DYNTRACE_SEXPTYPE_MASK(LANGSXP) |
+  // DYNTRACE_SEXPTYPE_MASK(SYMSXP) for calls and variable lookups. 0, the
+  // default of a zeroed dyntracer_t, traces every type.
+  unsigned int eval_type_mask;
+
+  // Set by tracers whose probes never allocate on the R heap, e.g. because
+  // they only use the inspection helpers below and a dyntrace_arena_t. The
+  // collector then stays enabled while their probes run: it cannot be
+  // triggered by them.
+  int non_allocating;
+
+  // Set by tracers which want probe_vector_alloc for the vectors in the small
+  // node classes too. Otherwise it only fires for one-element and large
+  // vectors.
+  int small_vector_alloc;
   void *context;
 } dyntracer_t;
 
+// ----------------------------------------------------------------------------
+// PLUGIN ABI - checked by dyntraceLoad before calling create_dyntracer
+// ----------------------------------------------------------------------------
+
+// Bump when dyntracer_t, the probe signatures or the types they pass change.
+#define DYNTRACE_ABI_VERSION 4
+
+typedef struct {
+  int abi_version;
+  size_t dyntracer_size;
+  int probe_count;
+} dyntrace_plugin_abi_t;
+
+// Exported by tracer plugins, which define it with DYNTRACE_PLUGIN_ABI in
+// the file that defines create_dyntracer and destroy_dyntracer.
+extern const dyntrace_plugin_abi_t dyntrace_plugin_abi;
+
+#define DYNTRACE_PLUGIN_ABI                                                    \
+  const dyntrace_plugin_abi_t dyntrace_plugin_abi = {                          \
+      DYNTRACE_ABI_VERSION, sizeof(dyntracer_t), DYNTRACE_PROBE_COUNT}
+
 // ----------------------------------------------------------------------------
 // STATE VARIABLES - For Internal Use Only
 // ----------------------------------------------------------------------------
@@ -687,6 +1160,13 @@ extern dyntrace_context_t *dyntrace_active_dyntrace_context;
 extern clock_t dyntrace_stopwatch;
 // flag for checking if we are in privileged mode
 extern int dyntrace_privileged_mode_flag;
+// set when the trace has an overhead budget
+extern int dyntrace_governor_enabled;
+// whether the trace records or replays its nondeterministic inputs
+#define DYNTRACE_REPLAY_OFF 0
+#define DYNTRACE_REPLAY_RECORD 1
+#define DYNTRACE_REPLAY_REPLAY 2
+extern int dyntrace_replay_mode;
 
 SEXP do_dyntrace(SEXP call, SEXP op, SEXP args, SEXP rho);
 int dyntrace_is_active();
@@ -699,6 +1179,22 @@ void dyntrace_enable_privileged_mode();
 void dyntrace_disable_privileged_mode();
 int dyntrace_is_priviliged_mode();
 clock_t dyntrace_reset_stopwatch();
+uint64_t dyntrace_timestamp();
+clock_t dyntrace_jit_compile_begin();
+void dyntrace_subtract_probe_overhead(dyntracing_context_t *dyntracing_context);
+void dyntrace_fork_child_begin();
+void dyntrace_fork_child_end();
+int dyntrace_governor_admit(int probe);
+int dyntrace_replay_allocate();
+void dyntrace_replay_collect();
+double dyntrace_replay_time(double time);
+#ifdef ENABLE_DYNTRACE_OPCODES
+// opcode counts of bcEval, see do_dyntraceopcodes in src/main/eval.c
+struct dyntrace_opcodes_t;
+struct dyntrace_opcodes_t *dyntrace_opcodes_begin(void);
+void dyntrace_opcodes_end(struct dyntrace_opcodes_t *outer);
+#endif
+void dyntrace_jit_compile_end(clock_t expression_time);
 dyntracer_t *dyntracer_from_sexp(SEXP dyntracer_sexp);
 SEXP dyntracer_to_sexp(dyntracer_t *dyntracer, const char *classname);
 dyntracer_t *dyntracer_replace_sexp(SEXP dyntracer_sexp,
@@ -715,6 +1211,57 @@ SEXP get_named_list_element(const SEXP list, const char *name);
 char *serialize_sexp(SEXP s);
 const char *get_string(SEXP sexp);
 int newhashpjw(const char *s);
+int dyntrace_expression_size(SEXP expression);
+extern const char *dyntrace_probe_names[DYNTRACE_PROBE_COUNT];
+
+// ----------------------------------------------------------------------------
+// tracer arena - bump allocator for data kept by probes, allocates blocks of
+// block_size bytes with malloc; nothing is freed before reset or destroy.
+// dyntrace_arena_create, dyntrace_arena_alloc and dyntrace_arena_strdup
+// return NULL when malloc fails, the arena stays usable
+// ----------------------------------------------------------------------------
+
+typedef struct dyntrace_arena_block_t dyntrace_arena_block_t;
+
+typedef struct {
+  dyntrace_arena_block_t *blocks;
+  size_t block_size;
+  // bytes of all the blocks
+  size_t allocated;
+} dyntrace_arena_t;
+
+dyntrace_arena_t *dyntrace_arena_create(size_t block_size);
+void *dyntrace_arena_alloc(dyntrace_arena_t *arena, size_t size);
+char *dyntrace_arena_strdup(dyntrace_arena_t *arena, const char *string);
+void dyntrace_arena_reset(dyntrace_arena_t *arena);
+void dyntrace_arena_destroy(dyntrace_arena_t *arena);
+
+// ----------------------------------------------------------------------------
+// inspection helpers - safe in probes: they neither allocate on the R heap
+// nor fire probes. Returned strings are owned by R (CHARSXPs, symbols) and
+// live at least as long as the inspected objects, except for type signatures
+// which are copied to the arena (NULL if the arena is out of memory).
+// ----------------------------------------------------------------------------
+
+typedef struct {
+  // NULL if the srcfile has no file name
+  const char *filename;
+  int line;
+  int column;
+} dyntrace_srcref_t;
+
+void dyntrace_install_symbols();
+// f for f(...), pkg::f(...) and pkg:::f(...), NULL for anonymous calls
+const char *dyntrace_get_call_name(SEXP call);
+// namespace rho or one of its enclosures belongs to, NULL if there is none
+// before R_GlobalEnv
+const char *dyntrace_get_namespace_name(SEXP rho);
+// attribute name of x, R_NilValue if x has none; getAttrib returns
+// R_NilValue while a probe runs
+SEXP dyntrace_get_attribute(SEXP x, SEXP name);
+// 0 if srcref is not a srcref, e.g. R_Srcref in byte-compiled code
+int dyntrace_get_srcref(SEXP srcref, dyntrace_srcref_t *location);
+const char *dyntrace_get_type_signature(SEXP value, dyntrace_arena_t *arena);
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,7 @@
 #endif
 #define NO_NLS
 #include <Defn.h> // for R_isForkedChild
+#include <Rdyntrace.h>
 
 #include "parallel.h"
 
@@ -298,8 +299,10 @@ SEXP mc_fork(SEXP sEstranged)
 #ifdef MC_DEBUG
 	Dprintf("child process %d started\n", getpid());
 #endif
+	DYNTRACE_PROBE_FORK_CHILD(getppid());
     } else { /* master process */
 	child_info_t *ci;
+	DYNTRACE_PROBE_FORK_PARENT(pid, estranged);
 	if (estranged) { /* don't even register it */
 	    res_i[1] = res_i[2] = NA_INTEGER;
 	    return res;
@@ -709,6 +712,9 @@ SEXP NORET mc_exit(SEXP sRes)
     Dprintf("child %d: 'mcexit' called\n", getpid());
 #endif
     if (is_master) error(_("'mcexit' can only be used in a child process"));
+    /* before the master is told, so that the output of the child is complete
+       once the master sees it leave */
+    DYNTRACE_PROBE_FORK_CHILD_EXIT(res);
     if (master_fd != -1) { /* send 0 to signify that we're leaving */
 	size_t len = 0;
 	/* assign result for Fedora security settings */
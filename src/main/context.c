@@ -213,12 +213,32 @@ void attribute_hidden NORET R_jumpctxt(RCNTXT * targetcptr, int mask, SEXP val)
 {
     Rboolean savevis = R_Visible;
     RCNTXT *cptr;
+#ifdef ENABLE_DYNTRACE
+    uint64_t dyntrace_start =
+	DYNTRACE_PROBE_IS_ATTACHED(probe_context_unwind) ?
+	dyntrace_timestamp() : 0;
+    int dyntrace_onexits = 0;
+#endif
 
     /* find the target for the first jump -- either an intermediate
        context with an on.exit action to run or the final target if
        there are no intermediate on.exit actions */
     cptr = first_jump_target(targetcptr, mask);
 
+#ifdef ENABLE_DYNTRACE
+    /* C thunks run by R_run_onexits and the on.exit code of an
+       intermediate target, run by endcontext after the jump */
+    if (dyntrace_start != 0) {
+	RCNTXT *c;
+	for (c = R_GlobalContext; c != NULL && c != cptr; c = c->nextcontext)
+	    if (c->cend != NULL)
+		dyntrace_onexits++;
+	if (cptr != targetcptr)
+	    dyntrace_onexits++;
+    }
+    int dyntrace_contexts = R_GlobalContext->depth - cptr->depth;
+#endif
+
     /* run cend code for all contexts down to but not including
        the first jump target */
     cptr->returnValue = val;/* in case the on.exit code wants to see it */
@@ -236,6 +256,8 @@ void attribute_hidden NORET R_jumpctxt(RCNTXT * targetcptr, int mask, SEXP val)
 	R_OldCStackLimit = 0;
     }
 
+    DYNTRACE_PROBE_CONTEXT_UNWIND(cptr, targetcptr, val, dyntrace_contexts,
+				  dyntrace_onexits, dyntrace_start);
     LONGJMP(cptr->cjmpbuf, mask);
 }
 
@@ -276,8 +298,11 @@ void begincontext(RCNTXT * cptr, int flags,
     cptr->returnValue = NULL;
     cptr->jumptarget = NULL;
     cptr->jumpmask = 0;
+    cptr->depth = R_GlobalContext->depth + 1;
 
     R_GlobalContext = cptr;
+
+    DYNTRACE_PROBE_CONTEXT_ENTRY(cptr);
 }
 
 
@@ -305,6 +330,7 @@ void endcontext(RCNTXT * cptr)
     if (cptr->jumptarget)
 	R_jumpctxt(cptr->jumptarget, cptr->jumpmask, cptr->returnValue);
 
+    DYNTRACE_PROBE_CONTEXT_EXIT(cptr);
     R_GlobalContext = cptr->nextcontext;
 }
 
@@ -28,6 +28,7 @@
 #include <R_ext/RS.h> /* S4 bit */
 
 #include "duplicate.h"
+#include <Rdyntrace.h>
 
 /*  duplicate  -  object duplication  */
 
@@ -40,6 +41,15 @@
  *  promises requires that the promises be forced and
  *  the value duplicated.  */
 
+#ifdef ENABLE_DYNTRACE
+/* Bytes copied by the running duplicate() or shallow_duplicate(), reported
+   by DYNTRACE_PROBE_DUPLICATE. */
+static R_size_t dyntrace_duplicate_bytes = 0;
+# define DYNTRACE_COUNT_DUPLICATE(bytes) (dyntrace_duplicate_bytes += (bytes))
+#else
+# define DYNTRACE_COUNT_DUPLICATE(bytes)
+#endif
+
 #define COPY_TRUELENGTH(to, from) do {			\
 	if (! IS_GROWABLE(from))			\
 	    SET_TRUELENGTH(to, XTRUELENGTH(from));	\
@@ -56,6 +66,7 @@
   R_xlen_t __n__ = XLENGTH(from); \
   PROTECT(from); \
   PROTECT(to = allocVector(TYPEOF(from), __n__)); \
+  DYNTRACE_COUNT_DUPLICATE(__n__ * sizeof(type)); \
   if (__n__ == 1) fun(to)[0] = fun(from)[0]; \
   else { \
       R_xlen_t __this; \
@@ -75,6 +86,7 @@
   R_xlen_t __n__ = XLENGTH(from); \
   PROTECT(from); \
   PROTECT(to = allocVector(TYPEOF(from), __n__)); \
+  DYNTRACE_COUNT_DUPLICATE(__n__ * sizeof(type)); \
   if (__n__ == 1) fun(to)[0] = fun(from)[0]; \
   else memcpy(fun(to), fun(from), __n__ * sizeof(type)); \
   DUPLICATE_ATTRIB(to, from, deep); \
@@ -135,8 +147,19 @@ SEXP duplicate(SEXP s){
 
 #ifdef R_PROFILING
     duplicate_counter++;
+#endif
+#ifdef ENABLE_DYNTRACE
+    /* the collector may run finalizers that duplicate while we copy */
+    R_size_t dyntrace_outer_bytes = dyntrace_duplicate_bytes;
+    dyntrace_duplicate_bytes = 0;
 #endif
     t = duplicate1(s, TRUE);
+#ifdef ENABLE_DYNTRACE
+    if (t != s) {
+	DYNTRACE_PROBE_DUPLICATE(s, t, TRUE, dyntrace_duplicate_bytes);
+    }
+    dyntrace_duplicate_bytes = dyntrace_outer_bytes;
+#endif
 #ifdef R_MEMORY_PROFILING
     if (RTRACE(s) && !(TYPEOF(s) == CLOSXP || TYPEOF(s) == BUILTINSXP ||
 		      TYPEOF(s) == SPECIALSXP || TYPEOF(s) == PROMSXP ||
@@ -154,8 +177,19 @@ SEXP shallow_duplicate(SEXP s)
 
 #ifdef R_PROFILING
     duplicate_counter++;
+#endif
+#ifdef ENABLE_DYNTRACE
+    /* the collector may run finalizers that duplicate while we copy */
+    R_size_t dyntrace_outer_bytes = dyntrace_duplicate_bytes;
+    dyntrace_duplicate_bytes = 0;
 #endif
     t = duplicate1(s, FALSE);
+#ifdef ENABLE_DYNTRACE
+    if (t != s) {
+	DYNTRACE_PROBE_DUPLICATE(s, t, FALSE, dyntrace_duplicate_bytes);
+    }
+    dyntrace_duplicate_bytes = dyntrace_outer_bytes;
+#endif
 #ifdef R_MEMORY_PROFILING
     if (RTRACE(s) && !(TYPEOF(s) == CLOSXP || TYPEOF(s) == BUILTINSXP ||
 		      TYPEOF(s) == SPECIALSXP || TYPEOF(s) == PROMSXP ||
@@ -260,8 +294,10 @@ static R_INLINE SEXP duplicate_list(SEXP s, Rboolean deep)
     PROTECT(s);
 
     val = R_NilValue;
-    for (sp = s; sp != R_NilValue; sp = CDR(sp))
+    for (sp = s; sp != R_NilValue; sp = CDR(sp)) {
 	val = CONS(R_NilValue, val);
+	DYNTRACE_COUNT_DUPLICATE(sizeof(SEXPREC));
+    }
 
     PROTECT(val);
     for (sp = s, vp = val; sp != R_NilValue; sp = CDR(sp), vp = CDR(vp)) {
@@ -291,6 +327,7 @@ static SEXP duplicate1(SEXP s, Rboolean deep)
     case CLOSXP:
 	PROTECT(s);
 	PROTECT(t = allocSExp(CLOSXP));
+	DYNTRACE_COUNT_DUPLICATE(sizeof(SEXPREC));
 	SET_FORMALS(t, FORMALS(s));
 	SET_BODY(t, BODY(s));
 	SET_CLOENV(t, CLOENV(s));
@@ -326,6 +363,7 @@ static SEXP duplicate1(SEXP s, Rboolean deep)
 	n = XLENGTH(s);
 	PROTECT(s);
 	PROTECT(t = allocVector(TYPEOF(s), n));
+	DYNTRACE_COUNT_DUPLICATE(n * sizeof(SEXP));
 	for(i = 0 ; i < n ; i++)
 	    SET_VECTOR_ELT(t, i, duplicate_child(VECTOR_ELT(s, i), deep));
 	DUPLICATE_ATTRIB(t, s, deep);
@@ -349,6 +387,7 @@ static SEXP duplicate1(SEXP s, Rboolean deep)
     case S4SXP:
 	PROTECT(s);
 	PROTECT(t = allocS4Object());
+	DYNTRACE_COUNT_DUPLICATE(sizeof(SEXPREC));
 	DUPLICATE_ATTRIB(t, s, deep);
 	UNPROTECT(2);
 	break;
@@ -1,3 +1,9 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#define R_USE_SIGNALS 1
+#include <Defn.h>
 #include <Rdyntrace.h>
 #include <Rinternals.h>
 #include <dlfcn.h>
@@ -5,7 +11,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
-#include <deparse.h>
+#include "deparse.h"
 
 #if !defined(HAVE_CLOCK_GETTIME) && defined(__MACH__)
 #include <mach/clock.h>
@@ -18,6 +24,7 @@ const char *dyntrace_active_dyntracer_probe_name = NULL;
 int dyntrace_garbage_collector_state = 0;
 clock_t dyntrace_stopwatch;
 int dyntrace_privileged_mode_flag = 0;
+int dyntrace_governor_enabled = 0;
 
 dyntracer_t * dyntracer_from_sexp(SEXP dyntracer_sexp) {
     return (dyntracer_t *)R_ExternalPtrAddr(dyntracer_sexp);
@@ -66,9 +73,60 @@ int dyntrace_is_priviliged_mode() {
     return dyntrace_privileged_mode_flag;  
 }
 
+/* in the order of the fields of execution_count_t and execution_time_t */
+const char *dyntrace_probe_names[DYNTRACE_PROBE_COUNT] = {
+    "probe_begin",
+    "probe_end",
+    "probe_function_entry",
+    "probe_function_exit",
+    "probe_builtin_entry",
+    "probe_builtin_exit",
+    "probe_specialsxp_entry",
+    "probe_specialsxp_exit",
+    "probe_promise_created",
+    "probe_promise_force_entry",
+    "probe_promise_force_exit",
+    "probe_promise_value_lookup",
+    "probe_promise_expression_lookup",
+    "probe_error",
+    "probe_vector_alloc",
+    "probe_duplicate",
+    "probe_eval_entry",
+    "probe_eval_exit",
+    "probe_gc_entry",
+    "probe_gc_exit",
+    "probe_gc_promise_unmarked",
+    "probe_jump_ctxt",
+    "probe_new_environment",
+    "probe_S3_generic_entry",
+    "probe_S3_generic_exit",
+    "probe_S3_dispatch_entry",
+    "probe_S3_dispatch_exit",
+    "probe_S3_method_lookup",
+    "probe_jit_compile_entry",
+    "probe_jit_compile_exit",
+    "probe_match_args",
+    "probe_context_entry",
+    "probe_context_exit",
+    "probe_context_unwind",
+    "probe_environment_define_var",
+    "probe_environment_assign_var",
+    "probe_environment_remove_var",
+    "probe_environment_lookup_var",
+    "probe_fork_parent",
+    "probe_fork_child",
+    "probe_fork_child_exit"
+};
+
+typedef char dyntrace_probe_count_check
+    [sizeof(execution_count_t) == (DYNTRACE_PROBE_COUNT + 1) * sizeof(uint64_t) &&
+     sizeof(execution_time_t) == (DYNTRACE_PROBE_COUNT + 2) * sizeof(clock_t)
+     ? 1 : -1];
+
+/* ctime returns a static buffer, begin_datetime and end_datetime need copies */
 static const char * get_current_datetime() {
     time_t current_time = time(NULL);
-    return ctime(&current_time);
+    return strdup(ctime(&current_time));
 }
 
 static void assign_environment_variables(environment_variables_t * environment_variables) {
@@ -94,28 +152,819 @@ static dyntrace_context_t * create_dyntrace_context(dyntracer_t * dyntracer) {
 }
 
 static void destroy_dyntrace_context(dyntrace_context_t * dyntrace_context) {
+    free(dyntrace_context -> dyntracing_context -> governor_decisions);
+    free((char *) dyntrace_context -> dyntracing_context -> begin_datetime);
+    free((char *) dyntrace_context -> dyntracing_context -> end_datetime);
     free(dyntrace_context -> dyntracing_context);
     free(dyntrace_context);
 }
 
+#define DYNTRACE_CALIBRATION_PROBES 10000
+
+static void dyntrace_calibration_probe(dyntrace_context_t *dyntrace_context,
+                                       const SEXP prom) {
+}
+
+/* Fires an empty probe through the probe macros with a scratch context and
+   stores its cost in the context of the trace. The cost only depends on
+   whether the garbage collector is toggled, it is measured once for each
+   setting. */
+static void dyntrace_calibrate(dyntracer_t *dyntracer,
+                               dyntrace_context_t *dyntrace_context) {
+    static int calibrated[2] = {0, 0};
+    static double expression_overhead[2], hook_overhead[2];
+    int non_allocating = dyntracer->non_allocating != 0;
+
+#ifdef ENABLE_DYNTRACE
+    if (!calibrated[non_allocating]) {
+        dyntracer_t calibration_dyntracer;
+        dyntrace_context_t *calibration_context;
+        execution_time_t *execution_time;
+        /* the outer trace when dyntrace() is nested */
+        dyntracer_t *previous_dyntracer = dyntrace_active_dyntracer;
+        dyntrace_context_t *previous_context = dyntrace_active_dyntrace_context;
+        clock_t previous_stopwatch = dyntrace_stopwatch;
+        int previous_governor_enabled = dyntrace_governor_enabled;
+        int i;
+
+        memset(&calibration_dyntracer, 0, sizeof(dyntracer_t));
+        calibration_dyntracer.probe_begin = dyntrace_calibration_probe;
+        calibration_dyntracer.non_allocating = non_allocating;
+        calibration_context = create_dyntrace_context(&calibration_dyntracer);
+        execution_time = &calibration_context -> dyntracing_context -> execution_time;
+
+        /* every calibration probe fires, whatever the governor admits */
+        dyntrace_governor_enabled = 0;
+        dyntrace_active_dyntracer = &calibration_dyntracer;
+        dyntrace_active_dyntrace_context = calibration_context;
+        dyntrace_stopwatch = clock();
+        for (i = 0; i < DYNTRACE_CALIBRATION_PROBES; ++i) {
+            DYNTRACE_PROBE_BEGIN(R_NilValue);
+        }
+        execution_time -> expression += dyntrace_reset_stopwatch();
+        dyntrace_active_dyntrace_context = previous_context;
+        dyntrace_active_dyntracer = previous_dyntracer;
+        dyntrace_stopwatch = previous_stopwatch;
+        dyntrace_governor_enabled = previous_governor_enabled;
+
+        expression_overhead[non_allocating] =
+            (double) execution_time -> expression / DYNTRACE_CALIBRATION_PROBES;
+        hook_overhead[non_allocating] =
+            (double) execution_time -> probe_begin / DYNTRACE_CALIBRATION_PROBES;
+        calibrated[non_allocating] = 1;
+        destroy_dyntrace_context(calibration_context);
+    }
+#endif
+
+    dyntrace_context -> dyntracing_context -> probe_expression_overhead =
+        expression_overhead[non_allocating];
+    dyntrace_context -> dyntracing_context -> probe_hook_overhead =
+        hook_overhead[non_allocating];
+}
+
+void dyntrace_subtract_probe_overhead(dyntracing_context_t * dyntracing_context) {
+    /* all the fields are probe counters but expression, which is last */
+    uint64_t * counters = (uint64_t *) &dyntracing_context -> execution_count;
+    double fired = 0, overhead;
+    clock_t expression;
+    int i;
+
+    for (i = 0; i < DYNTRACE_PROBE_COUNT; ++i)
+        fired += counters[i];
+    /* probe_end fires after this */
+    fired++;
+
+    dyntracing_context -> execution_time.expression += dyntrace_reset_stopwatch();
+    expression = dyntracing_context -> execution_time.expression;
+    overhead = fired * dyntracing_context -> probe_expression_overhead;
+    if (overhead > expression)
+        overhead = expression;
+    dyntracing_context -> program_time = expression - (clock_t) overhead;
+    dyntracing_context -> probe_overhead =
+        (clock_t) (overhead + fired * dyntracing_context -> probe_hook_overhead);
+}
+
+/* statistics of the last dyntrace() call, see do_dyntracestatistics */
+static SEXP dyntrace_statistics = NULL;
+
+static SEXP mk_datetime(const char * datetime) {
+    if (datetime == NULL)
+        return ScalarString(NA_STRING);
+    /* without the newline of ctime */
+    return ScalarString(mkCharLen(datetime, strcspn(datetime, "\n")));
+}
+
+static SEXP mk_named_list(int length, const char ** names) {
+    SEXP list = PROTECT(allocVector(VECSXP, length));
+    SEXP list_names = allocVector(STRSXP, length);
+    setAttrib(list, R_NamesSymbol, list_names);
+    for (int i = 0; i < length; ++i)
+        SET_STRING_ELT(list_names, i, mkChar(names[i]));
+    UNPROTECT(1);
+    return list;
+}
+
+static SEXP mk_named_real(int length, const char ** names) {
+    SEXP vector = PROTECT(allocVector(REALSXP, length));
+    SEXP vector_names = allocVector(STRSXP, length);
+    setAttrib(vector, R_NamesSymbol, vector_names);
+    for (int i = 0; i < length; ++i)
+        SET_STRING_ELT(vector_names, i, mkChar(names[i]));
+    UNPROTECT(1);
+    return vector;
+}
+
+/* Copies the dyntracing context to an R list before it is destroyed. Counts
+   are doubles, exact up to 2^53, times are in seconds. */
+static void dyntrace_save_statistics(dyntracing_context_t * dyntracing_context) {
+    static const char * names[] = {
+        "begin", "end", "counts", "times", "program_time", "probe_overhead",
+        "probe_expression_overhead", "probe_hook_overhead", "environment",
+        "overhead_budget", "skipped", "governor"
+    };
+    static const char * decision_names[] = {
+        "probe", "period", "overhead", "program_time"
+    };
+    /* the probes and the two times of execution_time_t that are not probes */
+    const char * time_names[DYNTRACE_PROBE_COUNT + 2];
+    static const char * variable_names[] = {
+        "R_COMPILE_PKGS", "R_DISABLE_BYTECODE", "R_ENABLE_JIT",
+        "R_KEEP_PKG_SOURCE"
+    };
+    environment_variables_t * variables = &dyntracing_context -> environment_variables;
+    const char * variable_values[] = {
+        variables -> r_compile_pkgs, variables -> r_disable_bytecode,
+        variables -> r_enable_jit, variables -> r_keep_pkg_source
+    };
+    uint64_t * counts = (uint64_t *) &dyntracing_context -> execution_count;
+    uint64_t * skipped = (uint64_t *) &dyntracing_context -> skipped_count;
+    clock_t * times = (clock_t *) &dyntracing_context -> execution_time;
+    dyntrace_governor_decision_t * decisions = dyntracing_context -> governor_decisions;
+    int decision_count = dyntracing_context -> governor_decision_count;
+    SEXP statistics, counts_sexp, times_sexp, environment;
+    SEXP skipped_sexp, governor, column;
+    int i;
+
+    memcpy(time_names, dyntrace_probe_names, sizeof(dyntrace_probe_names));
+    time_names[DYNTRACE_PROBE_COUNT] = "expression";
+    time_names[DYNTRACE_PROBE_COUNT + 1] = "jit_compile";
+
+    PROTECT(statistics = mk_named_list(12, names));
+    SET_VECTOR_ELT(statistics, 0, mk_datetime(dyntracing_context -> begin_datetime));
+    SET_VECTOR_ELT(statistics, 1, mk_datetime(dyntracing_context -> end_datetime));
+
+    counts_sexp = mk_named_real(DYNTRACE_PROBE_COUNT, dyntrace_probe_names);
+    SET_VECTOR_ELT(statistics, 2, counts_sexp);
+    for (i = 0; i < DYNTRACE_PROBE_COUNT; ++i)
+        REAL(counts_sexp)[i] = (double) counts[i];
+
+    times_sexp = mk_named_real(DYNTRACE_PROBE_COUNT + 2, time_names);
+    SET_VECTOR_ELT(statistics, 3, times_sexp);
+    for (i = 0; i < DYNTRACE_PROBE_COUNT + 2; ++i)
+        REAL(times_sexp)[i] = (double) times[i] / CLOCKS_PER_SEC;
+
+    SET_VECTOR_ELT(statistics, 4,
+                   ScalarReal((double) dyntracing_context -> program_time / CLOCKS_PER_SEC));
+    SET_VECTOR_ELT(statistics, 5,
+                   ScalarReal((double) dyntracing_context -> probe_overhead / CLOCKS_PER_SEC));
+    SET_VECTOR_ELT(statistics, 6,
+                   ScalarReal(dyntracing_context -> probe_expression_overhead / CLOCKS_PER_SEC));
+    SET_VECTOR_ELT(statistics, 7,
+                   ScalarReal(dyntracing_context -> probe_hook_overhead / CLOCKS_PER_SEC));
+
+    environment = allocVector(STRSXP, 4);
+    SET_VECTOR_ELT(statistics, 8, environment);
+    setAttrib(environment, R_NamesSymbol, allocVector(STRSXP, 4));
+    for (i = 0; i < 4; ++i) {
+        SET_STRING_ELT(environment, i,
+                       variable_values[i] ? mkChar(variable_values[i]) : NA_STRING);
+        SET_STRING_ELT(getAttrib(environment, R_NamesSymbol), i,
+                       mkChar(variable_names[i]));
+    }
+
+    SET_VECTOR_ELT(statistics, 9, ScalarReal(dyntracing_context -> overhead_budget));
+    skipped_sexp = mk_named_real(DYNTRACE_PROBE_COUNT, dyntrace_probe_names);
+    SET_VECTOR_ELT(statistics, 10, skipped_sexp);
+    for (i = 0; i < DYNTRACE_PROBE_COUNT; ++i)
+        REAL(skipped_sexp)[i] = (double) skipped[i];
+
+    /* decisions of the governor, one element per decision in each column */
+    governor = mk_named_list(4, decision_names);
+    SET_VECTOR_ELT(statistics, 11, governor);
+    SET_VECTOR_ELT(governor, 0, column = allocVector(STRSXP, decision_count));
+    for (i = 0; i < decision_count; ++i)
+        SET_STRING_ELT(column, i, mkChar(dyntrace_probe_names[decisions[i].probe]));
+    SET_VECTOR_ELT(governor, 1, column = allocVector(INTSXP, decision_count));
+    for (i = 0; i < decision_count; ++i)
+        INTEGER(column)[i] = decisions[i].period;
+    SET_VECTOR_ELT(governor, 2, column = allocVector(REALSXP, decision_count));
+    for (i = 0; i < decision_count; ++i)
+        REAL(column)[i] = decisions[i].overhead;
+    SET_VECTOR_ELT(governor, 3, column = allocVector(REALSXP, decision_count));
+    for (i = 0; i < decision_count; ++i)
+        REAL(column)[i] = (double) decisions[i].program_time / CLOCKS_PER_SEC;
+
+    if (dyntrace_statistics != NULL)
+        R_ReleaseObject(dyntrace_statistics);
+    R_PreserveObject(dyntrace_statistics = statistics);
+    UNPROTECT(1);
+}
+
+/* .Internal(dyntracestatistics()): NULL before the first dyntrace() call */
+SEXP attribute_hidden do_dyntracestatistics(SEXP call, SEXP op, SEXP args,
+                                            SEXP rho) {
+    checkArity(op, args);
+    return dyntrace_statistics == NULL ? R_NilValue : dyntrace_statistics;
+}
+
+//-----------------------------------------------------------------------------
+// overhead governor
+//-----------------------------------------------------------------------------
+
+/* Every DYNTRACE_GOVERNOR_WINDOW probes, the governor compares the time of
+   the probes to the program time over the window. Above the budget, it
+   throttles the probe (or the entry/exit group) that cost the most in the
+   window: event probes fire every DYNTRACE_GOVERNOR_SAMPLING times more
+   rarely, up to DYNTRACE_GOVERNOR_MAX_PERIOD, after which they are disabled
+   like the groups. One decision per window, so that the effect of the last
+   one is measured before the next.
+
+   A group is not disabled at once. Its entries are, but the exits of the
+   entries admitted before stay admitted, until they have all fired, so that
+   tracers keeping a stack see every frame they pushed popped. To tell these
+   exits apart, each group keeps the depths of its open admitted entries:
+   the context depth for the context probes, R_EvalDepth for the others.
+   Both are restored by longjmps, and entries of one group nest at strictly
+   increasing depths, so the frames a longjmp skipped are those deeper than
+   the next entry or exit of the group. */
+#define DYNTRACE_GOVERNOR_WINDOW 65536
+#define DYNTRACE_GOVERNOR_SAMPLING 4
+#define DYNTRACE_GOVERNOR_MAX_PERIOD 1024
+
+#define DYNTRACE_GOVERNOR_FIXED -1
+#define DYNTRACE_GOVERNOR_EVENT 0
+#define DYNTRACE_GOVERNOR_GROUPS 11
+
+/* roles of the probes of a group */
+#define DYNTRACE_GOVERNOR_ENTRY 1
+#define DYNTRACE_GOVERNOR_EXIT 2
+#define DYNTRACE_GOVERNOR_UNWIND 3
+
+typedef struct {
+    int *depths;
+    int size;
+    int capacity;
+} dyntrace_governor_frames_t;
+
+typedef struct {
+    dyntracing_context_t *dyntracing_context;
+    /* 1 fires every probe, 0 none */
+    unsigned int periods[DYNTRACE_PROBE_COUNT];
+    unsigned int phases[DYNTRACE_PROBE_COUNT];
+    /* DYNTRACE_GOVERNOR_FIXED, DYNTRACE_GOVERNOR_EVENT or the group */
+    int groups[DYNTRACE_PROBE_COUNT];
+    /* 0 for probes outside groups */
+    int roles[DYNTRACE_PROBE_COUNT];
+    /* open admitted entries of each group */
+    dyntrace_governor_frames_t frames[DYNTRACE_GOVERNOR_GROUPS];
+    int countdown;
+    execution_time_t window_time;
+    execution_count_t window_count;
+} dyntrace_governor_t;
+
+static dyntrace_governor_t dyntrace_governor;
+
+/* entry and exit probes are throttled together, a tracer seeing one without
+   the other would lose track of its stack */
+static void dyntrace_governor_init_groups() {
+    int *groups = dyntrace_governor.groups;
+    int *roles = dyntrace_governor.roles;
+    int i;
+    for (i = 0; i < DYNTRACE_PROBE_COUNT; ++i) {
+        groups[i] = DYNTRACE_GOVERNOR_EVENT;
+        roles[i] = 0;
+    }
+
+    groups[DYNTRACE_PROBE_INDEX(probe_begin)] = DYNTRACE_GOVERNOR_FIXED;
+    groups[DYNTRACE_PROBE_INDEX(probe_end)] = DYNTRACE_GOVERNOR_FIXED;
+    groups[DYNTRACE_PROBE_INDEX(probe_error)] = DYNTRACE_GOVERNOR_FIXED;
+    groups[DYNTRACE_PROBE_INDEX(probe_jump_ctxt)] = DYNTRACE_GOVERNOR_FIXED;
+    groups[DYNTRACE_PROBE_INDEX(probe_fork_parent)] = DYNTRACE_GOVERNOR_FIXED;
+    groups[DYNTRACE_PROBE_INDEX(probe_fork_child)] = DYNTRACE_GOVERNOR_FIXED;
+    groups[DYNTRACE_PROBE_INDEX(probe_fork_child_exit)] =
+        DYNTRACE_GOVERNOR_FIXED;
+
+    groups[DYNTRACE_PROBE_INDEX(probe_function_entry)] = 1;
+    groups[DYNTRACE_PROBE_INDEX(probe_function_exit)] = 1;
+    groups[DYNTRACE_PROBE_INDEX(probe_builtin_entry)] = 2;
+    groups[DYNTRACE_PROBE_INDEX(probe_builtin_exit)] = 2;
+    groups[DYNTRACE_PROBE_INDEX(probe_specialsxp_entry)] = 3;
+    groups[DYNTRACE_PROBE_INDEX(probe_specialsxp_exit)] = 3;
+    groups[DYNTRACE_PROBE_INDEX(probe_promise_force_entry)] = 4;
+    groups[DYNTRACE_PROBE_INDEX(probe_promise_force_exit)] = 4;
+    groups[DYNTRACE_PROBE_INDEX(probe_eval_entry)] = 5;
+    groups[DYNTRACE_PROBE_INDEX(probe_eval_exit)] = 5;
+    groups[DYNTRACE_PROBE_INDEX(probe_gc_entry)] = 6;
+    groups[DYNTRACE_PROBE_INDEX(probe_gc_exit)] = 6;
+    groups[DYNTRACE_PROBE_INDEX(probe_S3_generic_entry)] = 7;
+    groups[DYNTRACE_PROBE_INDEX(probe_S3_generic_exit)] = 7;
+    groups[DYNTRACE_PROBE_INDEX(probe_S3_dispatch_entry)] = 8;
+    groups[DYNTRACE_PROBE_INDEX(probe_S3_dispatch_exit)] = 8;
+    groups[DYNTRACE_PROBE_INDEX(probe_jit_compile_entry)] = 9;
+    groups[DYNTRACE_PROBE_INDEX(probe_jit_compile_exit)] = 9;
+    groups[DYNTRACE_PROBE_INDEX(probe_context_entry)] = 10;
+    groups[DYNTRACE_PROBE_INDEX(probe_context_exit)] = 10;
+    groups[DYNTRACE_PROBE_INDEX(probe_context_unwind)] = 10;
+
+    roles[DYNTRACE_PROBE_INDEX(probe_function_entry)] = DYNTRACE_GOVERNOR_ENTRY;
+    roles[DYNTRACE_PROBE_INDEX(probe_function_exit)] = DYNTRACE_GOVERNOR_EXIT;
+    roles[DYNTRACE_PROBE_INDEX(probe_builtin_entry)] = DYNTRACE_GOVERNOR_ENTRY;
+    roles[DYNTRACE_PROBE_INDEX(probe_builtin_exit)] = DYNTRACE_GOVERNOR_EXIT;
+    roles[DYNTRACE_PROBE_INDEX(probe_specialsxp_entry)] =
+        DYNTRACE_GOVERNOR_ENTRY;
+    roles[DYNTRACE_PROBE_INDEX(probe_specialsxp_exit)] = DYNTRACE_GOVERNOR_EXIT;
+    roles[DYNTRACE_PROBE_INDEX(probe_promise_force_entry)] =
+        DYNTRACE_GOVERNOR_ENTRY;
+    roles[DYNTRACE_PROBE_INDEX(probe_promise_force_exit)] =
+        DYNTRACE_GOVERNOR_EXIT;
+    roles[DYNTRACE_PROBE_INDEX(probe_eval_entry)] = DYNTRACE_GOVERNOR_ENTRY;
+    roles[DYNTRACE_PROBE_INDEX(probe_eval_exit)] = DYNTRACE_GOVERNOR_EXIT;
+    roles[DYNTRACE_PROBE_INDEX(probe_gc_entry)] = DYNTRACE_GOVERNOR_ENTRY;
+    roles[DYNTRACE_PROBE_INDEX(probe_gc_exit)] = DYNTRACE_GOVERNOR_EXIT;
+    roles[DYNTRACE_PROBE_INDEX(probe_S3_generic_entry)] =
+        DYNTRACE_GOVERNOR_ENTRY;
+    roles[DYNTRACE_PROBE_INDEX(probe_S3_generic_exit)] = DYNTRACE_GOVERNOR_EXIT;
+    roles[DYNTRACE_PROBE_INDEX(probe_S3_dispatch_entry)] =
+        DYNTRACE_GOVERNOR_ENTRY;
+    roles[DYNTRACE_PROBE_INDEX(probe_S3_dispatch_exit)] =
+        DYNTRACE_GOVERNOR_EXIT;
+    roles[DYNTRACE_PROBE_INDEX(probe_jit_compile_entry)] =
+        DYNTRACE_GOVERNOR_ENTRY;
+    roles[DYNTRACE_PROBE_INDEX(probe_jit_compile_exit)] =
+        DYNTRACE_GOVERNOR_EXIT;
+    roles[DYNTRACE_PROBE_INDEX(probe_context_entry)] = DYNTRACE_GOVERNOR_ENTRY;
+    roles[DYNTRACE_PROBE_INDEX(probe_context_exit)] = DYNTRACE_GOVERNOR_EXIT;
+    roles[DYNTRACE_PROBE_INDEX(probe_context_unwind)] =
+        DYNTRACE_GOVERNOR_UNWIND;
+}
+
+static void dyntrace_governor_begin(dyntracing_context_t *dyntracing_context,
+                                    double overhead_budget) {
+    int i;
+    dyntracing_context->overhead_budget = overhead_budget;
+    dyntrace_governor_enabled = overhead_budget > 0;
+    if (!dyntrace_governor_enabled)
+        return;
+
+    dyntrace_governor_init_groups();
+    for (i = 0; i < DYNTRACE_PROBE_COUNT; ++i) {
+        dyntrace_governor.periods[i] = 1;
+        dyntrace_governor.phases[i] = 0;
+    }
+    /* the depths are kept for the next trace */
+    for (i = 0; i < DYNTRACE_GOVERNOR_GROUPS; ++i)
+        dyntrace_governor.frames[i].size = 0;
+    dyntrace_governor.dyntracing_context = dyntracing_context;
+    dyntrace_governor.countdown = DYNTRACE_GOVERNOR_WINDOW;
+    memset(&dyntrace_governor.window_time, 0, sizeof(execution_time_t));
+    memset(&dyntrace_governor.window_count, 0, sizeof(execution_count_t));
+}
+
+/* A nested dyntrace() governs its own probes with its own budget. The
+   governor of the outer trace is put aside until the nested trace ends,
+   without its depths, which the nested trace must not overwrite. */
+static void dyntrace_governor_save(dyntrace_governor_t *saved,
+                                   int *saved_enabled) {
+    int i;
+    *saved = dyntrace_governor;
+    *saved_enabled = dyntrace_governor_enabled;
+    for (i = 0; i < DYNTRACE_GOVERNOR_GROUPS; ++i) {
+        dyntrace_governor.frames[i].depths = NULL;
+        dyntrace_governor.frames[i].size = 0;
+        dyntrace_governor.frames[i].capacity = 0;
+    }
+    dyntrace_governor_enabled = 0;
+}
+
+static void dyntrace_governor_restore(const dyntrace_governor_t *saved,
+                                      int saved_enabled) {
+    int i;
+    for (i = 0; i < DYNTRACE_GOVERNOR_GROUPS; ++i)
+        free(dyntrace_governor.frames[i].depths);
+    dyntrace_governor = *saved;
+    dyntrace_governor_enabled = saved_enabled;
+}
+
+static void dyntrace_governor_record(int probe, unsigned int period,
+                                     double overhead, clock_t program_time) {
+    dyntracing_context_t *dyntracing_context =
+        dyntrace_governor.dyntracing_context;
+    int count = dyntracing_context->governor_decision_count;
+    dyntrace_governor_decision_t *decisions =
+        realloc(dyntracing_context->governor_decisions,
+                (count + 1) * sizeof(dyntrace_governor_decision_t));
+    if (decisions == NULL)
+        return;
+    decisions[count].probe = probe;
+    decisions[count].period = period;
+    decisions[count].overhead = overhead;
+    decisions[count].program_time = program_time;
+    dyntracing_context->governor_decisions = decisions;
+    dyntracing_context->governor_decision_count = count + 1;
+}
+
+static void dyntrace_governor_check() {
+    dyntracing_context_t *dyntracing_context =
+        dyntrace_governor.dyntracing_context;
+    clock_t *times = (clock_t *)&dyntracing_context->execution_time;
+    uint64_t *counts = (uint64_t *)&dyntracing_context->execution_count;
+    clock_t *window_times = (clock_t *)&dyntrace_governor.window_time;
+    uint64_t *window_counts = (uint64_t *)&dyntrace_governor.window_count;
+    double costs[DYNTRACE_PROBE_COUNT];
+    double probe_time = 0, program_time, fired = 0, overhead, cost = 0;
+    double total_fired = 0;
+    clock_t elapsed;
+    int i, costliest = -1;
+
+    /* the calibrated machinery cost is probe time */
+    for (i = 0; i < DYNTRACE_PROBE_COUNT; ++i) {
+        uint64_t window_fired = counts[i] - window_counts[i];
+        costs[i] = (times[i] - window_times[i]) +
+                   window_fired * dyntracing_context->probe_expression_overhead;
+        probe_time += costs[i];
+        fired += window_fired;
+        total_fired += counts[i];
+    }
+    program_time = (dyntracing_context->execution_time.expression -
+                    dyntrace_governor.window_time.expression) -
+                   fired * dyntracing_context->probe_expression_overhead;
+    if (program_time < 1)
+        program_time = 1;
+    overhead = probe_time / program_time;
+    elapsed = dyntracing_context->execution_time.expression -
+              (clock_t)(total_fired *
+                        dyntracing_context->probe_expression_overhead);
+
+    dyntrace_governor.window_time = dyntracing_context->execution_time;
+    dyntrace_governor.window_count = dyntracing_context->execution_count;
+    if (overhead <= dyntracing_context->overhead_budget)
+        return;
+
+    /* groups cost the sum of their probes */
+    for (i = 0; i < DYNTRACE_PROBE_COUNT; ++i) {
+        int group = dyntrace_governor.groups[i], j;
+        double group_cost = costs[i];
+        if (group == DYNTRACE_GOVERNOR_FIXED ||
+            dyntrace_governor.periods[i] == 0)
+            continue;
+        if (group != DYNTRACE_GOVERNOR_EVENT)
+            for (j = 0; j < DYNTRACE_PROBE_COUNT; ++j)
+                if (j != i && dyntrace_governor.groups[j] == group)
+                    group_cost += costs[j];
+        if (group_cost > cost) {
+            cost = group_cost;
+            costliest = i;
+        }
+    }
+    if (costliest == -1)
+        return;
+
+    if (dyntrace_governor.groups[costliest] == DYNTRACE_GOVERNOR_EVENT) {
+        unsigned int period =
+            dyntrace_governor.periods[costliest] * DYNTRACE_GOVERNOR_SAMPLING;
+        dyntrace_governor.periods[costliest] =
+            period > DYNTRACE_GOVERNOR_MAX_PERIOD ? 0 : period;
+        dyntrace_governor_record(costliest,
+                                 dyntrace_governor.periods[costliest],
+                                 overhead, elapsed);
+    } else {
+        for (i = 0; i < DYNTRACE_PROBE_COUNT; ++i)
+            if (dyntrace_governor.groups[i] ==
+                dyntrace_governor.groups[costliest]) {
+                dyntrace_governor.periods[i] = 0;
+                dyntrace_governor_record(i, 0, overhead, elapsed);
+            }
+    }
+}
+
+/* Tracks the entries and exits of the group of probe, see above. Returns 1
+   to admit the probe whatever its period, 0 to leave the decision to the
+   period. */
+static int dyntrace_governor_track(int probe, unsigned int period) {
+    int group = dyntrace_governor.groups[probe];
+    dyntrace_governor_frames_t *frames = &dyntrace_governor.frames[group];
+    int depth = group == dyntrace_governor.groups[DYNTRACE_PROBE_INDEX(
+                             probe_context_entry)]
+                    ? R_GlobalContext->depth
+                    : R_EvalDepth;
+
+    switch (dyntrace_governor.roles[probe]) {
+    case DYNTRACE_GOVERNOR_ENTRY:
+        while (frames->size > 0 && frames->depths[frames->size - 1] >= depth)
+            frames->size--;
+        if (period != 1)
+            return 0;
+        if (frames->size == frames->capacity) {
+            int capacity = frames->capacity ? 2 * frames->capacity : 64;
+            int *depths = realloc(frames->depths, capacity * sizeof(int));
+            /* without room, the exit of this entry may be dropped once the
+               group is disabled */
+            if (depths == NULL)
+                return 0;
+            frames->depths = depths;
+            frames->capacity = capacity;
+        }
+        frames->depths[frames->size++] = depth;
+        return 0;
+    case DYNTRACE_GOVERNOR_EXIT:
+        while (frames->size > 0 && frames->depths[frames->size - 1] > depth)
+            frames->size--;
+        if (frames->size > 0 && frames->depths[frames->size - 1] == depth) {
+            frames->size--;
+            return 1;
+        }
+        return 0;
+    case DYNTRACE_GOVERNOR_UNWIND:
+        /* the unwind may skip the exits of open entries */
+        return frames->size > 0;
+    }
+    return 0;
+}
+
+int dyntrace_governor_admit(int probe) {
+    unsigned int period = dyntrace_governor.periods[probe];
+
+    if (--dyntrace_governor.countdown == 0) {
+        dyntrace_governor.countdown = DYNTRACE_GOVERNOR_WINDOW;
+        dyntrace_governor_check();
+        period = dyntrace_governor.periods[probe];
+    }
+
+    if (dyntrace_governor.roles[probe] != 0 &&
+        dyntrace_governor_track(probe, period))
+        return 1;
+
+    if (period == 1 ||
+        (period != 0 && ++dyntrace_governor.phases[probe] >= period)) {
+        dyntrace_governor.phases[probe] = 0;
+        return 1;
+    }
+    ((uint64_t *)&dyntrace_governor.dyntracing_context->skipped_count)[probe]++;
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// replay record
+//-----------------------------------------------------------------------------
+
+/* The inputs that make two traces of the same code differ: the RNG state the
+   trace starts from, the values returned by Sys.time() and the allocations
+   at which the collector runs. Allocations are counted at every FORCE_GC
+   check of memory.c, collections requested by gc() are not part of the
+   record since the traced code requests them again. Both modes capture the
+   inputs the trace sees; replay also feeds those of the replayed record:
+   recorded times are returned in order, and a collection is forced at each
+   recorded allocation. Collections that the heap needs at other points still
+   happen and are counted as unmatched. */
+int dyntrace_replay_mode = DYNTRACE_REPLAY_OFF;
+
+static struct {
+    /* dyntrace_replay_mode of the trace, set once the dyntracer is active */
+    int mode;
+    uint64_t allocations;
+    double *times;
+    size_t time_count, time_capacity;
+    double *collections;
+    size_t collection_count, collection_capacity;
+    /* REAL vectors of the replayed record, protected by do_dyntrace */
+    const double *replay_times;
+    size_t replay_time_count, time_cursor;
+    const double *replay_collections;
+    size_t replay_collection_count, collection_cursor;
+    uint64_t unmatched_collections;
+    SEXP seed;
+} dyntrace_replay;
+
+/* last record, see do_dyntracerecord */
+static SEXP dyntrace_record = NULL;
+
+/* malloc, the values are appended during collections */
+static void dyntrace_replay_append(double **values, size_t *count,
+                                   size_t *capacity, double value) {
+    if (*count == *capacity) {
+        size_t new_capacity = *capacity == 0 ? 256 : 2 * *capacity;
+        double *new_values = realloc(*values, new_capacity * sizeof(double));
+        if (new_values == NULL)
+            return;
+        *values = new_values;
+        *capacity = new_capacity;
+    }
+    (*values)[(*count)++] = value;
+}
+
+int dyntrace_replay_allocate() {
+    dyntrace_replay.allocations++;
+    return dyntrace_replay_mode == DYNTRACE_REPLAY_REPLAY &&
+           dyntrace_replay.collection_cursor <
+               dyntrace_replay.replay_collection_count &&
+           dyntrace_replay.replay_collections
+                   [dyntrace_replay.collection_cursor] <=
+               dyntrace_replay.allocations;
+}
+
+/* Forced collections deferred because the collector was disabled happen at
+   a later allocation and still match. */
+void dyntrace_replay_collect() {
+    double allocations = (double) dyntrace_replay.allocations;
+    dyntrace_replay_append(&dyntrace_replay.collections,
+                           &dyntrace_replay.collection_count,
+                           &dyntrace_replay.collection_capacity, allocations);
+    if (dyntrace_replay_mode != DYNTRACE_REPLAY_REPLAY)
+        return;
+    if (dyntrace_replay.collection_cursor <
+            dyntrace_replay.replay_collection_count &&
+        dyntrace_replay.replay_collections
+                [dyntrace_replay.collection_cursor] <= allocations)
+        dyntrace_replay.collection_cursor++;
+    else
+        dyntrace_replay.unmatched_collections++;
+}
+
+/* The current time once the recorded times are exhausted. */
+double dyntrace_replay_time(double time) {
+    if (dyntrace_replay_mode == DYNTRACE_REPLAY_REPLAY &&
+        dyntrace_replay.time_cursor < dyntrace_replay.replay_time_count)
+        time = dyntrace_replay.replay_times[dyntrace_replay.time_cursor++];
+    dyntrace_replay_append(&dyntrace_replay.times, &dyntrace_replay.time_count,
+                           &dyntrace_replay.time_capacity, time);
+    return time;
+}
+
+static SEXP dyntrace_replay_element(SEXP replay, const char *name,
+                                    SEXPTYPE type) {
+    SEXP element = get_named_list_element(replay, name);
+    if (TYPEOF(element) != type)
+        error(_("invalid '%s' argument, '%s' is missing"), "replay", name);
+    return element;
+}
+
+/* Before the dyntracer is active: the RNG and the collection below must not
+   be traced. */
+static void dyntrace_replay_begin(int record, SEXP replay) {
+    SEXP seed, times, collections;
+
+    memset(&dyntrace_replay, 0, sizeof(dyntrace_replay));
+    if (replay != R_NilValue) {
+        seed = dyntrace_replay_element(replay, "seed", INTSXP);
+        times = dyntrace_replay_element(replay, "times", REALSXP);
+        collections = dyntrace_replay_element(replay, "collections", REALSXP);
+        defineVar(R_SeedsSymbol, duplicate(seed), R_GlobalEnv);
+        dyntrace_replay.replay_times = REAL(times);
+        dyntrace_replay.replay_time_count = XLENGTH(times);
+        dyntrace_replay.replay_collections = REAL(collections);
+        dyntrace_replay.replay_collection_count = XLENGTH(collections);
+    } else if (!record) {
+        return;
+    }
+
+    /* seeds .Random.seed from the clock if the session has not used the RNG
+       yet, so that the record has a seed */
+    GetRNGstate();
+    PutRNGstate();
+    seed = findVarInFrame(R_GlobalEnv, R_SeedsSymbol);
+    if (TYPEOF(seed) == PROMSXP)
+        seed = eval(seed, R_GlobalEnv);
+    R_PreserveObject(dyntrace_replay.seed = duplicate(seed));
+
+    /* start both traces from a collected heap */
+    R_gc();
+    dyntrace_replay.mode = replay != R_NilValue ? DYNTRACE_REPLAY_REPLAY
+                                                : DYNTRACE_REPLAY_RECORD;
+}
+
+static SEXP dyntrace_replay_values(const double *values, size_t count) {
+    SEXP vector = allocVector(REALSXP, count);
+    if (count > 0)
+        memcpy(REAL(vector), values, count * sizeof(double));
+    return vector;
+}
+
+/* Last in do_dyntrace, saves the inputs of the trace as the last record and
+   warns when a replay diverged from the replayed record. */
+static void dyntrace_replay_end() {
+    static const char * names[] = {
+        "seed", "times", "collections", "allocations"
+    };
+    int mode = dyntrace_replay.mode;
+    SEXP record;
+
+    if (mode == DYNTRACE_REPLAY_OFF)
+        return;
+
+    PROTECT(record = mk_named_list(4, names));
+    SET_VECTOR_ELT(record, 0, dyntrace_replay.seed);
+    SET_VECTOR_ELT(record, 1,
+                   dyntrace_replay_values(dyntrace_replay.times,
+                                          dyntrace_replay.time_count));
+    SET_VECTOR_ELT(record, 2,
+                   dyntrace_replay_values(dyntrace_replay.collections,
+                                          dyntrace_replay.collection_count));
+    SET_VECTOR_ELT(record, 3,
+                   ScalarReal((double) dyntrace_replay.allocations));
+    classgets(record, mkString("dyntrace_record"));
+    R_ReleaseObject(dyntrace_replay.seed);
+    free(dyntrace_replay.times);
+    free(dyntrace_replay.collections);
+
+    if (dyntrace_record != NULL)
+        R_ReleaseObject(dyntrace_record);
+    R_PreserveObject(dyntrace_record = record);
+    UNPROTECT(1);
+
+    if (mode == DYNTRACE_REPLAY_REPLAY &&
+        (dyntrace_replay.unmatched_collections > 0 ||
+         dyntrace_replay.collection_cursor <
+             dyntrace_replay.replay_collection_count ||
+         dyntrace_replay.time_cursor != dyntrace_replay.replay_time_count ||
+         dyntrace_replay.time_count != dyntrace_replay.time_cursor))
+        warning(_("the trace diverged from the replayed record: %.0f "
+                  "collections and %.0f times were not in the record, %.0f "
+                  "recorded collections and %.0f recorded times were not "
+                  "replayed"),
+                (double) dyntrace_replay.unmatched_collections,
+                (double) (dyntrace_replay.time_count -
+                          dyntrace_replay.time_cursor),
+                (double) (dyntrace_replay.replay_collection_count -
+                          dyntrace_replay.collection_cursor),
+                (double) (dyntrace_replay.replay_time_count -
+                          dyntrace_replay.time_cursor));
+}
+
+/* .Internal(dyntracerecord()): NULL before the first dyntrace() call that
+   records or replays */
+SEXP attribute_hidden do_dyntracerecord(SEXP call, SEXP op, SEXP args,
+                                        SEXP rho) {
+    checkArity(op, args);
+    return dyntrace_record == NULL ? R_NilValue : dyntrace_record;
+}
+
 SEXP do_dyntrace(SEXP call, SEXP op, SEXP args, SEXP rho) {
-    int eval_error = FALSE;
-    SEXP expression, environment, result;
+    int eval_error = FALSE, record, dyntrace_previous_governor_enabled = 0;
+    dyntrace_governor_t dyntrace_previous_governor;
+#ifdef ENABLE_DYNTRACE_OPCODES
+    struct dyntrace_opcodes_t *dyntrace_previous_opcodes;
+#endif
+    double overhead_budget;
+    SEXP expression, environment, replay, result;
     dyntracer_t * dyntracer = NULL;
+    dyntrace_context_t * dyntrace_context;
     dyntracer_t * dyntrace_previous_dyntracer = dyntrace_active_dyntracer;
+    dyntrace_context_t * dyntrace_previous_dyntrace_context =
+        dyntrace_active_dyntrace_context;
+    /* a nested trace leaves the record of the outer trace alone: the outer
+       trace keeps recording or replaying through it */
+    int nested = dyntrace_previous_dyntracer != NULL;
 
     /* extract objects from argument list */
     dyntracer = dyntracer_from_sexp(eval(CAR(args), rho));
     PROTECT(expression = findVar(CADR(args), rho));
     PROTECT(environment = eval(CADDR(args), rho));
+    overhead_budget = asReal(eval(CADDDR(args), rho));
+    if (ISNAN(overhead_budget) || overhead_budget < 0)
+        error(_("invalid '%s' argument"), "overhead_budget");
+    record = asLogical(eval(CAD4R(args), rho));
+    if (record == NA_LOGICAL)
+        error(_("invalid '%s' argument"), "record");
+    PROTECT(replay = eval(CAD4R(CDR(args)), rho));
+    if (replay != R_NilValue && TYPEOF(replay) != VECSXP)
+        error(_("invalid '%s' argument"), "replay");
 
     if(dyntracer == NULL)
       error("dyntracer is NULL");
-    /* create dyntrace context */
-    dyntrace_active_dyntrace_context = create_dyntrace_context(dyntracer);    
+    if (nested && (record || replay != R_NilValue))
+        error(_("'record' and 'replay' cannot be used in a nested dyntrace()"));
+    if (!nested)
+        dyntrace_replay_begin(record, replay);
+    else
+        dyntrace_governor_save(&dyntrace_previous_governor,
+                               &dyntrace_previous_governor_enabled);
+    /* create dyntrace context, the probes of an outer trace keep theirs
+       until the dyntracer is activated */
+    dyntrace_context = create_dyntrace_context(dyntracer);
+
+    dyntrace_install_symbols();
+    dyntrace_calibrate(dyntracer, dyntrace_context);
+    dyntrace_governor_begin(dyntrace_context -> dyntracing_context,
+                            overhead_budget);
+#ifdef ENABLE_DYNTRACE_OPCODES
+    /* allocates, so it runs before the dyntracer is activated */
+    dyntrace_previous_opcodes = dyntrace_opcodes_begin();
+#endif
 
     /* begin dyntracing */
     dyntrace_active_dyntracer = dyntracer;
+    dyntrace_active_dyntrace_context = dyntrace_context;
+    dyntrace_replay_mode = dyntrace_replay.mode;
     dyntrace_stopwatch = clock();
     dyntrace_active_dyntrace_context -> dyntracing_context -> begin_datetime = get_current_datetime();
 
@@ -129,18 +978,146 @@ SEXP do_dyntrace(SEXP call, SEXP op, SEXP args, SEXP rho) {
     }
 
     /* end dyntracing */
+#ifdef ENABLE_DYNTRACE_OPCODES
+    dyntrace_opcodes_end(dyntrace_previous_opcodes);
+#endif
     dyntrace_active_dyntrace_context -> dyntracing_context -> end_datetime = get_current_datetime();
+    dyntrace_subtract_probe_overhead(dyntrace_active_dyntrace_context -> dyntracing_context);
     DYNTRACE_PROBE_END();
+    dyntrace_governor_enabled = 0;
+    if (!nested)
+        dyntrace_replay_mode = DYNTRACE_REPLAY_OFF;
+    else
+        dyntrace_governor_restore(&dyntrace_previous_governor,
+                                  dyntrace_previous_governor_enabled);
     dyntrace_active_dyntracer = dyntrace_previous_dyntracer;
+    dyntrace_save_statistics(dyntrace_active_dyntrace_context -> dyntracing_context);
 
     /* destroy dyntrace context */
     destroy_dyntrace_context(dyntrace_active_dyntrace_context);
-    dyntrace_active_dyntrace_context = NULL;
+    dyntrace_active_dyntrace_context = dyntrace_previous_dyntrace_context;
+    if (!nested)
+        dyntrace_replay_end();
 
-    UNPROTECT(3);
+    UNPROTECT(4);
     return result;
 }
 
+//-----------------------------------------------------------------------------
+// plugin loading
+//-----------------------------------------------------------------------------
+
+/* Plugins are never unloaded: the dyntracers they create point to their
+   code, and loading them again for the next dyntrace() call would repeat
+   the load and relocation work. */
+typedef struct dyntrace_plugin_t {
+    char *path;
+    void *handle;
+    SEXP (*create_dyntracer)(SEXP options);
+    SEXP (*destroy_dyntracer)(SEXP dyntracer_sexp);
+    struct dyntrace_plugin_t *next;
+} dyntrace_plugin_t;
+
+static dyntrace_plugin_t *dyntrace_plugins = NULL;
+
+static dyntrace_plugin_t *dyntrace_load_plugin(const char *filename) {
+    char path[PATH_MAX];
+    dyntrace_plugin_t *plugin;
+    const dyntrace_plugin_abi_t *abi;
+    void *handle;
+
+    if (realpath(R_ExpandFileName(filename), path) == NULL)
+        error(_("cannot find dyntracer plugin '%s'"), filename);
+
+    for (plugin = dyntrace_plugins; plugin != NULL; plugin = plugin->next)
+        if (strcmp(plugin->path, path) == 0)
+            return plugin;
+
+    handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (handle == NULL)
+        error(_("cannot load dyntracer plugin '%s': %s"), path, dlerror());
+
+    /* checked before anything else is looked up, a plugin built against
+       another dyntracer_t would fill the wrong probes */
+    abi = (const dyntrace_plugin_abi_t *)dlsym(handle, "dyntrace_plugin_abi");
+    if (abi == NULL) {
+        dlclose(handle);
+        error(_("'%s' is not a dyntracer plugin, it does not export "
+                "dyntrace_plugin_abi"), path);
+    }
+    if (abi->abi_version != DYNTRACE_ABI_VERSION ||
+        abi->dyntracer_size != sizeof(dyntracer_t) ||
+        abi->probe_count != DYNTRACE_PROBE_COUNT) {
+        int abi_version = abi->abi_version, probe_count = abi->probe_count;
+        size_t dyntracer_size = abi->dyntracer_size;
+        dlclose(handle);
+        error(_("dyntracer plugin '%s' was built for ABI %d with %d probes "
+                "(%lu bytes), this R has ABI %d with %d probes (%lu bytes)"),
+              path, abi_version, probe_count, (unsigned long)dyntracer_size,
+              DYNTRACE_ABI_VERSION, DYNTRACE_PROBE_COUNT,
+              (unsigned long)sizeof(dyntracer_t));
+    }
+
+    plugin = (dyntrace_plugin_t *)malloc(sizeof(dyntrace_plugin_t));
+    if (plugin == NULL || (plugin->path = strdup(path)) == NULL) {
+        dlclose(handle);
+        error(_("cannot allocate dyntracer plugin '%s'"), path);
+    }
+    plugin->handle = handle;
+    *(void **)&plugin->create_dyntracer = dlsym(handle, "create_dyntracer");
+    *(void **)&plugin->destroy_dyntracer = dlsym(handle, "destroy_dyntracer");
+    if (plugin->create_dyntracer == NULL || plugin->destroy_dyntracer == NULL) {
+        free(plugin->path);
+        free(plugin);
+        dlclose(handle);
+        error(_("dyntracer plugin '%s' does not export create_dyntracer and "
+                "destroy_dyntracer"), path);
+    }
+    plugin->next = dyntrace_plugins;
+    dyntrace_plugins = plugin;
+    return plugin;
+}
+
+/* .Internal(dyntraceload(path, options)): loads the plugin at path unless it
+   is already loaded and creates a dyntracer with options. The plugin is
+   kept in the protected field of the dyntracer for dyntracedestroy. */
+SEXP attribute_hidden do_dyntraceload(SEXP call, SEXP op, SEXP args,
+                                      SEXP rho) {
+    dyntrace_plugin_t *plugin;
+    SEXP path = CAR(args), options = CADR(args), dyntracer_sexp;
+
+    checkArity(op, args);
+    if (!isString(path) || LENGTH(path) != 1 ||
+        STRING_ELT(path, 0) == NA_STRING)
+        error(_("invalid '%s' argument"), "path");
+    if (TYPEOF(options) != VECSXP)
+        error(_("invalid '%s' argument"), "options");
+
+    plugin = dyntrace_load_plugin(translateChar(STRING_ELT(path, 0)));
+    PROTECT(dyntracer_sexp = plugin->create_dyntracer(options));
+    if (TYPEOF(dyntracer_sexp) != EXTPTRSXP)
+        error(_("create_dyntracer of '%s' did not return a dyntracer"),
+              plugin->path);
+    R_SetExternalPtrProtected(dyntracer_sexp,
+                              R_MakeExternalPtr(plugin, R_NilValue,
+                                                R_NilValue));
+    UNPROTECT(1);
+    return dyntracer_sexp;
+}
+
+/* .Internal(dyntracedestroy(dyntracer)) for dyntracers of dyntraceload */
+SEXP attribute_hidden do_dyntracedestroy(SEXP call, SEXP op, SEXP args,
+                                         SEXP rho) {
+    SEXP dyntracer_sexp = CAR(args), plugin;
+
+    checkArity(op, args);
+    if (TYPEOF(dyntracer_sexp) != EXTPTRSXP ||
+        TYPEOF(plugin = R_ExternalPtrProtected(dyntracer_sexp)) != EXTPTRSXP)
+        error(_("dyntracer was not created by dyntraceLoad"));
+    return ((dyntrace_plugin_t *)R_ExternalPtrAddr(plugin))
+        ->destroy_dyntracer(dyntracer_sexp);
+}
+
 //-----------------------------------------------------------------------------
 // helpers
 //-----------------------------------------------------------------------------
@@ -165,6 +1142,80 @@ clock_t dyntrace_reset_stopwatch() {
     return difference;
 }
 
+/* A forked child starts with empty statistics, the parent keeps those of
+   the trace before the fork. */
+void dyntrace_fork_child_begin() {
+    dyntracing_context_t *dyntracing_context;
+    if (dyntrace_active_dyntracer == NULL)
+        return;
+    dyntracing_context = dyntrace_active_dyntrace_context->dyntracing_context;
+    memset(&dyntracing_context->execution_time, 0, sizeof(execution_time_t));
+    memset(&dyntracing_context->execution_count, 0, sizeof(execution_count_t));
+    memset(&dyntracing_context->skipped_count, 0, sizeof(execution_count_t));
+    memset(&dyntrace_governor.window_time, 0, sizeof(execution_time_t));
+    memset(&dyntrace_governor.window_count, 0, sizeof(execution_count_t));
+    dyntrace_stopwatch = clock();
+}
+
+void dyntrace_fork_child_end() {
+    if (dyntrace_active_dyntracer == NULL)
+        return;
+    dyntrace_subtract_probe_overhead(
+        dyntrace_active_dyntrace_context->dyntracing_context);
+}
+
+/* monotonic time in nanoseconds, for probes that report durations */
+uint64_t dyntrace_timestamp() {
+#if defined(HAVE_CLOCK_GETTIME)
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+#elif defined(__MACH__)
+    clock_serv_t clock;
+    mach_timespec_t time;
+    host_get_clock_service(mach_host_self(), SYSTEM_CLOCK, &clock);
+    clock_get_time(clock, &time);
+    mach_port_deallocate(mach_task_self(), clock);
+    return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+#else
+    return (uint64_t)clock() * (1000000000 / CLOCKS_PER_SEC);
+#endif
+}
+
+/* The JIT compiler is R code, the probes it fires would add its time to
+   execution_time.expression. dyntrace_jit_compile_end moves the expression
+   time elapsed since dyntrace_jit_compile_begin to jit_compile. */
+clock_t dyntrace_jit_compile_begin() {
+    execution_time_t *execution_time;
+    if (dyntrace_active_dyntracer == NULL)
+        return 0;
+    execution_time = &dyntrace_active_dyntrace_context->dyntracing_context
+                          ->execution_time;
+    execution_time->expression += dyntrace_reset_stopwatch();
+    return execution_time->expression;
+}
+
+void dyntrace_jit_compile_end(clock_t expression_time) {
+    execution_time_t *execution_time;
+    if (dyntrace_active_dyntracer == NULL)
+        return;
+    execution_time = &dyntrace_active_dyntrace_context->dyntracing_context
+                          ->execution_time;
+    execution_time->expression += dyntrace_reset_stopwatch();
+    execution_time->jit_compile += execution_time->expression - expression_time;
+    execution_time->expression = expression_time;
+}
+
+/* number of nodes of an AST, does not allocate */
+int dyntrace_expression_size(SEXP expression) {
+    int size = 1;
+    while (TYPEOF(expression) == LANGSXP || TYPEOF(expression) == LISTSXP) {
+        size += dyntrace_expression_size(CAR(expression));
+        expression = CDR(expression);
+    }
+    return size;
+}
+
 SEXP get_named_list_element(const SEXP list, const char *name) {
     if (TYPEOF(list) != VECSXP) {
         error("Not a list");
@@ -206,3 +1257,197 @@ inline const char *get_string(SEXP sexp) {
 int newhashpjw(const char *s) {
     return R_Newhashpjw(s);
 }
+
+//-----------------------------------------------------------------------------
+// tracer arena
+//-----------------------------------------------------------------------------
+
+/* Blocks are chained from the most recent one. Requests larger than the
+   block size get a block of their own. The arena runs inside probes, where
+   neither an R error nor exiting the session is acceptable, so it reports a
+   failed malloc with NULL and leaves the recovery to the tracer. */
+struct dyntrace_arena_block_t {
+    struct dyntrace_arena_block_t *next;
+    size_t size;
+    size_t used;
+    /* aligned for any type, like malloc */
+    max_align_t data[];
+};
+
+#define DYNTRACE_ARENA_ALIGNMENT sizeof(max_align_t)
+
+static dyntrace_arena_block_t *dyntrace_arena_new_block(size_t size) {
+    dyntrace_arena_block_t *block = (dyntrace_arena_block_t *)malloc(
+        sizeof(dyntrace_arena_block_t) + size);
+    if (block == NULL)
+        return NULL;
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+dyntrace_arena_t *dyntrace_arena_create(size_t block_size) {
+    dyntrace_arena_t *arena = (dyntrace_arena_t *)malloc(sizeof(*arena));
+    if (arena == NULL)
+        return NULL;
+    arena->block_size = block_size;
+    arena->blocks = dyntrace_arena_new_block(block_size);
+    if (arena->blocks == NULL) {
+        free(arena);
+        return NULL;
+    }
+    arena->allocated = block_size;
+    return arena;
+}
+
+void *dyntrace_arena_alloc(dyntrace_arena_t *arena, size_t size) {
+    dyntrace_arena_block_t *block = arena->blocks;
+    void *result;
+
+    size = (size + DYNTRACE_ARENA_ALIGNMENT - 1) &
+           ~(DYNTRACE_ARENA_ALIGNMENT - 1);
+    if (block->size - block->used < size) {
+        size_t block_size = size > arena->block_size ? size : arena->block_size;
+        block = dyntrace_arena_new_block(block_size);
+        if (block == NULL)
+            return NULL;
+        block->next = arena->blocks;
+        arena->blocks = block;
+        arena->allocated += block_size;
+    }
+    result = (char *)block->data + block->used;
+    block->used += size;
+    return result;
+}
+
+char *dyntrace_arena_strdup(dyntrace_arena_t *arena, const char *string) {
+    size_t length = strlen(string) + 1;
+    char *copy = (char *)dyntrace_arena_alloc(arena, length);
+    return copy == NULL ? NULL : (char *)memcpy(copy, string, length);
+}
+
+/* frees every block but the most recent one, which is emptied */
+void dyntrace_arena_reset(dyntrace_arena_t *arena) {
+    dyntrace_arena_block_t *block = arena->blocks->next;
+    while (block != NULL) {
+        dyntrace_arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->blocks->next = NULL;
+    arena->blocks->used = 0;
+    arena->allocated = arena->blocks->size;
+}
+
+void dyntrace_arena_destroy(dyntrace_arena_t *arena) {
+    dyntrace_arena_reset(arena);
+    free(arena->blocks);
+    free(arena);
+}
+
+//-----------------------------------------------------------------------------
+// inspection helpers, they neither allocate on the R heap nor fire probes
+//-----------------------------------------------------------------------------
+
+/* installed by do_dyntrace, looking them up from a probe could allocate */
+static SEXP dyntrace_filename_symbol = NULL;
+static SEXP dyntrace_spec_symbol = NULL;
+
+void dyntrace_install_symbols() {
+    if (dyntrace_filename_symbol == NULL) {
+        dyntrace_filename_symbol = install("filename");
+        dyntrace_spec_symbol = install("spec");
+    }
+}
+
+const char *dyntrace_get_call_name(SEXP call) {
+    SEXP function;
+    if (TYPEOF(call) != LANGSXP)
+        return NULL;
+    function = CAR(call);
+    if (TYPEOF(function) == SYMSXP)
+        return CHAR(PRINTNAME(function));
+    /* pkg::f and pkg:::f */
+    if (TYPEOF(function) == LANGSXP &&
+        (CAR(function) == R_DoubleColonSymbol ||
+         CAR(function) == R_TripleColonSymbol) &&
+        TYPEOF(CADDR(function)) == SYMSXP)
+        return CHAR(PRINTNAME(CADDR(function)));
+    return NULL;
+}
+
+const char *dyntrace_get_namespace_name(SEXP rho) {
+    for (; TYPEOF(rho) == ENVSXP && rho != R_GlobalEnv && rho != R_EmptyEnv;
+         rho = ENCLOS(rho)) {
+        SEXP info, spec;
+        if (rho == R_BaseEnv || rho == R_BaseNamespace)
+            return "base";
+        info = findVarInFrame3(rho, R_NamespaceEnvSymbol, TRUE);
+        if (TYPEOF(info) != ENVSXP)
+            continue;
+        spec = findVarInFrame3(info, dyntrace_spec_symbol, TRUE);
+        if (TYPEOF(spec) == STRSXP && LENGTH(spec) > 0)
+            return CHAR(STRING_ELT(spec, 0));
+    }
+    return NULL;
+}
+
+/* not getAttrib, it allocates for some attributes */
+SEXP dyntrace_get_attribute(SEXP x, SEXP name) {
+    SEXP attribute;
+    if (TYPEOF(x) == CHARSXP)
+        return R_NilValue;
+    for (attribute = ATTRIB(x); attribute != R_NilValue;
+         attribute = CDR(attribute)) {
+        if (TAG(attribute) == name)
+            return CAR(attribute);
+    }
+    return R_NilValue;
+}
+
+int dyntrace_get_srcref(SEXP srcref, dyntrace_srcref_t *location) {
+    SEXP srcfile, filename;
+    location->filename = NULL;
+    location->line = 0;
+    location->column = 0;
+    if (TYPEOF(srcref) != INTSXP || XLENGTH(srcref) < 6)
+        return 0;
+    location->line = INTEGER(srcref)[0];
+    location->column = INTEGER(srcref)[4];
+    srcfile = dyntrace_get_attribute(srcref, R_SrcfileSymbol);
+    if (TYPEOF(srcfile) == ENVSXP) {
+        filename = findVarInFrame3(srcfile, dyntrace_filename_symbol, TRUE);
+        if (TYPEOF(filename) == STRSXP && XLENGTH(filename) > 0)
+            location->filename = CHAR(STRING_ELT(filename, 0));
+    }
+    return 1;
+}
+
+/* type[length] followed by <class> for objects with a class attribute,
+   e.g. double[10] or list[3]<data.frame> */
+const char *dyntrace_get_type_signature(SEXP value, dyntrace_arena_t *arena) {
+    const char *klass = NULL;
+    char buffer[256];
+    SEXP attribute;
+
+    if (OBJECT(value)) {
+        for (attribute = ATTRIB(value); attribute != R_NilValue;
+             attribute = CDR(attribute))
+            if (TAG(attribute) == R_ClassSymbol) {
+                if (TYPEOF(CAR(attribute)) == STRSXP &&
+                    XLENGTH(CAR(attribute)) > 0)
+                    klass = CHAR(STRING_ELT(CAR(attribute), 0));
+                break;
+            }
+    }
+
+    if (isVector(value) || isList(value))
+        snprintf(buffer, sizeof(buffer), klass ? "%s[%lu]<%s>" : "%s[%lu]",
+                 type2char(TYPEOF(value)), (unsigned long)xlength(value),
+                 klass);
+    else
+        snprintf(buffer, sizeof(buffer), klass ? "%s<%s>" : "%s",
+                 type2char(TYPEOF(value)), klass);
+    return dyntrace_arena_strdup(arena, buffer);
+}
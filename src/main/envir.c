@@ -1177,21 +1177,25 @@ slowpath:
 
 #ifdef USE_GLOBAL_CACHE
 /* findGlobalVar searches for a symbol value starting at R_GlobalEnv,
-   so the cache can be used. */
-static SEXP findGlobalVar(SEXP symbol)
+   so the cache can be used. depth is the number of local frames
+   already searched, it is only reported to dyntrace. */
+static SEXP findGlobalVar(SEXP symbol, int depth)
 {
     SEXP vl, rho;
     Rboolean canCache = TRUE;
     vl = R_GetGlobalCache(symbol);
     if (vl != R_UnboundValue) {
-      DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, vl, R_GlobalEnv);
+      DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, vl, R_GlobalEnv, depth,
+                                            DYNTRACE_GLOBAL_CACHE_HIT);
 	return vl;
   }
-    for (rho = R_GlobalEnv; rho != R_EmptyEnv; rho = ENCLOS(rho)) {
+    for (rho = R_GlobalEnv; rho != R_EmptyEnv; rho = ENCLOS(rho), depth++) {
 	if (rho != R_BaseEnv) { /* we won't have R_BaseNamespace */
 	    vl = findVarLocInFrame(rho, symbol, &canCache);
 	    if (vl != R_NilValue) {
-        DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, BINDING_VALUE(vl), rho);
+        DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, BINDING_VALUE(vl), rho,
+                                              depth,
+                                              DYNTRACE_GLOBAL_CACHE_MISS);
 		if(canCache)
 		    R_AddGlobalCache(symbol, vl);
 		return BINDING_VALUE(vl);
@@ -1200,7 +1204,8 @@ static SEXP findGlobalVar(SEXP symbol)
 	    vl = SYMBOL_BINDING_VALUE(symbol);
 	    if (vl != R_UnboundValue)
 		R_AddGlobalCache(symbol, symbol);
-      DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, vl, rho);
+      DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, vl, rho, depth,
+                                            DYNTRACE_GLOBAL_CACHE_MISS);
 	    return vl;
 	}
 
@@ -1212,6 +1217,7 @@ static SEXP findGlobalVar(SEXP symbol)
 SEXP findVar(SEXP symbol, SEXP rho)
 {
     SEXP vl;
+    int depth = 0;
 
     if (TYPEOF(rho) == NILSXP)
 	error(_("use of NULL environment is defunct"));
@@ -1226,23 +1232,27 @@ SEXP findVar(SEXP symbol, SEXP rho)
     while (rho != R_GlobalEnv && rho != R_EmptyEnv) {
 	vl = findVarInFrame3(rho, symbol, TRUE /* get rather than exists */);
 	if (vl != R_UnboundValue) {
-    DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, vl, rho);
+    DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, vl, rho, depth,
+                                          DYNTRACE_GLOBAL_CACHE_UNUSED);
     return (vl);
   }
 	rho = ENCLOS(rho);
+	depth++;
     }
     if (rho == R_GlobalEnv)
-	return findGlobalVar(symbol);
+	return findGlobalVar(symbol, depth);
     else
 	return R_UnboundValue;
 #else
     while (rho != R_EmptyEnv) {
 	vl = findVarInFrame3(rho, symbol, TRUE);
 	if (vl != R_UnboundValue) {
-    DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, vl, rho);
+    DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(symbol, vl, rho, depth,
+                                          DYNTRACE_GLOBAL_CACHE_UNUSED);
     return (vl);
   }
 	rho = ENCLOS(rho);
+	depth++;
     }
     return R_UnboundValue;
 #endif
@@ -1466,6 +1476,7 @@ attribute_hidden
 SEXP findFun3(SEXP symbol, SEXP rho, SEXP call)
 {
     SEXP vl;
+    int depth = 0;
 
     /* If the symbol is marked as special, skip to the first
        environment that might contain such a symbol. */
@@ -1479,17 +1490,31 @@ SEXP findFun3(SEXP symbol, SEXP rho, SEXP call)
 #ifdef USE_GLOBAL_CACHE
 	if (rho == R_GlobalEnv)
 #ifdef FAST_BASE_CACHE_LOOKUP
-	    if (BASE_SYM_CACHED(symbol))
+	    if (BASE_SYM_CACHED(symbol)) {
 		vl = SYMBOL_BINDING_VALUE(symbol);
+		if (vl != R_UnboundValue) {
+		    DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(
+			symbol, vl, R_BaseEnv, depth, DYNTRACE_GLOBAL_CACHE_HIT);
+		}
+	    }
 	    else
-		vl = findGlobalVar(symbol);
+		vl = findGlobalVar(symbol, depth);
 #else
-	    vl = findGlobalVar(symbol);
+	    vl = findGlobalVar(symbol, depth);
 #endif
-	else
+	else {
 	    vl = findVarInFrame3(rho, symbol, TRUE);
+	    if (vl != R_UnboundValue) {
+		DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(
+		    symbol, vl, rho, depth, DYNTRACE_GLOBAL_CACHE_UNUSED);
+	    }
+	}
 #else
 	vl = findVarInFrame3(rho, symbol, TRUE);
+	if (vl != R_UnboundValue) {
+	    DYNTRACE_PROBE_ENVIRONMENT_LOOKUP_VAR(
+		symbol, vl, rho, depth, DYNTRACE_GLOBAL_CACHE_UNUSED);
+	}
 #endif
 	if (vl != R_UnboundValue) {
 	    if (TYPEOF(vl) == PROMSXP) {
@@ -1506,6 +1531,7 @@ SEXP findFun3(SEXP symbol, SEXP rho, SEXP call)
 		      CHAR(PRINTNAME(symbol)));
 	}
 	rho = ENCLOS(rho);
+	depth++;
     }
     errorcall_cpy(call,
                   _("could not find function \"%s\""),
@@ -544,8 +544,6 @@ static SEXP forcePromise(SEXP e)
 /* some places, e.g. deparse2buff, call this with a promise and rho = NULL */
 SEXP eval(SEXP e, SEXP rho)
 {
-  DYNTRACE_PROBE_EVAL_ENTRY(e, rho);
-
     SEXP op, tmp;
     static int evalcount = 0;
 
@@ -588,12 +586,14 @@ SEXP eval(SEXP e, SEXP rho)
 	   expressions.  */
 	if (NAMED(e) <= 1) SET_NAMED(e, 2);
 
-	DYNTRACE_PROBE_EVAL_EXIT(e, rho, e);
+	DYNTRACE_PROBE_EVAL_CONSTANT(e, rho);
 
 	return e;
     default: break;
     }
 
+    DYNTRACE_PROBE_EVAL_ENTRY(e, rho);
+
     int bcintactivesave = R_BCIntActive;
     R_BCIntActive = 0;
 
@@ -1336,8 +1336,8 @@ SEXP attribute_hidden R_cmpfun1(SEXP fun)
     return val;
 }
 
-/* fun is modified in-place when compiled */
-static void R_cmpfun(SEXP fun)
+/* fun is modified in-place when compiled, returns one of DYNTRACE_JIT_* */
+static int R_cmpfun(SEXP fun)
 {
     R_exprhash_t hash = 0;
     if (jit_strategy != STRATEGY_NO_CACHE) {
@@ -1360,7 +1360,7 @@ static void R_cmpfun(SEXP fun)
 			PRINT_JIT_INFO;
 			SET_BODY(fun, jit_cache_code(entry));
 			/**** reset the cache here?*/
-			return;
+			return DYNTRACE_JIT_CACHED;
 		    }
 		}
 		/* The functions probably differ only in source references
@@ -1379,7 +1379,7 @@ static void R_cmpfun(SEXP fun)
 		SET_NOJIT(fun);
 		/**** also mark the cache entry as NOJIT, or as need to see
 		      many times? */
-		return;
+		return DYNTRACE_JIT_NOT_COMPILED;
 	    }
 	}
 	PRINT_JIT_INFO;
@@ -1387,13 +1387,14 @@ static void R_cmpfun(SEXP fun)
 
     SEXP val = R_cmpfun1(fun);
 
-    if (TYPEOF(BODY(val)) != BCODESXP)
+    if (TYPEOF(BODY(val)) != BCODESXP) {
 	SET_NOJIT(fun);
-    else {
-	if (jit_strategy != STRATEGY_NO_CACHE)
-	    set_jit_cache_entry(hash, val); /* val is protected by callee */
-	SET_BODY(fun, BODY(val));
+	return DYNTRACE_JIT_NOT_COMPILED;
     }
+    if (jit_strategy != STRATEGY_NO_CACHE)
+	set_jit_cache_entry(hash, val); /* val is protected by callee */
+    SET_BODY(fun, BODY(val));
+    return DYNTRACE_JIT_COMPILED;
 }
 
 static SEXP R_compileExpr(SEXP expr, SEXP rho)
@@ -1595,7 +1596,19 @@ static R_INLINE SEXP R_execClosure(SEXP call, SEXP newrho, SEXP sysparent,
     if (R_CheckJIT(op)) {
 	int old_enabled = R_jit_enabled;
 	R_jit_enabled = 0;
+#ifdef ENABLE_DYNTRACE
+	clock_t dyntrace_expression_time = dyntrace_jit_compile_begin();
+	uint64_t dyntrace_start =
+	    DYNTRACE_PROBE_IS_ATTACHED(probe_jit_compile_exit) ?
+	    dyntrace_timestamp() : 0;
+	DYNTRACE_PROBE_JIT_COMPILE_ENTRY(call, op);
+	int dyntrace_outcome = R_cmpfun(op);
+	DYNTRACE_PROBE_JIT_COMPILE_EXIT(call, op, dyntrace_outcome,
+					dyntrace_start);
+	dyntrace_jit_compile_end(dyntrace_expression_time);
+#else
 	R_cmpfun(op);
+#endif
 	body = BODY(op);
 	R_jit_enabled = old_enabled;
     }
@@ -3534,7 +3547,10 @@ static SEXP R_DotCSym = NULL;
    instead of a weak reference, stays in the list forever, and is a GC root.*/
 static SEXP R_ConstantsRegistry = NULL;
 
-#if defined(__GNUC__) && ! defined(BC_PROFILING) && (! defined(NO_THREADED_CODE))
+/* counting opcodes for dyntrace needs the opcode at every dispatch, which
+   threaded code does not keep */
+#if defined(__GNUC__) && ! defined(BC_PROFILING) && \
+    ! defined(ENABLE_DYNTRACE_OPCODES) && (! defined(NO_THREADED_CODE))
 # define THREADED_CODE
 #endif
 
@@ -4631,6 +4647,9 @@ typedef int BCODE;
 
 #ifdef BC_PROFILING
 #define BEGIN_MACHINE  loop: currentpc = pc; current_opcode = *pc; switch(*pc++)
+#elif defined(ENABLE_DYNTRACE_OPCODES)
+#define BEGIN_MACHINE  loop: currentpc = pc; DYNTRACE_COUNT_OPCODE(*pc); \
+    switch(*pc++)
 #else
 #define BEGIN_MACHINE  loop: currentpc = pc; switch(*pc++)
 #endif
@@ -5121,6 +5140,112 @@ static int current_opcode = NO_CURRENT_OPCODE;
 static int opcode_counts[OPCOUNT];
 #endif
 
+#ifdef ENABLE_DYNTRACE_OPCODES
+/* Opcodes executed while dyntrace runs. Opcodes are counted per closure in
+   which bcEval runs (the innermost function context, top level is slot 0),
+   opcode pairs for the whole trace. Both are flat arrays:
+   dyntrace_opcode_counts[slot * OPCOUNT + op] and
+   dyntrace_opcode_pairs[previous * OPCOUNT + op]. The closures are kept
+   alive in dyntrace_opcode_closures until the next trace, so that their
+   addresses stay unique. */
+static Rboolean dyntrace_opcode_counting = FALSE;
+static uint64_t *dyntrace_opcode_counts = NULL;
+static uint64_t dyntrace_opcode_pairs[OPCOUNT * OPCOUNT];
+static SEXP dyntrace_opcode_closures = NULL;
+static int dyntrace_opcode_slots = 0;
+/* open addressing table from closures to slots, -1 for free entries */
+static int *dyntrace_opcode_table = NULL;
+static int dyntrace_opcode_table_size = 0;
+
+#define DYNTRACE_OPCODE_HASH(closure, size) \
+    ((int) (((uintptr_t) (closure) >> 4) & ((size) - 1)))
+
+static void dyntrace_opcode_grow(void)
+{
+    int i, size = dyntrace_opcode_table_size * 2;
+    int *table = (int *) malloc(size * sizeof(int));
+    uint64_t *counts = (uint64_t *) realloc(dyntrace_opcode_counts,
+					    size * OPCOUNT * sizeof(uint64_t));
+    if (table == NULL || counts == NULL)
+	error(_("cannot allocate opcode counts"));
+    dyntrace_opcode_counts = counts;
+    memset(counts + dyntrace_opcode_slots * OPCOUNT, 0,
+	   (size - dyntrace_opcode_slots) * OPCOUNT * sizeof(uint64_t));
+
+    SEXP closures = allocVector(VECSXP, size);
+    for (i = 0; i < dyntrace_opcode_slots; i++)
+	SET_VECTOR_ELT(closures, i,
+		       VECTOR_ELT(dyntrace_opcode_closures, i));
+    R_PreserveObject(closures);
+    R_ReleaseObject(dyntrace_opcode_closures);
+    dyntrace_opcode_closures = closures;
+
+    for (i = 0; i < size; i++)
+	table[i] = -1;
+    for (i = 1; i < dyntrace_opcode_slots; i++) {
+	int j = DYNTRACE_OPCODE_HASH(VECTOR_ELT(closures, i), size);
+	while (table[j] != -1)
+	    j = (j + 1) & (size - 1);
+	table[j] = i;
+    }
+    free(dyntrace_opcode_table);
+    dyntrace_opcode_table = table;
+    dyntrace_opcode_table_size = size;
+}
+
+/* slot of the closure bcEval runs for, -1 if opcodes are not counted */
+static int dyntrace_opcode_slot(void)
+{
+    RCNTXT *cptr;
+    SEXP closure = R_NilValue;
+    int i;
+
+    if (! dyntrace_opcode_counting)
+	return -1;
+
+    for (cptr = R_GlobalContext;
+	 cptr != NULL && cptr->callflag != CTXT_TOPLEVEL;
+	 cptr = cptr->nextcontext)
+	if ((cptr->callflag & CTXT_FUNCTION) &&
+	    TYPEOF(cptr->callfun) == CLOSXP) {
+	    closure = cptr->callfun;
+	    break;
+	}
+    if (closure == R_NilValue)
+	return 0;
+
+    i = DYNTRACE_OPCODE_HASH(closure, dyntrace_opcode_table_size);
+    while (dyntrace_opcode_table[i] != -1) {
+	int slot = dyntrace_opcode_table[i];
+	if (VECTOR_ELT(dyntrace_opcode_closures, slot) == closure)
+	    return slot;
+	i = (i + 1) & (dyntrace_opcode_table_size - 1);
+    }
+
+    /* keep the table at most half full */
+    if (2 * dyntrace_opcode_slots >= dyntrace_opcode_table_size) {
+	PROTECT(closure);
+	dyntrace_opcode_grow();
+	UNPROTECT(1);
+	i = DYNTRACE_OPCODE_HASH(closure, dyntrace_opcode_table_size);
+	while (dyntrace_opcode_table[i] != -1)
+	    i = (i + 1) & (dyntrace_opcode_table_size - 1);
+    }
+    dyntrace_opcode_table[i] = dyntrace_opcode_slots;
+    SET_VECTOR_ELT(dyntrace_opcode_closures, dyntrace_opcode_slots, closure);
+    return dyntrace_opcode_slots++;
+}
+
+#define DYNTRACE_COUNT_OPCODE(op) do {					\
+    if (dyntrace_slot >= 0 && dyntrace_opcode_counting) {		\
+	dyntrace_opcode_counts[dyntrace_slot * OPCOUNT + (op)]++;	\
+	if (dyntrace_previous_opcode >= 0)				\
+	    dyntrace_opcode_pairs[dyntrace_previous_opcode * OPCOUNT + (op)]++; \
+	dyntrace_previous_opcode = (op);				\
+    }									\
+} while (0)
+#endif
+
 #define BC_COUNT_DELTA 1000
 
 #ifndef IMMEDIATE_FINALIZERS
@@ -5962,6 +6087,11 @@ static SEXP bcEval(SEXP body, SEXP rho, Rboolean useCache)
 #ifdef THREADED_CODE
   int which = 0;
 #endif
+#ifdef ENABLE_DYNTRACE_OPCODES
+  int dyntrace_slot = -1;
+  /* volatile, the loop contexts below longjmp back into this frame */
+  volatile int dyntrace_previous_opcode = -1;
+#endif
 
   BC_CHECK_SIGINT();
 
@@ -5994,6 +6124,10 @@ static SEXP bcEval(SEXP body, SEXP rho, Rboolean useCache)
       }
   }
 
+#ifdef ENABLE_DYNTRACE_OPCODES
+  dyntrace_slot = dyntrace_opcode_slot();
+#endif
+
   R_Srcref = R_InBCInterpreter;
   R_BCIntActive = 1;
   R_BCbody = body;
@@ -7673,6 +7807,121 @@ SEXP NORET do_bcprofstop(SEXP call, SEXP op, SEXP args, SEXP env) {
 }
 #endif
 
+#ifdef ENABLE_DYNTRACE_OPCODES
+/* called by do_dyntrace around the traced expression */
+/* Counts of an outer trace, put aside while a nested dyntrace runs. */
+struct dyntrace_opcodes_t {
+    uint64_t *counts;
+    uint64_t *pairs;
+    SEXP closures;
+    int slots;
+    int *table;
+    int table_size;
+};
+
+/* Returns the counts of the outer trace when nested, NULL otherwise. Must
+   run before the dyntracer is activated, it allocates. */
+struct dyntrace_opcodes_t attribute_hidden *dyntrace_opcodes_begin(void)
+{
+    struct dyntrace_opcodes_t *outer = NULL;
+
+    if (dyntrace_opcode_counting) {
+	outer = (struct dyntrace_opcodes_t *) malloc(sizeof(*outer));
+	if (outer == NULL ||
+	    (outer->pairs = (uint64_t *) malloc(sizeof(dyntrace_opcode_pairs)))
+	    == NULL) {
+	    free(outer);
+	    error(_("cannot allocate opcode counts"));
+	}
+	outer->counts = dyntrace_opcode_counts;
+	memcpy(outer->pairs, dyntrace_opcode_pairs,
+	       sizeof(dyntrace_opcode_pairs));
+	outer->closures = dyntrace_opcode_closures;
+	outer->slots = dyntrace_opcode_slots;
+	outer->table = dyntrace_opcode_table;
+	outer->table_size = dyntrace_opcode_table_size;
+	/* the closures of the outer trace stay preserved */
+	dyntrace_opcode_counts = NULL;
+	dyntrace_opcode_table = NULL;
+	dyntrace_opcode_closures = NULL;
+    }
+    if (dyntrace_opcode_closures == NULL) {
+	dyntrace_opcode_closures = allocVector(VECSXP, 0);
+	R_PreserveObject(dyntrace_opcode_closures);
+    }
+    /* drops the closures and counts of the previous trace */
+    dyntrace_opcode_slots = 0;
+    dyntrace_opcode_table_size = 8;
+    dyntrace_opcode_grow();
+    memset(dyntrace_opcode_pairs, 0, sizeof(dyntrace_opcode_pairs));
+    /* slot 0 is top level */
+    dyntrace_opcode_slots = 1;
+    dyntrace_opcode_counting = TRUE;
+    return outer;
+}
+
+/* Stops counting, or drops the counts of a nested trace and carries on with
+   those of the outer trace, so that the slots of its bcEval frames stay
+   valid. */
+void attribute_hidden dyntrace_opcodes_end(struct dyntrace_opcodes_t *outer)
+{
+    dyntrace_opcode_counting = FALSE;
+    if (outer == NULL)
+	return;
+
+    free(dyntrace_opcode_counts);
+    free(dyntrace_opcode_table);
+    R_ReleaseObject(dyntrace_opcode_closures);
+    dyntrace_opcode_counts = outer->counts;
+    memcpy(dyntrace_opcode_pairs, outer->pairs,
+	   sizeof(dyntrace_opcode_pairs));
+    dyntrace_opcode_closures = outer->closures;
+    dyntrace_opcode_slots = outer->slots;
+    dyntrace_opcode_table = outer->table;
+    dyntrace_opcode_table_size = outer->table_size;
+    free(outer->pairs);
+    free(outer);
+    dyntrace_opcode_counting = TRUE;
+}
+
+/* Counts of the last dyntrace call: list(closures, opcodes, pairs), opcodes
+   is a closures x opcodes matrix, pairs an opcodes x opcodes matrix indexed
+   by the previous opcode first. Element 1 of closures, top level, is NULL. */
+SEXP attribute_hidden do_dyntraceopcodes(SEXP call, SEXP op, SEXP args,
+					 SEXP env)
+{
+    SEXP val, closures, counts, pairs;
+    int i, j, n = dyntrace_opcode_slots;
+
+    checkArity(op, args);
+    PROTECT(closures = allocVector(VECSXP, n));
+    PROTECT(counts = allocMatrix(REALSXP, n, OPCOUNT));
+    PROTECT(pairs = allocMatrix(REALSXP, OPCOUNT, OPCOUNT));
+    for (i = 0; i < n; i++) {
+	SET_VECTOR_ELT(closures, i, VECTOR_ELT(dyntrace_opcode_closures, i));
+	for (j = 0; j < OPCOUNT; j++)
+	    REAL(counts)[i + j * n] =
+		(double) dyntrace_opcode_counts[i * OPCOUNT + j];
+    }
+    for (i = 0; i < OPCOUNT; i++)
+	for (j = 0; j < OPCOUNT; j++)
+	    REAL(pairs)[i + j * OPCOUNT] =
+		(double) dyntrace_opcode_pairs[i * OPCOUNT + j];
+
+    val = allocVector(VECSXP, 3);
+    SET_VECTOR_ELT(val, 0, closures);
+    SET_VECTOR_ELT(val, 1, counts);
+    SET_VECTOR_ELT(val, 2, pairs);
+    UNPROTECT(3);
+    return val;
+}
+#else
+SEXP NORET do_dyntraceopcodes(SEXP call, SEXP op, SEXP args, SEXP env) {
+    checkArity(op, args);
+    error(_("dyntrace opcode counts are not supported in this build"));
+}
+#endif
+
 /* end of byte code section */
 
 SEXP attribute_hidden do_setnumthreads(SEXP call, SEXP op, SEXP args, SEXP rho)
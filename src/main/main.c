@@ -862,6 +862,7 @@ void setup_Rmainloop(void)
 
     R_Toplevel.nextcontext = NULL;
     R_Toplevel.callflag = CTXT_TOPLEVEL;
+    R_Toplevel.depth = 0;
     R_Toplevel.cstacktop = 0;
     R_Toplevel.gcenabled = R_GCEnabled;
     R_Toplevel.promargs = R_NilValue;
@@ -43,6 +43,7 @@
 #endif
 
 #include "Defn.h"
+#include <Rdyntrace.h>
 
 
 /* used in subscript.c and subassign.c */
@@ -189,6 +190,12 @@ SEXP attribute_hidden matchArgs(SEXP formals, SEXP supplied, SEXP call)
     Rboolean seendots;
     int i, arg_i = 0;
     SEXP f, a, b, dots, actuals;
+#ifdef ENABLE_DYNTRACE
+    int dyntrace_supplied = 0, dyntrace_partial = 0;
+    uint64_t dyntrace_start =
+	DYNTRACE_PROBE_IS_ATTACHED(probe_match_args) ?
+	dyntrace_timestamp() : 0;
+#endif
 
     actuals = R_NilValue;
     for (f = formals ; f != R_NilValue ; f = CDR(f), arg_i++) {
@@ -209,7 +216,12 @@ SEXP attribute_hidden matchArgs(SEXP formals, SEXP supplied, SEXP call)
     int fargused[arg_i ? arg_i : 1]; // avoid undefined behaviour
     memset(fargused, 0, sizeof(fargused));
 
-    for(b = supplied; b != R_NilValue; b = CDR(b)) SET_ARGUSED(b, 0);
+    for(b = supplied; b != R_NilValue; b = CDR(b)) {
+	SET_ARGUSED(b, 0);
+#ifdef ENABLE_DYNTRACE
+	dyntrace_supplied++;
+#endif
+    }
 
     PROTECT(actuals);
 
@@ -286,6 +298,9 @@ SEXP attribute_hidden matchArgs(SEXP formals, SEXP supplied, SEXP call)
 			if (CAR(b) != R_MissingArg) SET_MISSING(a, 0);
 			SET_ARGUSED(b, 1);
 			fargused[arg_i] = 1;
+#ifdef ENABLE_DYNTRACE
+			dyntrace_partial++;
+#endif
 		    }
 		}
 	    }
@@ -394,6 +409,9 @@ SEXP attribute_hidden matchArgs(SEXP formals, SEXP supplied, SEXP call)
 		      strchr(CHAR(asChar(deparse1line(unusedForError, 0))), '('));
 	}
     }
+    DYNTRACE_PROBE_MATCH_ARGS(call, formals, arg_i, dyntrace_supplied,
+			      dyntrace_partial, dots != R_NilValue,
+			      dyntrace_start);
     UNPROTECT(1);
     return(actuals);
 }
@@ -112,6 +112,11 @@ extern void *Rm_realloc(void * p, size_t n);
 static int gc_reporting = 0;
 static int gc_count = 0;
 
+#ifdef ENABLE_DYNTRACE
+/* details of the running collection, for DYNTRACE_PROBE_GC_EXIT */
+static dyntrace_gc_info_t dyntrace_gc_info;
+#endif
+
 /* These are used in profiling to separate out time in GC */
 int R_gc_running() { return R_in_gc; }
 
@@ -230,11 +235,15 @@ static int gc_pending = 0;
 static int gc_force_wait = 0;
 static int gc_force_gap = 0;
 static Rboolean gc_inhibit_release = FALSE;
-#define FORCE_GC (gc_pending || (gc_force_wait > 0 ? (--gc_force_wait > 0 ? 0 : (gc_force_wait = gc_force_gap, 1)) : 0))
+#define FORCE_GC (DYNTRACE_REPLAY_FORCE_GC() || gc_pending || (gc_force_wait > 0 ? (--gc_force_wait > 0 ? 0 : (gc_force_wait = gc_force_gap, 1)) : 0))
 #else
-# define FORCE_GC gc_pending
+# define FORCE_GC (DYNTRACE_REPLAY_FORCE_GC() || gc_pending)
 #endif
 
+/* set while R_gc() collects: the replay record of dyntrace() leaves out
+   collections asked for by gc(), the replayed code asks for them again */
+static int gc_requested = 0;
+
 #ifdef R_MEMORY_PROFILING
 static void R_ReportAllocation(R_size_t);
 static void R_ReportNewPage();
@@ -1041,6 +1050,11 @@ static void ReleaseLargeFreeVectors()
 #endif
 		UNSNAP_NODE(s);
 		R_GenHeap[node_class].AllocCount--;
+#ifdef ENABLE_DYNTRACE
+		dyntrace_gc_info.reclaimed_nodes[node_class]++;
+		dyntrace_gc_info.reclaimed_bytes[node_class] +=
+		    sizeof(SEXPREC_ALIGN) + size * sizeof(VECREC);
+#endif
 		if (node_class == LARGE_NODE_CLASS) {
 		    R_LargeVallocSize -= size;
 #ifdef LONG_VECTOR_SUPPORT
@@ -1819,6 +1833,23 @@ static void RunGenCollect(R_size_t size_needed)
     }
 #endif
 
+#ifdef ENABLE_DYNTRACE
+    /* the nodes left between New and Free are the ones just reclaimed */
+    if (DYNTRACE_PROBE_IS_ATTACHED(probe_gc_exit)) {
+	for (i = 0; i < NUM_SMALL_NODE_CLASSES; i++) {
+	    R_size_t reclaimed = 0;
+	    for (s = NEXT_NODE(R_GenHeap[i].New);
+		 s != R_GenHeap[i].Free;
+		 s = NEXT_NODE(s))
+		reclaimed++;
+	    dyntrace_gc_info.reclaimed_nodes[i] += reclaimed;
+	    dyntrace_gc_info.reclaimed_bytes[i] += reclaimed *
+		(i == 0 ? sizeof(SEXPREC) :
+		 sizeof(SEXPREC_ALIGN) + NodeClassSize[i] * sizeof(VECREC));
+	}
+    }
+#endif
+
     /* reset Free pointers */
     for (i = 0; i < NUM_NODE_CLASSES; i++)
 	R_GenHeap[i].Free = NEXT_NODE(R_GenHeap[i].New);
@@ -1847,6 +1878,9 @@ static void RunGenCollect(R_size_t size_needed)
     else num_old_gens_to_collect = 0;
 
     gen_gc_counts[gens_collected]++;
+#ifdef ENABLE_DYNTRACE
+    dyntrace_gc_info.generation = gens_collected;
+#endif
 
     if (gens_collected == NUM_OLD_GENERATIONS) {
 	/**** do some adjustment for intermediate collections? */
@@ -2539,7 +2573,7 @@ SEXP allocVector3(SEXPTYPE type, R_xlen_t length, R_allocator_t *allocator)
 	    SET_SHORT_VEC_TRUELENGTH(s, 0);
 	    SET_NAMED(s, 0);
 	    INIT_REFCNT(s);
-      DYNTRACE_PROBE_VECTOR_ALLOC(type, length, NODE_SIZE(type), "");
+	    DYNTRACE_PROBE_VECTOR_ALLOC(type, length, NODE_SIZE(type), R_Srcref);
 	    return(s);
 	}
     }
@@ -2680,6 +2714,10 @@ SEXP allocVector3(SEXPTYPE type, R_xlen_t length, R_allocator_t *allocator)
 	    SET_NODE_CLASS(s, node_class);
 	    R_SmallVallocSize += alloc_size;
 	    SET_SHORT_VEC_LENGTH(s, (R_len_t) length);
+	    DYNTRACE_PROBE_SMALL_VECTOR_ALLOC(type, length,
+					      sizeof(SEXPREC_ALIGN) +
+					      alloc_size * sizeof(VECREC),
+					      R_Srcref);
 	}
 	else {
 	    Rboolean success = FALSE;
@@ -2724,8 +2762,9 @@ SEXP allocVector3(SEXPTYPE type, R_xlen_t length, R_allocator_t *allocator)
 #ifdef R_MEMORY_PROFILING
 		R_ReportAllocation(hdrsize + size * sizeof(VECREC));
 #endif
-        // TODO: can I get the source location?
-    DYNTRACE_PROBE_VECTOR_ALLOC(type, length, (hdrsize + size * sizeof(VECREC)), "");
+		DYNTRACE_PROBE_VECTOR_ALLOC(type, length,
+					    hdrsize + size * sizeof(VECREC),
+					    R_Srcref);
 	    } else s = NULL; /* suppress warning */
 	    if (! success) {
 		double dsize = (double)size * sizeof(VECREC)/1024.0;
@@ -2883,7 +2922,9 @@ SEXP allocFormalsList6(SEXP sym1, SEXP sym2, SEXP sym3, SEXP sym4,
 
 void R_gc(void)
 {
+    gc_requested = TRUE;
     R_gc_internal(0);
+    gc_requested = FALSE;
 }
 
 static void R_gc_full(R_size_t size_needed)
@@ -2956,10 +2997,22 @@ static void R_gc_internal(R_size_t size_needed)
       return;
     }
 
+#ifdef ENABLE_DYNTRACE
+    if (dyntrace_replay_mode != DYNTRACE_REPLAY_OFF && !gc_requested)
+	dyntrace_replay_collect();
+#endif
     DYNTRACE_PROBE_GC_ENTRY(size_needed);
 
     gc_pending = FALSE;
 
+#ifdef ENABLE_DYNTRACE
+    R_size_t dyntrace_pages = 0;
+    memset(&dyntrace_gc_info, 0, sizeof(dyntrace_gc_info));
+    dyntrace_gc_info.size_needed = size_needed;
+    for (int i = 0; i < NUM_NODE_CLASSES; i++)
+	dyntrace_pages += R_GenHeap[i].PageCount;
+#endif
+
     R_size_t onsize = R_NSize /* can change during collection */;
     double ncells, vcells, vfrac, nfrac;
     SEXPTYPE first_bad_sexp_type = 0;
@@ -2982,7 +3035,13 @@ static void R_gc_internal(R_size_t size_needed)
     BEGIN_SUSPEND_INTERRUPTS {
 	R_in_gc = TRUE;
 	gc_start_timing();
+#ifdef ENABLE_DYNTRACE
+	double dyntrace_start = currentTime();
 	RunGenCollect(size_needed);
+	dyntrace_gc_info.wall_time += currentTime() - dyntrace_start;
+#else
+	RunGenCollect(size_needed);
+#endif
 	gc_end_timing();
 	R_in_gc = FALSE;
     } END_SUSPEND_INTERRUPTS;
@@ -3075,7 +3134,18 @@ static void R_gc_internal(R_size_t size_needed)
     }
     /* compiler constants are checked in RunGenCollect */
 
-    DYNTRACE_PROBE_GC_EXIT(gc_count, vcells, ncells);
+#ifdef ENABLE_DYNTRACE
+    dyntrace_gc_info.gc_count = gc_count;
+    for (int i = 0; i < NUM_NODE_CLASSES; i++) {
+	/* finalizers run between two passes may have added pages */
+	if (dyntrace_pages < R_GenHeap[i].PageCount)
+	    dyntrace_pages = 0;
+	else
+	    dyntrace_pages -= R_GenHeap[i].PageCount;
+    }
+    dyntrace_gc_info.pages_released = dyntrace_pages;
+#endif
+    DYNTRACE_PROBE_GC_EXIT(gc_count, vcells, ncells, &dyntrace_gc_info);
 }
 
 
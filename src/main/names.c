@@ -124,7 +124,7 @@ FUNTAB R_FunTab[] =
 {"nargs",	do_nargs,	1,	1,	0,	{PP_FUNCALL, PREC_FN,	0}},
 {"on.exit",	do_onexit,	0,	100,	-1,	{PP_FUNCALL, PREC_FN,	  0}},
 {"forceAndCall",do_forceAndCall,	0,	0,	-1,	{PP_FUNCALL, PREC_FN,	  0}},
-{"dyntrace", do_dyntrace, 0, 0,	3, {PP_FUNCALL, PREC_FN, 0}},
+{"dyntrace", do_dyntrace, 0, 0,	6, {PP_FUNCALL, PREC_FN, 0}},
 
 /* .Internals */
 
@@ -968,6 +968,11 @@ FUNTAB R_FunTab[] =
 {"bcprofcounts",do_bcprofcounts,0,	11,	0,	{PP_FUNCALL, PREC_FN,	0}},
 {"bcprofstart",	do_bcprofstart,	0,	11,	0,	{PP_FUNCALL, PREC_FN,	0}},
 {"bcprofstop",	do_bcprofstop,	0,	11,	0,	{PP_FUNCALL, PREC_FN,	0}},
+{"dyntraceopcodes",do_dyntraceopcodes,0,	11,	0,	{PP_FUNCALL, PREC_FN,	0}},
+{"dyntracestatistics",do_dyntracestatistics,0,	11,	0,	{PP_FUNCALL, PREC_FN,	0}},
+{"dyntracerecord",do_dyntracerecord,0,	11,	0,	{PP_FUNCALL, PREC_FN,	0}},
+{"dyntraceload",do_dyntraceload,0,	11,	2,	{PP_FUNCALL, PREC_FN,	0}},
+{"dyntracedestroy",do_dyntracedestroy,0,	111,	1,	{PP_FUNCALL, PREC_FN,	0}},
 
 {"eSoftVersion",do_eSoftVersion, 0,	11,	0,	{PP_FUNCALL, PREC_FN,	0}},
 {"curlVersion", do_curlVersion, 0,	11,	0,	{PP_FUNCALL, PREC_FN,	0}},
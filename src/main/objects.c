@@ -359,6 +359,12 @@ int usemethod(const char *generic, SEXP obj, SEXP call, SEXP args,
     int i, nclass;
     RCNTXT *cptr;
 
+#ifdef ENABLE_DYNTRACE
+    uint64_t dyntrace_start =
+	DYNTRACE_PROBE_IS_ATTACHED(probe_S3_method_lookup) ?
+	dyntrace_timestamp() : 0;
+#endif
+
     /* Get the context which UseMethod was called from. */
 
     cptr = R_GlobalContext;
@@ -376,6 +382,8 @@ int usemethod(const char *generic, SEXP obj, SEXP call, SEXP args,
 	    if(method == R_SortListSymbol && CLOENV(sxp) == R_BaseNamespace)
 		continue; /* kludge because sort.list is not a method */
 	    PROTECT(sxp);
+	    DYNTRACE_PROBE_S3_METHOD_LOOKUP(generic, klass, method, i,
+					    dyntrace_start);
 	    if (i > 0) {
 		SEXP dotClass = PROTECT(stringSuffix(klass, i));
 		setAttrib(dotClass, R_PreviousSymbol, klass);
@@ -396,6 +404,8 @@ int usemethod(const char *generic, SEXP obj, SEXP call, SEXP args,
     method = installS3Signature(generic, "default");
     PROTECT(sxp = R_LookupMethod(method, rho, callrho, defrho));
     if (isFunction(sxp)) {
+	DYNTRACE_PROBE_S3_METHOD_LOOKUP(generic, klass, method, nclass,
+					dyntrace_start);
 	*ans = dispatchMethod(op, sxp, R_NilValue, cptr, method, generic,
 			      rho, callrho, defrho);
 	UNPROTECT(2); /* klass, sxp */
@@ -403,6 +413,8 @@ int usemethod(const char *generic, SEXP obj, SEXP call, SEXP args,
 	DYNTRACE_PROBE_S3_GENERIC_EXIT(generic, obj, *ans);
 	return 1;
     }
+    DYNTRACE_PROBE_S3_METHOD_LOOKUP(generic, klass, R_NilValue, -1,
+				    dyntrace_start);
     UNPROTECT(2); /* klass, sxp */
     cptr->callflag = CTXT_RETURN;
 
@@ -81,6 +81,7 @@
 
 #include <Defn.h>
 #include <Internal.h>
+#include <Rdyntrace.h>
 
 #include <time.h>
 
@@ -139,7 +140,7 @@ double currentTime(void)
 SEXP attribute_hidden do_systime(SEXP call, SEXP op, SEXP args, SEXP env)
 {
     checkArity(op, args);
-    return ScalarReal(currentTime());
+    return ScalarReal(DYNTRACE_REPLAY_TIME(currentTime()));
 }
 
 #ifdef HAVE_UNISTD_H
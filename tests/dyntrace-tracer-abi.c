@@ -0,0 +1,5 @@
+/* The test tracer built for the next ABI, which dyntraceLoad rejects, see
+   dyntrace-abi.R. */
+
+#define DYNTRACE_TEST_ABI_VERSION (DYNTRACE_ABI_VERSION + 1)
+#include "dyntrace-tracer.c"
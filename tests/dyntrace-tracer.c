@@ -0,0 +1,191 @@
+/* Minimal dyntracer for the tests of the probes, see dyntrace-*.R.
+
+   dyntraceLoad("dyntrace-tracer.so", list(output = path, probes = names))
+   attaches the probes whose names (without the probe_ prefix) are in names.
+   Each writes one line to output: the name of the probe, then its arguments
+   separated by tabs. The output is appended to and line buffered, so that
+   forked children add their lines to those of the parent. The probes do not
+   allocate on the R heap. */
+
+/* for the fields of RCNTXT */
+#define R_USE_SIGNALS 1
+#include <Rdyntrace.h>
+#include <unistd.h>
+
+/* dyntrace-tracer-abi.c builds the tracer for another ABI */
+#ifdef DYNTRACE_TEST_ABI_VERSION
+const dyntrace_plugin_abi_t dyntrace_plugin_abi = {
+    DYNTRACE_TEST_ABI_VERSION, sizeof(dyntracer_t), DYNTRACE_PROBE_COUNT};
+#else
+DYNTRACE_PLUGIN_ABI;
+#endif
+
+static FILE *output(dyntrace_context_t *context) {
+    return (FILE *) context->dyntracer_context;
+}
+
+static const char *call_name(SEXP call) {
+    const char *name = dyntrace_get_call_name(call);
+    return name == NULL ? "<anonymous>" : name;
+}
+
+static void trace_begin(dyntrace_context_t *context, const SEXP prom) {
+    fprintf(output(context), "begin\n");
+}
+
+static void trace_end(dyntrace_context_t *context) {
+    fprintf(output(context), "end\n");
+}
+
+static void trace_function_entry(dyntrace_context_t *context, const SEXP call,
+                                 const SEXP op, const SEXP rho) {
+    fprintf(output(context), "function_entry\t%s\n", call_name(call));
+}
+
+static void trace_function_exit(dyntrace_context_t *context, const SEXP call,
+                                const SEXP op, const SEXP rho,
+                                const SEXP retval) {
+    fprintf(output(context), "function_exit\t%s\n", call_name(call));
+}
+
+static void trace_duplicate(dyntrace_context_t *context, SEXP object,
+                            SEXP copy, int deep, R_size_t bytes, SEXP srcref) {
+    fprintf(output(context), "duplicate\t%s\t%ld\t%d\t%lu\n",
+            type2char(TYPEOF(object)),
+            isVector(object) ? (long) XLENGTH(object) : -1L, deep,
+            (unsigned long) bytes);
+}
+
+static void trace_S3_method_lookup(dyntrace_context_t *context,
+                                   const char *generic, const SEXP klass,
+                                   const SEXP method, int class_index,
+                                   uint64_t lookup_time) {
+    fprintf(output(context), "S3_method_lookup\t%s\t%s\t%d\t%d\t%lu\n",
+            generic, method == R_NilValue ? "<none>" : CHAR(PRINTNAME(method)),
+            class_index, LENGTH(klass), (unsigned long) lookup_time);
+}
+
+static void trace_jit_compile_entry(dyntrace_context_t *context,
+                                    const SEXP call, const SEXP op,
+                                    int body_size) {
+    fprintf(output(context), "jit_compile_entry\t%s\t%d\n", call_name(call),
+            body_size);
+}
+
+static void trace_jit_compile_exit(dyntrace_context_t *context,
+                                   const SEXP call, const SEXP op, int outcome,
+                                   uint64_t compile_time) {
+    fprintf(output(context), "jit_compile_exit\t%s\t%d\t%d\t%lu\n",
+            call_name(call), outcome, TYPEOF(BODY(op)) == BCODESXP,
+            (unsigned long) compile_time);
+}
+
+static void trace_match_args(dyntrace_context_t *context, const SEXP call,
+                             const SEXP formals, int formals_count,
+                             int supplied_count, int partial_count, int dots,
+                             uint64_t match_time) {
+    fprintf(output(context), "match_args\t%s\t%d\t%d\t%d\t%d\t%lu\n",
+            call_name(call), formals_count, supplied_count, partial_count,
+            dots, (unsigned long) match_time);
+}
+
+static void trace_context_entry(dyntrace_context_t *context,
+                                const RCNTXT *cptr) {
+    fprintf(output(context), "context_entry\t%d\t%d\n", cptr->callflag,
+            cptr->depth);
+}
+
+static void trace_context_exit(dyntrace_context_t *context,
+                               const RCNTXT *cptr) {
+    fprintf(output(context), "context_exit\t%d\t%d\n", cptr->callflag,
+            cptr->depth);
+}
+
+static void trace_context_unwind(dyntrace_context_t *context,
+                                 const RCNTXT *cptr, const RCNTXT *target,
+                                 const SEXP val, int contexts, int onexits,
+                                 uint64_t unwind_time) {
+    fprintf(output(context), "context_unwind\t%d\t%d\t%d\t%d\t%lu\n",
+            cptr->depth, target->depth, contexts, onexits,
+            (unsigned long) unwind_time);
+}
+
+static void trace_gc_entry(dyntrace_context_t *context, R_size_t size_needed) {
+    fprintf(output(context), "gc_entry\t%lu\n", (unsigned long) size_needed);
+}
+
+/* the fork probes write the process they run in first */
+static void trace_fork_parent(dyntrace_context_t *context, pid_t child_pid,
+                              int estranged) {
+    fprintf(output(context), "fork_parent\t%d\t%d\t%d\n", (int) getpid(),
+            (int) child_pid, estranged);
+}
+
+static void trace_fork_child(dyntrace_context_t *context, pid_t parent_pid) {
+    fprintf(output(context), "fork_child\t%d\t%d\n", (int) getpid(),
+            (int) parent_pid);
+}
+
+static void trace_fork_child_exit(dyntrace_context_t *context, int status) {
+    fprintf(output(context), "fork_child_exit\t%d\t%d\n", (int) getpid(),
+            status);
+}
+
+static int has_probe(SEXP probes, const char *name) {
+    int i;
+    for (i = 0; i < LENGTH(probes); ++i)
+        if (strcmp(CHAR(STRING_ELT(probes, i)), name) == 0)
+            return 1;
+    return 0;
+}
+
+#define ATTACH(probe)                                                       \
+    if (has_probe(probes, #probe))                                          \
+        dyntracer->probe_##probe = trace_##probe
+
+SEXP create_dyntracer(SEXP options) {
+    SEXP path = get_named_list_element(options, "output");
+    SEXP probes = get_named_list_element(options, "probes");
+    dyntracer_t *dyntracer;
+    FILE *file;
+
+    if (!isString(path) || LENGTH(path) != 1)
+        error("invalid '%s' option", "output");
+    if (!isString(probes))
+        error("invalid '%s' option", "probes");
+    file = fopen(R_ExpandFileName(CHAR(STRING_ELT(path, 0))), "a");
+    if (file == NULL)
+        error("cannot open '%s'", CHAR(STRING_ELT(path, 0)));
+    setvbuf(file, NULL, _IOLBF, 0);
+
+    /* calloc leaves the probes which are not attached NULL */
+    dyntracer = (dyntracer_t *) calloc(1, sizeof(dyntracer_t));
+    ATTACH(begin);
+    ATTACH(end);
+    ATTACH(function_entry);
+    ATTACH(function_exit);
+    ATTACH(duplicate);
+    ATTACH(S3_method_lookup);
+    ATTACH(jit_compile_entry);
+    ATTACH(jit_compile_exit);
+    ATTACH(match_args);
+    ATTACH(context_entry);
+    ATTACH(context_exit);
+    ATTACH(context_unwind);
+    ATTACH(gc_entry);
+    ATTACH(fork_parent);
+    ATTACH(fork_child);
+    ATTACH(fork_child_exit);
+    dyntracer->non_allocating = 1;
+    dyntracer->context = file;
+    return dyntracer_to_sexp(dyntracer, "dyntracer.test");
+}
+
+static void destroy_test_dyntracer(dyntracer_t *dyntracer) {
+    fclose((FILE *) dyntracer->context);
+    free(dyntracer);
+}
+
+SEXP destroy_dyntracer(SEXP dyntracer_sexp) {
+    return dyntracer_destroy_sexp(dyntracer_sexp, destroy_test_dyntracer);
+}